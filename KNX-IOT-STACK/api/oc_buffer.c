@@ -68,6 +68,7 @@ allocate_message(struct oc_memb *pool)
     message->endpoint.interface_index = -1;
     message->endpoint.device = 0;
     message->endpoint.group_address = 0;
+    message->endpoint.priority = OC_MESSAGE_PRIORITY_NORMAL;
     message->soft_ref_cb = NULL;
 
 #ifdef OC_OSCORE
@@ -556,7 +556,7 @@ oc_stop_observe(const char *uri, oc_endpoint_t *endpoint)
   if (!cb)
     return false;
 
-  cb->mid = coap_get_mid();
+  oc_ri_set_client_cb_mid(cb, coap_get_mid());
   cb->observe_seq = 1;
 
   bool status = false;
@@ -638,8 +638,8 @@ dispatch_ip_discovery_ex(oc_client_cb_t *cb4, const char *uri,
   if (cb) {
     cb->discovery = true;
     if (cb4) {
-      cb->mid = cb4->mid;
-      memcpy(cb->token, cb4->token, cb4->token_len);
+      oc_ri_set_client_cb_mid(cb, cb4->mid);
+      oc_ri_set_client_cb_token(cb, cb4->token, cb4->token_len);
     }
 
     if (prepare_coap_request_ex(cb, accept) &&
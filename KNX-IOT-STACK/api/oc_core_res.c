@@ -118,6 +118,7 @@ oc_core_shutdown(void)
   }
 #endif /* OC_DYNAMIC_ALLOCATION */
   device_count = 0;
+  oc_ri_invalidate_uri_index();
 }
 
 void
@@ -489,6 +490,9 @@ oc_core_set_device_iid(size_t device_index, uint64_t iid)
     OC_ERR("  device_index %d too large\n", (int)device_index);
     return -1;
   }
+  if (oc_device_info[device_index].iid != iid) {
+    oc_clear_multicast_group_address_cache();
+  }
   oc_device_info[device_index].iid = iid;
 
   printf("iid set: ");
@@ -618,6 +622,7 @@ oc_core_add_device(const char *name, const char *version, const char *base,
   oc_init_oscore_from_storage(device_count, true);
 
   device_count++;
+  oc_ri_invalidate_uri_index();
 
   return &oc_device_info[device_count - 1];
 }
@@ -686,6 +691,7 @@ oc_core_populate_resource(int core_resource, size_t device_index,
   r->put_handler.cb = put;
   r->post_handler.cb = post;
   r->delete_handler.cb = delete;
+  oc_ri_invalidate_uri_index();
 }
 
 void
@@ -748,28 +754,10 @@ oc_core_get_resource_by_index(int type, size_t device)
 const oc_resource_t *
 oc_core_get_resource_by_uri(const char *uri, size_t device)
 {
-  int skip = 0, type = 0;
-  if (uri[0] == '/')
-    skip = 1;
-
-  // TODO: need to add all other KNX resources, not sure though if this function
-  // is being used anywhere
-  if ((strlen(uri) - skip) == 7 &&
-      memcmp(uri + skip, ".well-known/core", 17) == 0) {
-    type = WELLKNOWNCORE;
-  } else if ((strlen(uri) - skip) == 7 &&
-             memcmp(uri + skip, ".well-known/knx", 15) == 0) {
-    type = OC_KNX;
-  }
-
-#ifdef OC_SECURITY
-
-#endif /* OC_SECURITY */
-  else {
+  if (uri == NULL) {
     return NULL;
   }
-  size_t res = WELLKNOWNCORE * device + type;
-  return &core_resources[res];
+  return oc_ri_get_core_resource_by_uri(uri, strlen(uri), device);
 }
 
 int
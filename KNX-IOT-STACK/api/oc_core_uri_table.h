@@ -0,0 +1,183 @@
+/* generated by tools/gen_core_uri_table.py, do not edit */
+
+/*
+ * perfect hash table from uri to the const core resources of device 0.
+ * only to be included by api/oc_ri.c
+ */
+
+#ifndef OC_CORE_URI_TABLE_H
+#define OC_CORE_URI_TABLE_H
+
+#define OC_CORE_URI_TABLE_SEED (1135u)
+#define OC_CORE_URI_TABLE_SLOTS (256)
+
+OC_CORE_EXTERN_CONST_RESOURCE(well_known_core)
+OC_CORE_EXTERN_CONST_RESOURCE(knx)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_fingerprint)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_ia)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_idevid)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_ldevid)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_osn)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_spake)
+OC_CORE_EXTERN_CONST_RESOURCE(a_lsm)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_a_sen)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_swu_pkgcmd)
+OC_CORE_EXTERN_CONST_RESOURCE(app)
+OC_CORE_EXTERN_CONST_RESOURCE(app_x)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_auth)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_auth_at)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_auth_at_x)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_auth_o)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_auth_o_osndelay)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_auth_o_replwdo)
+OC_CORE_EXTERN_CONST_RESOURCE(dev)
+OC_CORE_EXTERN_CONST_RESOURCE(dev_da)
+OC_CORE_EXTERN_CONST_RESOURCE(dev_fid)
+OC_CORE_EXTERN_CONST_RESOURCE(dev_fwv)
+OC_CORE_EXTERN_CONST_RESOURCE(dev_hostname)
+OC_CORE_EXTERN_CONST_RESOURCE(dev_hwt)
+OC_CORE_EXTERN_CONST_RESOURCE(dev_hwv)
+OC_CORE_EXTERN_CONST_RESOURCE(dev_iid)
+OC_CORE_EXTERN_CONST_RESOURCE(dev_ipv6)
+OC_CORE_EXTERN_CONST_RESOURCE(dev_mid)
+OC_CORE_EXTERN_CONST_RESOURCE(dev_model)
+OC_CORE_EXTERN_CONST_RESOURCE(dev_mport)
+OC_CORE_EXTERN_CONST_RESOURCE(dev_pm)
+OC_CORE_EXTERN_CONST_RESOURCE(dev_port)
+OC_CORE_EXTERN_CONST_RESOURCE(dev_sn)
+OC_CORE_EXTERN_CONST_RESOURCE(dev_sa)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_f)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_f_x)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_fp_g)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_fp_g_x)
+#if defined(OC_IOT_ROUTER)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_fp_gm)
+#endif
+#if defined(OC_IOT_ROUTER)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_fp_gm_x)
+#endif
+#if defined(OC_PUBLISHER_TABLE)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_fp_p)
+#endif
+#if defined(OC_PUBLISHER_TABLE)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_fp_p_x)
+#endif
+OC_CORE_EXTERN_CONST_RESOURCE(knx_fp_r)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_fp_r_x)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_k)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_p)
+OC_CORE_EXTERN_CONST_RESOURCE(sub)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_swu)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_lastupdate)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_swu_maxdefer)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_swu_method)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_swu_pkgbytes)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_swu_pkgnames)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_swu_pkgqurl)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_swu_pkgv)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_swu_protocol)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_swu_result)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_swu_state)
+OC_CORE_EXTERN_CONST_RESOURCE(knx_swu_update)
+
+/* the core resources, NULL if not compiled in */
+static const oc_resource_t *const oc_core_uri_table[] = {
+  &OC_CORE_RESOURCE_NAME(well_known_core), // /.well-known/core
+  &OC_CORE_RESOURCE_NAME(knx), // /.well-known/knx
+  &OC_CORE_RESOURCE_NAME(knx_fingerprint), // /.well-known/knx/f
+  &OC_CORE_RESOURCE_NAME(knx_ia), // /.well-known/knx/ia
+  &OC_CORE_RESOURCE_NAME(knx_idevid), // /.well-known/knx/idevid
+  &OC_CORE_RESOURCE_NAME(knx_ldevid), // /.well-known/knx/ldevid
+  &OC_CORE_RESOURCE_NAME(knx_osn), // /.well-known/knx/osn
+  &OC_CORE_RESOURCE_NAME(knx_spake), // /.well-known/knx/spake
+  &OC_CORE_RESOURCE_NAME(a_lsm), // /a/lsm
+  &OC_CORE_RESOURCE_NAME(knx_a_sen), // /a/sen
+  &OC_CORE_RESOURCE_NAME(knx_swu_pkgcmd), // /a/swu
+  &OC_CORE_RESOURCE_NAME(app), // /ap
+  &OC_CORE_RESOURCE_NAME(app_x), // /ap/pv
+  &OC_CORE_RESOURCE_NAME(knx_auth), // /auth
+  &OC_CORE_RESOURCE_NAME(knx_auth_at), // /auth/at
+  &OC_CORE_RESOURCE_NAME(knx_auth_at_x), // /auth/at/*
+  &OC_CORE_RESOURCE_NAME(knx_auth_o), // /auth/o
+  &OC_CORE_RESOURCE_NAME(knx_auth_o_osndelay), // /auth/o/osndelay
+  &OC_CORE_RESOURCE_NAME(knx_auth_o_replwdo), // /auth/o/replwdo
+  &OC_CORE_RESOURCE_NAME(dev), // /dev
+  &OC_CORE_RESOURCE_NAME(dev_da), // /dev/da
+  &OC_CORE_RESOURCE_NAME(dev_fid), // /dev/fid
+  &OC_CORE_RESOURCE_NAME(dev_fwv), // /dev/fwv
+  &OC_CORE_RESOURCE_NAME(dev_hostname), // /dev/hname
+  &OC_CORE_RESOURCE_NAME(dev_hwt), // /dev/hwt
+  &OC_CORE_RESOURCE_NAME(dev_hwv), // /dev/hwv
+  &OC_CORE_RESOURCE_NAME(dev_iid), // /dev/iid
+  &OC_CORE_RESOURCE_NAME(dev_ipv6), // /dev/ipv6
+  &OC_CORE_RESOURCE_NAME(dev_mid), // /dev/mid
+  &OC_CORE_RESOURCE_NAME(dev_model), // /dev/model
+  &OC_CORE_RESOURCE_NAME(dev_mport), // /dev/mport
+  &OC_CORE_RESOURCE_NAME(dev_pm), // /dev/pm
+  &OC_CORE_RESOURCE_NAME(dev_port), // /dev/port
+  &OC_CORE_RESOURCE_NAME(dev_sn), // /dev/sn
+  &OC_CORE_RESOURCE_NAME(dev_sa), // /dev/sna
+  &OC_CORE_RESOURCE_NAME(knx_f), // /f
+  &OC_CORE_RESOURCE_NAME(knx_f_x), // /f/*
+  &OC_CORE_RESOURCE_NAME(knx_fp_g), // /fp/g
+  &OC_CORE_RESOURCE_NAME(knx_fp_g_x), // /fp/g/*
+#if defined(OC_IOT_ROUTER)
+  &OC_CORE_RESOURCE_NAME(knx_fp_gm), // /fp/gm
+#else
+  NULL,
+#endif
+#if defined(OC_IOT_ROUTER)
+  &OC_CORE_RESOURCE_NAME(knx_fp_gm_x), // /fp/gm/*
+#else
+  NULL,
+#endif
+#if defined(OC_PUBLISHER_TABLE)
+  &OC_CORE_RESOURCE_NAME(knx_fp_p), // /fp/p
+#else
+  NULL,
+#endif
+#if defined(OC_PUBLISHER_TABLE)
+  &OC_CORE_RESOURCE_NAME(knx_fp_p_x), // /fp/p/*
+#else
+  NULL,
+#endif
+  &OC_CORE_RESOURCE_NAME(knx_fp_r), // /fp/r
+  &OC_CORE_RESOURCE_NAME(knx_fp_r_x), // /fp/r/*
+  &OC_CORE_RESOURCE_NAME(knx_k), // /k
+  &OC_CORE_RESOURCE_NAME(knx_p), // /p
+  &OC_CORE_RESOURCE_NAME(sub), // /sub
+  &OC_CORE_RESOURCE_NAME(knx_swu), // /swu
+  &OC_CORE_RESOURCE_NAME(knx_lastupdate), // /swu/lastupdate
+  &OC_CORE_RESOURCE_NAME(knx_swu_maxdefer), // /swu/maxdefer
+  &OC_CORE_RESOURCE_NAME(knx_swu_method), // /swu/method
+  &OC_CORE_RESOURCE_NAME(knx_swu_pkgbytes), // /swu/pkgbytes
+  &OC_CORE_RESOURCE_NAME(knx_swu_pkgnames), // /swu/pkgname
+  &OC_CORE_RESOURCE_NAME(knx_swu_pkgqurl), // /swu/pkgqurl
+  &OC_CORE_RESOURCE_NAME(knx_swu_pkgv), // /swu/pkgv
+  &OC_CORE_RESOURCE_NAME(knx_swu_protocol), // /swu/protocol
+  &OC_CORE_RESOURCE_NAME(knx_swu_result), // /swu/result
+  &OC_CORE_RESOURCE_NAME(knx_swu_state), // /swu/state
+  &OC_CORE_RESOURCE_NAME(knx_swu_update), // /swu/update
+};
+
+/* index + 1 in oc_core_uri_table, 0 is an empty slot */
+static const uint8_t oc_core_uri_table_slots[OC_CORE_URI_TABLE_SLOTS] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 38, 0, 0, 0, 0, 0, 0,
+  0, 0, 43, 0, 0, 0, 36, 0, 42, 26, 32, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 31, 0, 46, 24, 18, 0, 0, 0, 0,
+  0, 0, 37, 7, 0, 0, 0, 23, 0, 0, 0, 0, 0, 0, 0, 0,
+  47, 11, 9, 0, 0, 0, 0, 56, 0, 0, 0, 0, 0, 5, 0, 0,
+  0, 0, 0, 0, 0, 0, 48, 60, 52, 0, 53, 55, 0, 0, 0, 14,
+  34, 0, 0, 0, 0, 0, 59, 0, 0, 10, 0, 0, 3, 0, 0, 0,
+  8, 0, 0, 0, 4, 57, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 29, 0, 22, 0, 0, 0, 0, 0, 0, 39, 0, 0, 28, 20,
+  0, 0, 0, 0, 0, 0, 0, 41, 0, 1, 0, 0, 49, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 54, 50, 0,
+  0, 25, 0, 0, 0, 0, 0, 0, 0, 58, 0, 0, 19, 0, 0, 0,
+  13, 0, 0, 0, 0, 6, 15, 0, 0, 33, 0, 0, 0, 0, 27, 0,
+  0, 40, 0, 35, 44, 30, 0, 0, 45, 0, 0, 0, 0, 0, 12, 0,
+  0, 0, 16, 0, 0, 0, 0, 0, 0, 0, 0, 21, 0, 0, 0, 0,
+  0, 2, 0, 0, 17, 0, 0, 0, 0, 51, 0, 0, 0, 0, 0, 0,
+};
+
+#endif /* OC_CORE_URI_TABLE_H */
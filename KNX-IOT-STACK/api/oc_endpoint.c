@@ -691,3 +691,138 @@ oc_endpoint_print(oc_endpoint_t *ep)
   PRINT("IP address (ep) to: %s\n", oc_string_checked(ip_str));
   oc_free_string(&ip_str);
 }
+
+// ----------------------------------------------------------------------------
+// local endpoint set
+//
+// open addressing hash table of the addresses + ports of this device, filled
+// in by the connectivity layer when the addresses of the interface change.
+// used to check in O(1) if a received message has been sent by this device.
+// the connectivity layer may update the set from its own thread, hence the
+// set is only changed and read with the network event handler mutex held.
+
+#ifndef OC_MAX_LOCAL_ENDPOINTS
+#define OC_MAX_LOCAL_ENDPOINTS (16)
+#endif
+
+// load factor of at most 0.5, keeps the probe sequences short
+#define OC_LOCAL_ENDPOINT_SLOTS (OC_MAX_LOCAL_ENDPOINTS * 2)
+
+typedef struct oc_local_endpoint_t
+{
+  uint8_t address[OC_IPV6_ADDRLEN]; /**< the address, ipv4 uses 4 bytes */
+  uint16_t port;                    /**< the port */
+  uint8_t used;                     /**< slot in use */
+} oc_local_endpoint_t;
+
+static oc_local_endpoint_t g_local_endpoints[OC_LOCAL_ENDPOINT_SLOTS];
+static int g_local_endpoints_len = 0;
+
+/* converts the endpoint to the key stored in the table
+ * returns false if the endpoint can't be stored (e.g. no ip address) */
+static bool
+oc_endpoint_local_key(const oc_endpoint_t *ep, oc_local_endpoint_t *key)
+{
+  memset(key, 0, sizeof(oc_local_endpoint_t));
+  if (ep->flags & IPV6) {
+    memcpy(key->address, ep->addr.ipv6.address, OC_IPV6_ADDRLEN);
+    key->port = ep->addr.ipv6.port;
+    return true;
+  }
+#ifdef OC_IPV4
+  if (ep->flags & IPV4) {
+    memcpy(key->address, ep->addr.ipv4.address, OC_IPV4_ADDRLEN);
+    key->port = ep->addr.ipv4.port;
+    return true;
+  }
+#endif /* OC_IPV4 */
+  return false;
+}
+
+/* FNV-1a over the address and port */
+static uint32_t
+oc_endpoint_local_hash(const oc_local_endpoint_t *key)
+{
+  uint32_t hash = 2166136261u;
+  for (int i = 0; i < OC_IPV6_ADDRLEN; i++) {
+    hash = (hash ^ key->address[i]) * 16777619u;
+  }
+  hash = (hash ^ (key->port & 0xff)) * 16777619u;
+  hash = (hash ^ (key->port >> 8)) * 16777619u;
+  return hash;
+}
+
+/* returns the slot of the key, or the empty slot where it can be stored */
+static oc_local_endpoint_t *
+oc_endpoint_local_find(const oc_local_endpoint_t *key)
+{
+  uint32_t slot = oc_endpoint_local_hash(key) % OC_LOCAL_ENDPOINT_SLOTS;
+  for (int i = 0; i < OC_LOCAL_ENDPOINT_SLOTS; i++) {
+    oc_local_endpoint_t *entry = &g_local_endpoints[slot];
+    if (entry->used == 0 ||
+        (entry->port == key->port &&
+         memcmp(entry->address, key->address, OC_IPV6_ADDRLEN) == 0)) {
+      return entry;
+    }
+    slot = (slot + 1) % OC_LOCAL_ENDPOINT_SLOTS;
+  }
+  return NULL;
+}
+
+void
+oc_endpoint_local_clear(void)
+{
+  memset(g_local_endpoints, 0, sizeof(g_local_endpoints));
+  g_local_endpoints_len = 0;
+}
+
+bool
+oc_endpoint_local_add(const oc_endpoint_t *ep)
+{
+  oc_local_endpoint_t key;
+  if (ep == NULL || !oc_endpoint_local_key(ep, &key)) {
+    return false;
+  }
+  oc_local_endpoint_t *entry = oc_endpoint_local_find(&key);
+  if (entry == NULL) {
+    return false;
+  }
+  if (entry->used) {
+    // already in the set
+    return true;
+  }
+  if (g_local_endpoints_len >= OC_MAX_LOCAL_ENDPOINTS) {
+    OC_ERR("local endpoint set full");
+    return false;
+  }
+  *entry = key;
+  entry->used = 1;
+  g_local_endpoints_len++;
+  return true;
+}
+
+void
+oc_endpoint_local_set_list(const oc_endpoint_t *list)
+{
+  oc_endpoint_local_clear();
+  for (; list != NULL; list = list->next) {
+    oc_endpoint_local_add(list);
+  }
+}
+
+bool
+oc_endpoint_is_local(const oc_endpoint_t *ep)
+{
+  oc_local_endpoint_t key;
+  if (ep == NULL || !oc_endpoint_local_key(ep, &key)) {
+    return false;
+  }
+  bool is_local = false;
+  oc_network_event_handler_mutex_lock();
+  if (g_local_endpoints_len > 0) {
+    oc_local_endpoint_t *entry = oc_endpoint_local_find(&key);
+    is_local = (entry != NULL && entry->used != 0);
+  }
+  oc_network_event_handler_mutex_unlock();
+  return is_local;
+}
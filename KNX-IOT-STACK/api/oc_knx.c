@@ -44,6 +44,9 @@
 // ---------------------------Variables --------------------------------------
 
 static oc_group_object_notification_t g_received_notification;
+// st of the last received s-mode message, the st and value of
+// g_received_notification are only filled in for the gateway callback
+static oc_s_mode_st_t g_received_st = OC_S_MODE_ST_NONE;
 
 static uint64_t g_fingerprint = 0;
 static uint64_t g_osn = 0;
@@ -574,7 +577,7 @@ oc_core_knx_k_get_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
   oc_rep_i_set_int(value, 7, g_received_notification.ga);
   // st M Service type code(write = w, read = r, response = rp) Enum : w, r, a
   // (rp)
-  oc_rep_i_set_text_string(value, 6, oc_string(g_received_notification.st));
+  oc_rep_i_set_text_string(value, 6, oc_s_mode_st_to_string(g_received_st));
   // missing value
 
   cbor_encoder_close_container_checked(&root_map, &value_map);
@@ -634,9 +637,137 @@ oc_reset_g_received_notification()
   g_received_notification.sia = 0;
   g_received_notification.ga = 0;
   // g_received_notification.value =
+  g_received_st = OC_S_MODE_ST_NONE;
+}
 
+/* fills in the st and the (base64 encoded) payload as value of the received
+ * notification, only needed for the gateway callback */
+static void
+oc_knx_k_set_notification_value(oc_request_t *request)
+{
+  const char *st = oc_s_mode_st_to_string(g_received_st);
   oc_free_string(&g_received_notification.st);
-  oc_new_string(&g_received_notification.st, "", strlen(""));
+  oc_new_string(&g_received_notification.st, st, strlen(st));
+
+  // maximum base64 overhead, plus one byte for the null terminator
+  size_t base64_max_len = (request->_payload_len / 3 + 1) * 4 + 1;
+  int base64_len;
+  uint8_t *base64_buf = malloc(base64_max_len);
+
+  oc_free_string(&g_received_notification.value);
+  base64_len = oc_base64_encode(request->_payload, request->_payload_len,
+                                base64_buf, base64_max_len);
+  if (base64_len < 0) {
+    char *error_msg = "Base64 encoding error in library!";
+    oc_new_string(&g_received_notification.value, error_msg, strlen(error_msg));
+    OC_ERR("%s", error_msg);
+  } else {
+    // add null terminator
+    base64_buf[base64_len] = '0';
+    oc_new_string(&g_received_notification.value, base64_buf, base64_len);
+  }
+  free(base64_buf);
+}
+
+// ----------------------------------------------------------------------------
+// receive side duplicate suppression
+//
+// devices build with OC_USE_MULTICAST_SCOPE_2 send the same s-mode message on
+// scope 2 and scope 5. the copies are separate CoAP messages (different MID,
+// and with OSCORE a different SSN) and may come from different source
+// addresses (link local vs mesh local). a copy is recognized as: the same
+// frame (sia, ga, st and value) sent to the multicast address of the other
+// scope, within OC_S_MODE_DEDUP_WINDOW_MS. repeats on the same scope are
+// always new messages, as are messages without a known multicast destination.
+// OC_S_MODE_DEDUP_WINDOW_MS = 0 disables the duplicate suppression, it is
+// disabled by default when the device does not use scope 2 itself.
+
+#ifndef OC_S_MODE_DEDUP_WINDOW_MS
+#ifdef OC_USE_MULTICAST_SCOPE_2
+#define OC_S_MODE_DEDUP_WINDOW_MS (500)
+#else
+#define OC_S_MODE_DEDUP_WINDOW_MS (0)
+#endif
+#endif
+
+#ifndef OC_S_MODE_DEDUP_SIZE
+#define OC_S_MODE_DEDUP_SIZE (8)
+#endif
+
+typedef struct oc_s_mode_dedup_t
+{
+  uint32_t sia;         /**< sender individual address */
+  uint32_t ga;          /**< group address */
+  uint32_t value_hash;  /**< hash of the encoded value */
+  oc_s_mode_st_t st;    /**< service type */
+  uint8_t scope;        /**< multicast scope the frame was sent to */
+  oc_clock_time_t time; /**< time of reception */
+} oc_s_mode_dedup_t;
+
+static oc_s_mode_dedup_t g_s_mode_dedup[OC_S_MODE_DEDUP_SIZE];
+static int g_s_mode_dedup_next = 0;
+
+/* FNV-1a over the encoded value */
+static uint32_t
+oc_s_mode_value_hash(const uint8_t *value, size_t value_len)
+{
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < value_len; i++) {
+    hash = (hash ^ value[i]) * 16777619u;
+  }
+  return hash;
+}
+
+/* the scope of the IPv6 multicast address the message was sent to,
+ * 0 if not known */
+static uint8_t
+oc_s_mode_destination_scope(const oc_endpoint_t *origin)
+{
+  if (origin == NULL || (origin->flags & IPV6) == 0 ||
+      origin->addr_local.ipv6.address[0] != 0xff) {
+    return 0;
+  }
+  return origin->addr_local.ipv6.address[1] & 0x0f;
+}
+
+/* returns true if the frame is a copy of a frame received on the other
+ * multicast scope within the window, otherwise the frame is stored */
+static bool
+oc_s_mode_is_duplicate(const oc_s_mode_frame_t *frame,
+                       const oc_endpoint_t *origin)
+{
+  if (OC_S_MODE_DEDUP_WINDOW_MS == 0) {
+    return false;
+  }
+  uint8_t scope = oc_s_mode_destination_scope(origin);
+  if (scope == 0) {
+    return false;
+  }
+  oc_clock_time_t now = oc_clock_time();
+  oc_clock_time_t window =
+    (oc_clock_time_t)OC_S_MODE_DEDUP_WINDOW_MS * OC_CLOCK_SECOND / 1000;
+  uint32_t value_hash = oc_s_mode_value_hash(frame->value, frame->value_len);
+
+  for (int i = 0; i < OC_S_MODE_DEDUP_SIZE; i++) {
+    oc_s_mode_dedup_t *entry = &g_s_mode_dedup[i];
+    if (entry->st != OC_S_MODE_ST_NONE && now - entry->time < window &&
+        entry->scope != scope && entry->sia == frame->sia &&
+        entry->ga == frame->ga && entry->st == frame->st &&
+        entry->value_hash == value_hash) {
+      // drop only one copy, a next message with the same content is new
+      entry->st = OC_S_MODE_ST_NONE;
+      return true;
+    }
+  }
+  oc_s_mode_dedup_t *entry = &g_s_mode_dedup[g_s_mode_dedup_next];
+  g_s_mode_dedup_next = (g_s_mode_dedup_next + 1) % OC_S_MODE_DEDUP_SIZE;
+  entry->sia = frame->sia;
+  entry->ga = frame->ga;
+  entry->value_hash = value_hash;
+  entry->st = frame->st;
+  entry->scope = scope;
+  entry->time = now;
+  return false;
 }
 
 /*
@@ -647,14 +778,11 @@ oc_core_knx_k_post_handler(oc_request_t *request,
                            oc_interface_mask_t iface_mask, void *data)
 {
   (void)data;
-  oc_rep_t *rep = NULL;
-  oc_rep_t *rep_value = NULL;
+  oc_s_mode_frame_t frame;
+  oc_s_mode_frame_error_t frame_error;
   char ip_address[100];
 
   PRINT("KNX K POST Handler\n");
-  PRINT("Decoded Payload:\n");
-  oc_print_rep_as_json(request->request_payload, true);
-
   PRINT("Full Payload Size: %d\n", (int)request->_payload_len);
   OC_LOGbytes_OSCORE(request->_payload, (int)request->_payload_len);
 
@@ -678,20 +806,11 @@ oc_core_knx_k_post_handler(oc_request_t *request,
       PRINT("\n");
     }
 
-    oc_endpoint_t *my_ep = oc_connectivity_get_endpoints(0);
-    oc_endpoint_t *ep_i = NULL;
-
-    for (ep_i = my_ep; ep_i != NULL; ep_i = ep_i->next) {
-      PRINTipaddr(*ep_i);
-      PRINT("\n");
-
-      if (oc_endpoint_compare_address(origin, ep_i) == 0) {
-        if (origin->addr.ipv6.port == ep_i->addr.ipv6.port) {
-          request->response->response_buffer->code = oc_status_code(OC_IGNORE);
-          PRINT(" same address and port: not handling message");
-          return;
-        }
-      }
+    // the set of local endpoints is maintained by the connectivity layer
+    if (oc_endpoint_is_local(origin)) {
+      request->response->response_buffer->code = oc_status_code(OC_IGNORE);
+      PRINT(" same address and port: not handling message");
+      return;
     }
   }
 
@@ -707,75 +826,36 @@ oc_core_knx_k_post_handler(oc_request_t *request,
   // get sender ip address
   SNPRINTFipaddr(ip_address, 100 - 1, *request->origin);
 
-  /* loop over the request document to parse all the data */
-  rep = request->request_payload;
-  while (rep != NULL) {
-    switch (rep->type) {
-    case OC_REP_INT: {
-      // sia
-      if (rep->iname == 4) {
-        g_received_notification.sia = (uint32_t)rep->value.integer;
-      }
-    } break;
-    case OC_REP_OBJECT: {
-      // find the storage index, e.g. for this object
-      oc_rep_t *object = rep->value.object;
-
-      while (object != NULL) {
-        switch (object->type) {
-        case OC_REP_STRING: {
-          if (object->iname == 6) {
-            oc_free_string(&g_received_notification.st);
-            oc_new_string(&g_received_notification.st,
-                          oc_string(object->value.string),
-                          oc_string_len(object->value.string));
-          }
-        } break;
-
-        case OC_REP_INT: {
-          // sia
-          if (object->iname == 4) {
-            g_received_notification.sia = (uint32_t)object->value.integer;
-          }
-          // ga
-          if (object->iname == 7) {
-            g_received_notification.ga = (uint32_t)object->value.integer;
-          }
-        } break;
-        default:
-          break;
-        }
-        object = object->next;
-      }
-    }
-    case OC_REP_NIL:
-      break;
-    default:
-      break;
+  /* the payload is not parsed into a rep tree (OC_RAW_PAYLOAD),
+   * decode the frame directly */
+  frame_error = oc_s_mode_decode_frame(request->_payload,
+                                       request->_payload_len, &frame);
+  if (frame_error != OC_S_MODE_FRAME_OK) {
+    OC_ERR(" k : invalid s-mode frame: %s",
+           oc_s_mode_frame_error_str(frame_error));
+    if (request->origin && (request->origin->flags & MULTICAST)) {
+      oc_send_cbor_response(request, OC_IGNORE);
+    } else {
+      oc_send_cbor_response(request, OC_STATUS_BAD_REQUEST);
     }
-    rep = rep->next;
+    return;
   }
-  // maximum base64 overhead, plus one byte for the null terminator
-  size_t base64_max_len = (request->_payload_len / 3 + 1) * 4 + 1;
-  int base64_len;
-  uint8_t *base64_buf = malloc(base64_max_len);
-
-  oc_free_string(&g_received_notification.value);
-  base64_len = oc_base64_encode(request->_payload, request->_payload_len,
-                                base64_buf, base64_max_len);
-  if (base64_len < 0) {
-    char *error_msg = "Base64 encoding error in library!";
-    oc_new_string(&g_received_notification.value, error_msg, strlen(error_msg));
-    OC_ERR("%s", error_msg);
-  } else {
-    // add null terminator
-    base64_buf[base64_len] = '0';
-    oc_new_string(&g_received_notification.value, base64_buf, base64_len);
+  if (oc_s_mode_is_duplicate(&frame, request->origin)) {
+    // same message received on the other multicast scope
+    PRINT(" k : duplicate s-mode message: sia %u ga %u - ignore message\n",
+          frame.sia, frame.ga);
+    oc_send_cbor_response(request, OC_IGNORE);
+    return;
   }
-  free(base64_buf);
+  g_received_notification.sia = frame.sia;
+  g_received_notification.ga = frame.ga;
+  g_received_st = frame.st;
+
   // gateway functionality: call back for all s-mode calls
+  // the notification value is only encoded when there is a gateway
   oc_gateway_t *my_gw = oc_get_gateway_cb();
   if (my_gw != NULL && my_gw->cb) {
+    oc_knx_k_set_notification_value(request);
     if (my_gw->data) {
       // call the gateway function
       my_gw->cb(device_index, ip_address, &g_received_notification,
@@ -783,8 +863,13 @@ oc_core_knx_k_post_handler(oc_request_t *request,
     } else {
       // if data is NULL, pass json payload as data
       char buffer[300];
-      memset(buffer, 300, 0);
-      oc_rep_to_json(request->request_payload, (char *)&buffer, 300, true);
+      oc_rep_t *payload = NULL;
+      memset(buffer, 0, 300);
+      if (oc_parse_rep(request->_payload, (int)request->_payload_len,
+                       &payload) == CborNoError) {
+        oc_rep_to_json(payload, (char *)&buffer, 300, true);
+      }
+      oc_free_rep(payload);
 
       my_gw->cb(device_index, ip_address, &g_received_notification, buffer);
     }
@@ -803,40 +888,64 @@ oc_core_knx_k_post_handler(oc_request_t *request,
   // loop over the group addresses of the /fp/r
   PRINT(" k : origin:%s sia: %d ga: %d st: %s\n", ip_address,
         g_received_notification.sia, g_received_notification.ga,
-        oc_string_checked(g_received_notification.st));
-  if (strcmp(oc_string_checked(g_received_notification.st), "w") == 0) {
+        oc_s_mode_st_to_string(g_received_st));
+  switch (g_received_st) {
+  case OC_S_MODE_ST_WRITE:
     // case_1 :
     // Received from bus: -st w, any ga ==> @receiver:
     // cflags = w -> overwrite object value
     st_write = true;
-  } else if (strcmp(oc_string_checked(g_received_notification.st), "a") == 0) {
+    break;
+  case OC_S_MODE_ST_RESPONSE:
     // Case 2) spec 1.1
     // Received from bus: -st rp, any ga
     //@receiver: cflags = u -> overwrite object value
     st_rep = true;
-  } else if (strcmp(oc_string_checked(g_received_notification.st), "rp") == 0) {
+    break;
+  case OC_S_MODE_ST_RESPONSE_RP:
     // Case 2) spec 1.0
     // Received from bus: -st a (rp), any ga
     //@receiver: cflags = u -> overwrite object value
     st_rep = true;
-  } else if (strcmp(oc_string_checked(g_received_notification.st), "r") == 0) {
+    break;
+  case OC_S_MODE_ST_READ:
     // Case 4)
     // @sender: cflags = r
     // Received from bus: -st r
     // Sent: -st rp, sending association (1st assigned ga)
     st_read = true;
-  }
-
-  int index = oc_core_find_group_object_table_index(g_received_notification.ga);
-  PRINT(" k : index %d\n", index);
-  if (index == -1) {
-    // if nothing is found (initially) then return a bad request.
+    break;
+  default:
+    break;
+  }
+  if (st_write || st_rep) {
+    // the value is received, no need to read it at initialization
+    oc_cancel_init_read(g_received_notification.ga);
+  }
+
+  // the table is scanned when there is no memory for the dispatch index,
+  // so no entry means the group address is not used by this device
+  int pos = 0;
+  oc_group_object_dispatch_t scan_entry;
+  const oc_group_object_dispatch_t *entry =
+    oc_core_next_group_object_table_dispatch(g_received_notification.ga,
+                                             device_index, &pos, &scan_entry);
+  if (entry == NULL) {
+    PRINT(" k : no entries for ga %u - ignore message\n",
+          g_received_notification.ga);
     oc_send_cbor_response(request, OC_IGNORE);
     return;
   }
 
   bool send_payload = false;
 
+  // the value is decoded once and handed to all group objects
+  oc_rep_t *value = NULL;
+  oc_rep_t value_storage;
+  if (st_write || st_rep) {
+    value = oc_s_mode_frame_get_value(&frame, &value_storage);
+  }
+
   // create the dummy request
   oc_request_t new_request;
   memset(&new_request, 0, sizeof(oc_request_t));
@@ -845,19 +954,23 @@ oc_core_knx_k_post_handler(oc_request_t *request,
   oc_response_t response_obj;
   memset(&response_obj, 0, sizeof(oc_response_t));
 
-  while (index != -1) {
-    oc_string_t myurl = oc_core_find_group_object_table_url_from_index(index);
-    PRINT(" k : url  %s\n", oc_string_checked(myurl));
-    if (oc_string_len(myurl) > 0) {
-      // get the resource to do the fake post on
-      const oc_resource_t *my_resource = oc_ri_get_app_resource_by_uri(
-        oc_string(myurl), oc_string_len(myurl), device_index);
+  for (; entry != NULL;
+       entry = oc_core_next_group_object_table_dispatch(
+         g_received_notification.ga, device_index, &pos, &scan_entry)) {
+    // the dispatch entries are precomputed when the group object table changes
+    int index = entry->index;
+    const char *myurl = entry->href;
+    PRINT(" k : url  %s\n", myurl ? myurl : "");
+    if (myurl != NULL && myurl[0] != 0) {
+      // the resource to do the fake post on
+      const oc_resource_t *my_resource = entry->resource;
       if (my_resource == NULL) {
-        return;
+        // no such resource, the other entries are still handled
+        continue;
       }
 
       // check if the data is allowed to write or update
-      oc_cflag_mask_t cflags = oc_core_group_object_table_cflag_entries(index);
+      oc_cflag_mask_t cflags = entry->cflags;
       if (((cflags & OC_CFLAG_WRITE) > 0) && (st_write)) {
         PRINT(" (case1) W-WRITE: index %d handled due to flags %d\n", index,
               cflags);
@@ -872,7 +985,7 @@ oc_core_knx_k_post_handler(oc_request_t *request,
         if (my_resource->put_handler.cb) {
           oc_ri_new_request_from_request(&new_request, request,
                                          &response_buffer, &response_obj);
-          new_request.request_payload = oc_s_mode_get_value(request);
+          new_request.request_payload = value;
           new_request.uri_path = "k";
           new_request.uri_path_len = 1;
 
@@ -884,9 +997,9 @@ oc_core_knx_k_post_handler(oc_request_t *request,
             // Sent : -st w, sending association(1st assigned ga)
             PRINT("  (case3) (W-WRITE) sending WRITE due to TRANSMIT flag \n");
 #ifdef OC_USE_MULTICAST_SCOPE_2
-            oc_do_s_mode_with_scope(2, oc_string(myurl), "w");
+            oc_do_s_mode_st_no_loopback(2, myurl, OC_S_MODE_ST_WRITE);
 #endif
-            oc_do_s_mode_with_scope(5, oc_string(myurl), "w");
+            oc_do_s_mode_st_no_loopback(5, myurl, OC_S_MODE_ST_WRITE);
           }
         }
       }
@@ -900,7 +1013,7 @@ oc_core_knx_k_post_handler(oc_request_t *request,
         if (my_resource->put_handler.cb) {
           oc_ri_new_request_from_request(&new_request, request,
                                          &response_buffer, &response_obj);
-          new_request.request_payload = oc_s_mode_get_value(request);
+          new_request.request_payload = value;
           new_request.uri_path = "k";
           new_request.uri_path_len = 1;
 
@@ -913,9 +1026,9 @@ oc_core_knx_k_post_handler(oc_request_t *request,
             // @sender : updated object value + cflags = t
             // Sent : -st w, sending association(1st assigned ga)
 #ifdef OC_USE_MULTICAST_SCOPE_2
-            oc_do_s_mode_with_scope(2, oc_string(myurl), "w");
+            oc_do_s_mode_st_no_loopback(2, myurl, OC_S_MODE_ST_WRITE);
 #endif
-            oc_do_s_mode_with_scope(5, oc_string(myurl), "w");
+            oc_do_s_mode_st_no_loopback(5, myurl, OC_S_MODE_ST_WRITE);
           }
         }
       }
@@ -930,29 +1043,27 @@ oc_core_knx_k_post_handler(oc_request_t *request,
         // specifically: do not check the transmission flag
         PRINT("   (case3) (RP-UPDATE) sending RP due to READ flag \n");
 
-        if (my_resource->get_handler.cb) {
+        // a published value is sent as is, the GET handler is not needed
+        if (my_resource->get_handler.cb &&
+            !oc_s_mode_is_value_published(my_resource)) {
           oc_ri_new_request_from_request(&new_request, request,
                                          &response_buffer, &response_obj);
-          new_request.uri_path = oc_string(myurl);
-          new_request.uri_path_len = oc_string_len(myurl);
+          new_request.uri_path = myurl;
+          new_request.uri_path_len = strlen(myurl);
           new_request.accept = request->accept;
 
           my_resource->get_handler.cb(&new_request, iface_mask, NULL);
         }
 #ifdef OC_USE_MULTICAST_SCOPE_2
-        // oc_do_s_mode_with_scope_no_check(2, oc_string(myurl), "rp");
-        oc_do_s_mode_with_scope_no_check(2, oc_string(myurl), "a");
+        // oc_do_s_mode_with_scope_no_check(2, myurl, "rp");
+        oc_do_s_mode_st_no_check(2, myurl, OC_S_MODE_ST_RESPONSE);
 #endif
-        // oc_do_s_mode_with_scope_no_check(5, oc_string(myurl), "rp");
-        oc_do_s_mode_with_scope_no_check(5, oc_string(myurl), "a");
+        // oc_do_s_mode_with_scope_no_check(5, myurl, "rp");
+        oc_do_s_mode_st_no_check(5, myurl, OC_S_MODE_ST_RESPONSE);
       }
     }
-    // get the next index in the table to get the url from.
-    // this stops when the returned index == -1
-    int new_index = oc_core_find_next_group_object_table_index(
-      g_received_notification.ga, index);
-    index = new_index;
   }
+  oc_s_mode_free_value(value, &value_storage);
 
   // don't send anything back on a multi cast message
   if (request->origin && (request->origin->flags & MULTICAST)) {
@@ -970,7 +1081,8 @@ oc_core_knx_k_post_handler(oc_request_t *request,
 
 OC_CORE_CREATE_CONST_RESOURCE_LINKED(knx_k, knx_fingerprint, 0, "/k",
                                      OC_IF_LI | OC_IF_G | OC_IF_D,
-                                     APPLICATION_CBOR, OC_DISCOVERABLE,
+                                     APPLICATION_CBOR,
+                                     OC_DISCOVERABLE | OC_RAW_PAYLOAD,
                                      oc_core_knx_k_get_handler, 0,
                                      oc_core_knx_k_post_handler, 0, NULL,
                                      OC_SIZE_MANY(1), "urn:knx:g.s");
@@ -979,10 +1091,10 @@ oc_create_knx_k_resource(int resource_idx, size_t device)
 {
   OC_DBG("oc_create_knx_k_resource (g)\n");
 
-  oc_core_populate_resource(resource_idx, device, "/k",
-                            OC_IF_LI | OC_IF_G | OC_IF_D, APPLICATION_CBOR,
-                            OC_DISCOVERABLE, oc_core_knx_k_get_handler, 0,
-                            oc_core_knx_k_post_handler, 0, 1, "urn:knx:g.s");
+  oc_core_populate_resource(
+    resource_idx, device, "/k", OC_IF_LI | OC_IF_G | OC_IF_D, APPLICATION_CBOR,
+    OC_DISCOVERABLE | OC_RAW_PAYLOAD, oc_core_knx_k_get_handler, 0,
+    oc_core_knx_k_post_handler, 0, 1, "urn:knx:g.s");
 }
 
 int
@@ -24,6 +24,7 @@
 #include "oc_core_res.h"
 #include "oc_discovery.h"
 #include <stdio.h>
+#include <stdlib.h>
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
 
@@ -41,8 +42,7 @@ typedef struct broker_s_mode_userdata_t
   int ia;          /**< internal address of the destination */
   char path[20];   /**< the path on the device designated with ia */
   uint32_t ga;     /**< group address to use */
-  char rp_type[3]; /**< mode to send the message "w"  = 1  "r" = 2  "a" = 3
-                      ("rp") */
+  oc_s_mode_st_t st;     /**< service type of the message */
   char resource_url[20]; /**< the url to pull the data from. */
 } broker_s_mode_userdata_t;
 
@@ -69,11 +69,13 @@ static oc_spake_context_t g_spake_ctx;
 // ----------------------------------------------------------------------------
 
 static void oc_send_s_mode(oc_endpoint_t *endpoint, char *path,
-                           uint32_t sia_value, uint32_t group_address, char *rp,
-                           uint8_t *value_data, int value_size);
+                           uint32_t sia_value, uint32_t group_address,
+                           oc_s_mode_st_t st, const uint8_t *value_data,
+                           int value_size);
 
-static int oc_s_mode_get_resource_value(const char *resource_url, char *rp,
-                                        uint8_t *buf, int buf_size);
+static uint8_t *oc_s_mode_get_resource_value(const char *resource_url,
+                                             uint8_t *buf, int buf_size,
+                                             int *value_size);
 
 // ----------------------------------------------------------------------------
 
@@ -380,11 +382,17 @@ discovery_ia_cb(const char *payload, int len, oc_endpoint_t *endpoint,
     return OC_STOP_DISCOVERY;
   }
 
-  value_size =
-    oc_s_mode_get_resource_value(cb_data->resource_url, "r", buffer, 100);
+  uint8_t *value_data = oc_s_mode_get_resource_value(
+    cb_data->resource_url, buffer, 100, &value_size);
 
-  oc_send_s_mode(endpoint, cb_data->path, sender_ia, cb_data->ga,
-                 cb_data->rp_type, buffer, value_size);
+  oc_endpoint_t destination;
+  oc_endpoint_copy(&destination, endpoint);
+  destination.priority = oc_s_mode_get_priority(cb_data->resource_url);
+  oc_send_s_mode(&destination, cb_data->path, sender_ia, cb_data->ga,
+                 cb_data->st, value_data, value_size);
+  if (value_data != buffer) {
+    free(value_data);
+  }
 
   if (cb_data) {
     free(user_data);
@@ -395,7 +403,8 @@ discovery_ia_cb(const char *payload, int len, oc_endpoint_t *endpoint,
 
 int
 oc_knx_client_do_broker_request(const char *resource_url, uint64_t iid,
-                                uint32_t ia, char *destination, char *rp)
+                                uint32_t ia, char *destination,
+                                oc_s_mode_st_t st)
 {
   char query[50] = "";
 
@@ -420,7 +429,7 @@ oc_knx_client_do_broker_request(const char *resource_url, uint64_t iid,
   if (cb_data != NULL) {
     memset(cb_data, 0, sizeof(broker_s_mode_userdata_t));
     cb_data->ia = ia;
-    strncpy(cb_data->rp_type, rp, 2);
+    cb_data->st = st;
     strncpy(cb_data->resource_url, resource_url, 20);
     strncpy(cb_data->path, destination, 20);
 
@@ -488,10 +497,264 @@ oc_s_mode_get_value(oc_request_t *request)
   return NULL;
 }
 
+oc_s_mode_st_t
+oc_s_mode_st_from_string(const char *st)
+{
+  if (st == NULL) {
+    return OC_S_MODE_ST_NONE;
+  }
+  switch (st[0]) {
+  case 'w':
+    return st[1] == '\0' ? OC_S_MODE_ST_WRITE : OC_S_MODE_ST_NONE;
+  case 'a':
+    return st[1] == '\0' ? OC_S_MODE_ST_RESPONSE : OC_S_MODE_ST_NONE;
+  case 'r':
+    if (st[1] == '\0') {
+      return OC_S_MODE_ST_READ;
+    }
+    return (st[1] == 'p' && st[2] == '\0') ? OC_S_MODE_ST_RESPONSE_RP
+                                           : OC_S_MODE_ST_NONE;
+  default:
+    return OC_S_MODE_ST_NONE;
+  }
+}
+
+const char *
+oc_s_mode_st_to_string(oc_s_mode_st_t st)
+{
+  switch (st) {
+  case OC_S_MODE_ST_WRITE:
+    return "w";
+  case OC_S_MODE_ST_READ:
+    return "r";
+  case OC_S_MODE_ST_RESPONSE:
+    return "a";
+  case OC_S_MODE_ST_RESPONSE_RP:
+    return "rp";
+  default:
+    return "";
+  }
+}
+
+/* reads the integer key of a map item and moves the iterator to the value
+ * returns -1 as key for non integer keys */
+static CborError
+oc_s_mode_frame_get_key(CborValue *map, int *key)
+{
+  CborError err = CborNoError;
+  *key = -1;
+  if (cbor_value_is_integer(map)) {
+    err = cbor_value_get_int(map, key);
+  }
+  if (err == CborNoError) {
+    err = cbor_value_advance(map);
+  }
+  /* skip over CBOR Tags */
+  while (err == CborNoError && cbor_value_is_tag(map)) {
+    err = cbor_value_skip_tag(map);
+  }
+  return err;
+}
+
+static oc_s_mode_frame_error_t
+oc_s_mode_frame_get_uint32(CborValue *value, uint32_t *out)
+{
+  uint64_t v;
+  if (!cbor_value_is_unsigned_integer(value)) {
+    return OC_S_MODE_FRAME_INVALID_TYPE;
+  }
+  if (cbor_value_get_uint64(value, &v) != CborNoError || v > UINT32_MAX) {
+    return OC_S_MODE_FRAME_INVALID_TYPE;
+  }
+  *out = (uint32_t)v;
+  return OC_S_MODE_FRAME_OK;
+}
+
+/* decodes the inner map 5:{ 6:st, 7:ga, 1:value } */
+static oc_s_mode_frame_error_t
+oc_s_mode_decode_frame_cmd(CborValue *value, oc_s_mode_frame_t *frame,
+                           bool *ga_found)
+{
+  oc_s_mode_frame_error_t result = OC_S_MODE_FRAME_OK;
+  CborValue map;
+  int key;
+
+  if (!cbor_value_is_map(value)) {
+    return OC_S_MODE_FRAME_NOT_A_MAP;
+  }
+  if (cbor_value_enter_container(value, &map) != CborNoError) {
+    return OC_S_MODE_FRAME_CBOR_ERROR;
+  }
+  while (!cbor_value_at_end(&map)) {
+    if (oc_s_mode_frame_get_key(&map, &key) != CborNoError) {
+      return OC_S_MODE_FRAME_CBOR_ERROR;
+    }
+    if (key == 1) {
+      // keep the encoded value, it is decoded by the data point
+      frame->value = cbor_value_get_next_byte(&map);
+    } else if (key == 4) {
+      result = oc_s_mode_frame_get_uint32(&map, &frame->sia);
+    } else if (key == 6) {
+      char st[3];
+      size_t len = sizeof(st);
+      if (!cbor_value_is_text_string(&map)) {
+        return OC_S_MODE_FRAME_INVALID_TYPE;
+      }
+      if (cbor_value_copy_text_string(&map, st, &len, NULL) != CborNoError) {
+        // longer than any service type
+        return OC_S_MODE_FRAME_INVALID_ST;
+      }
+      frame->st = oc_s_mode_st_from_string(st);
+      if (frame->st == OC_S_MODE_ST_NONE) {
+        return OC_S_MODE_FRAME_INVALID_ST;
+      }
+    } else if (key == 7) {
+      result = oc_s_mode_frame_get_uint32(&map, &frame->ga);
+      *ga_found = true;
+    }
+    if (result != OC_S_MODE_FRAME_OK) {
+      return result;
+    }
+    if (cbor_value_advance(&map) != CborNoError) {
+      return OC_S_MODE_FRAME_CBOR_ERROR;
+    }
+    if (key == 1) {
+      frame->value_len = cbor_value_get_next_byte(&map) - frame->value;
+    }
+  }
+  if (cbor_value_leave_container(value, &map) != CborNoError) {
+    return OC_S_MODE_FRAME_CBOR_ERROR;
+  }
+  return OC_S_MODE_FRAME_OK;
+}
+
+oc_s_mode_frame_error_t
+oc_s_mode_decode_frame(const uint8_t *payload, size_t payload_len,
+                       oc_s_mode_frame_t *frame)
+{
+  oc_s_mode_frame_error_t result = OC_S_MODE_FRAME_OK;
+  CborParser parser;
+  CborValue root, map;
+  bool ga_found = false;
+  int key;
+
+  memset(frame, 0, sizeof(oc_s_mode_frame_t));
+  if (payload == NULL ||
+      cbor_parser_init(payload, payload_len, 0, &parser, &root) !=
+        CborNoError) {
+    return OC_S_MODE_FRAME_CBOR_ERROR;
+  }
+  if (!cbor_value_is_map(&root)) {
+    return OC_S_MODE_FRAME_NOT_A_MAP;
+  }
+  if (cbor_value_enter_container(&root, &map) != CborNoError) {
+    return OC_S_MODE_FRAME_CBOR_ERROR;
+  }
+  while (!cbor_value_at_end(&map)) {
+    if (oc_s_mode_frame_get_key(&map, &key) != CborNoError) {
+      return OC_S_MODE_FRAME_CBOR_ERROR;
+    }
+    if (key == 4) {
+      result = oc_s_mode_frame_get_uint32(&map, &frame->sia);
+      if (result == OC_S_MODE_FRAME_OK &&
+          cbor_value_advance(&map) != CborNoError) {
+        result = OC_S_MODE_FRAME_CBOR_ERROR;
+      }
+    } else if (key == 5) {
+      // leaves the iterator after the inner map
+      result = oc_s_mode_decode_frame_cmd(&map, frame, &ga_found);
+    } else if (cbor_value_advance(&map) != CborNoError) {
+      result = OC_S_MODE_FRAME_CBOR_ERROR;
+    }
+    if (result != OC_S_MODE_FRAME_OK) {
+      return result;
+    }
+  }
+
+  if (frame->value &&
+      frame->value_len > (size_t)(payload + payload_len - frame->value)) {
+    // the value does not end inside the payload
+    return OC_S_MODE_FRAME_CBOR_ERROR;
+  }
+  if (frame->st == OC_S_MODE_ST_NONE) {
+    return OC_S_MODE_FRAME_MISSING_ST;
+  }
+  if (ga_found == false) {
+    return OC_S_MODE_FRAME_MISSING_GA;
+  }
+  if (frame->value == NULL && frame->st != OC_S_MODE_ST_READ) {
+    return OC_S_MODE_FRAME_MISSING_VALUE;
+  }
+  return OC_S_MODE_FRAME_OK;
+}
+
+const char *
+oc_s_mode_frame_error_str(oc_s_mode_frame_error_t error)
+{
+  switch (error) {
+  case OC_S_MODE_FRAME_OK:
+    return "ok";
+  case OC_S_MODE_FRAME_CBOR_ERROR:
+    return "invalid CBOR";
+  case OC_S_MODE_FRAME_NOT_A_MAP:
+    return "not a map";
+  case OC_S_MODE_FRAME_INVALID_TYPE:
+    return "invalid type";
+  case OC_S_MODE_FRAME_INVALID_ST:
+    return "invalid st";
+  case OC_S_MODE_FRAME_MISSING_GA:
+    return "missing ga";
+  case OC_S_MODE_FRAME_MISSING_ST:
+    return "missing st";
+  case OC_S_MODE_FRAME_MISSING_VALUE:
+    return "missing value";
+  }
+  return "unknown";
+}
+
+/* decodes the encoded value into storage, arrays and maps into reps of the
+ * current pool */
+static oc_rep_t *
+oc_s_mode_decode_value(const uint8_t *data, size_t len, oc_rep_t *storage)
+{
+  oc_rep_t *value = storage;
+  if (data == NULL || len == 0) {
+    return NULL;
+  }
+  CborError err = oc_parse_rep_scalar_value(data, (int)len, storage);
+  if (err == CborErrorUnsupportedType) {
+    value = NULL;
+    err = oc_parse_rep_single_value(data, (int)len, &value);
+  }
+  if (err != CborNoError) {
+    oc_s_mode_free_value(value, storage);
+    return NULL;
+  }
+  if (value) {
+    value->iname = 1;
+  }
+  return value;
+}
+
+oc_rep_t *
+oc_s_mode_frame_get_value(const oc_s_mode_frame_t *frame, oc_rep_t *storage)
+{
+  return oc_s_mode_decode_value(frame->value, frame->value_len, storage);
+}
+
 void
-oc_issue_s_mode(int scope, int sia_value, uint32_t grpid,
-                uint32_t group_address, uint64_t iid, char *rp,
-                uint8_t *value_data, int value_size)
+oc_s_mode_free_value(oc_rep_t *value, oc_rep_t *storage)
+{
+  if (value != storage) {
+    oc_free_rep(value);
+  }
+}
+
+static void
+oc_issue_s_mode_now(int scope, int sia_value, uint32_t grpid,
+                    uint32_t group_address, uint64_t iid, oc_s_mode_st_t st,
+                    oc_message_priority_t priority, const uint8_t *value_data,
+                    int value_size)
 {
   PRINT("  oc_issue_s_mode : scope %d\n", scope);
 
@@ -510,25 +773,385 @@ oc_issue_s_mode(int scope, int sia_value, uint32_t grpid,
 
 #else
   /* using group addressing */
-  oc_endpoint_t group_mcast;
-  memset(&group_mcast, 0, sizeof(group_mcast));
-  group_mcast =
-    oc_create_multicast_group_address(group_mcast, grpid, iid, scope);
+  oc_endpoint_t group_mcast =
+    *oc_get_multicast_group_address(grpid, iid, scope);
 #endif
   // set the group_address to the group address, since this field is used
   // to find the OSCORE context id
   group_mcast.group_address = group_address;
+  group_mcast.priority = priority;
 
   // new spec 1.1
-  oc_send_s_mode(&group_mcast, "/k", sia_value, group_address, rp, value_data,
+  oc_send_s_mode(&group_mcast, "/k", sia_value, group_address, st, value_data,
                  value_size);
 }
 
+// ----------------------------------------------------------------------------
+// s-mode send queue
+//
+// s-mode messages with the same (scope, group address, st) are sent at most
+// once per OC_S_MODE_MIN_INTERVAL_MS. a message issued within the interval is
+// kept in the queue and sent when the interval has passed. when a new message
+// with the same key is issued in the mean time, the queued value is replaced
+// by the latest value (coalesced).
+// OC_S_MODE_MIN_INTERVAL_MS = 0 disables the queue, e.g. messages are sent
+// immediately.
+// messages with high or system priority are never delayed, they replace the
+// queued message of the same key.
+// values larger than OC_S_MODE_MAX_VALUE_SIZE are copied to the heap while
+// they are queued.
+
+#ifndef OC_S_MODE_MIN_INTERVAL_MS
+#define OC_S_MODE_MIN_INTERVAL_MS (0)
+#endif
+
+#ifndef OC_S_MODE_QUEUE_SIZE
+#define OC_S_MODE_QUEUE_SIZE (8)
+#endif
+
+#define OC_S_MODE_MAX_VALUE_SIZE (50)
+
+typedef struct oc_s_mode_queue_entry_t
+{
+  int scope;                               /**< the multicast scope */
+  uint32_t group_address;                  /**< the group address */
+  oc_s_mode_st_t st;                       /**< the service type */
+  bool pending;                            /**< message waiting to be sent */
+  oc_clock_time_t last_sent;               /**< last sent time */
+  int sia_value;                           /**< sender individual address */
+  uint32_t grpid;                          /**< the multicast group id */
+  uint64_t iid;                            /**< installation id */
+  oc_message_priority_t priority;          /**< the message priority */
+  int value_size;                          /**< size of the value */
+  uint8_t value[OC_S_MODE_MAX_VALUE_SIZE]; /**< the latest value */
+  uint8_t *large_value;                    /**< heap copy of a large value */
+} oc_s_mode_queue_entry_t;
+
+static oc_s_mode_queue_entry_t g_s_mode_queue[OC_S_MODE_QUEUE_SIZE];
+static int g_s_mode_queue_len = 0;
+static bool g_s_mode_queue_scheduled = false;
+static oc_s_mode_queue_stats_t g_s_mode_queue_stats;
+
+static oc_event_callback_retval_t oc_s_mode_queue_flush_cb(void *data);
+
+/* drops the queued value, only the values of pending messages are kept */
+static void
+oc_s_mode_queue_entry_drop(oc_s_mode_queue_entry_t *entry)
+{
+  entry->pending = false;
+  free(entry->large_value);
+  entry->large_value = NULL;
+}
+
+/* stores a copy of the value, returns false when out of memory */
+static bool
+oc_s_mode_queue_entry_store(oc_s_mode_queue_entry_t *entry,
+                            const uint8_t *value_data, int value_size)
+{
+  uint8_t *value = entry->value;
+  if (value_size > OC_S_MODE_MAX_VALUE_SIZE) {
+    value = (uint8_t *)realloc(entry->large_value, value_size);
+    if (value == NULL) {
+      return false;
+    }
+    entry->large_value = value;
+  } else {
+    free(entry->large_value);
+    entry->large_value = NULL;
+  }
+  if (value_size > 0) {
+    memcpy(value, value_data, value_size);
+  }
+  entry->value_size = value_size;
+  return true;
+}
+
+static oc_clock_time_t
+oc_s_mode_queue_interval(void)
+{
+  return (oc_clock_time_t)OC_S_MODE_MIN_INTERVAL_MS * OC_CLOCK_SECOND / 1000;
+}
+
+/* schedules the flush for the first pending message */
+static void
+oc_s_mode_queue_schedule(oc_clock_time_t now)
+{
+  if (g_s_mode_queue_scheduled) {
+    return;
+  }
+  oc_clock_time_t next = 0;
+  bool found = false;
+  for (int i = 0; i < g_s_mode_queue_len; i++) {
+    oc_clock_time_t due =
+      g_s_mode_queue[i].last_sent + oc_s_mode_queue_interval();
+    if (g_s_mode_queue[i].pending && (!found || due < next)) {
+      next = due;
+      found = true;
+    }
+  }
+  if (found) {
+    g_s_mode_queue_scheduled = true;
+    oc_ri_add_timed_event_callback_ticks(NULL, oc_s_mode_queue_flush_cb,
+                                         next > now ? next - now : 0);
+  }
+}
+
+static oc_event_callback_retval_t
+oc_s_mode_queue_flush_cb(void *data)
+{
+  (void)data;
+  g_s_mode_queue_scheduled = false;
+  oc_clock_time_t now = oc_clock_time();
+  for (int i = 0; i < g_s_mode_queue_len; i++) {
+    oc_s_mode_queue_entry_t *entry = &g_s_mode_queue[i];
+    if (entry->pending &&
+        now - entry->last_sent >= oc_s_mode_queue_interval()) {
+      entry->last_sent = now;
+      g_s_mode_queue_stats.sent++;
+      oc_issue_s_mode_now(
+        entry->scope, entry->sia_value, entry->grpid, entry->group_address,
+        entry->iid, entry->st, entry->priority,
+        entry->large_value ? entry->large_value : entry->value,
+        entry->value_size);
+      oc_s_mode_queue_entry_drop(entry);
+    }
+  }
+  oc_s_mode_queue_schedule(now);
+  return OC_EVENT_DONE;
+}
+
+/* returns the queue entry of the key, or a new (reused) entry */
+static oc_s_mode_queue_entry_t *
+oc_s_mode_queue_get_entry(int scope, uint32_t group_address,
+                          oc_s_mode_st_t st, oc_clock_time_t now)
+{
+  oc_s_mode_queue_entry_t *entry = NULL;
+  for (int i = 0; i < g_s_mode_queue_len; i++) {
+    if (g_s_mode_queue[i].scope == scope &&
+        g_s_mode_queue[i].group_address == group_address &&
+        g_s_mode_queue[i].st == st) {
+      return &g_s_mode_queue[i];
+    }
+  }
+  if (g_s_mode_queue_len < OC_S_MODE_QUEUE_SIZE) {
+    entry = &g_s_mode_queue[g_s_mode_queue_len++];
+  } else {
+    // reuse the entry that has not been used for the longest time
+    for (int i = 0; i < g_s_mode_queue_len; i++) {
+      if (!g_s_mode_queue[i].pending &&
+          (entry == NULL || g_s_mode_queue[i].last_sent < entry->last_sent)) {
+        entry = &g_s_mode_queue[i];
+      }
+    }
+    if (entry == NULL) {
+      return NULL;
+    }
+  }
+  memset(entry, 0, sizeof(oc_s_mode_queue_entry_t));
+  entry->scope = scope;
+  entry->group_address = group_address;
+  entry->st = st;
+  entry->last_sent = now - oc_s_mode_queue_interval();
+  return entry;
+}
+
+/* returns true when the message is queued, false when it should be sent */
+static bool
+oc_s_mode_queue_add(int scope, int sia_value, uint32_t grpid,
+                    uint32_t group_address, uint64_t iid, oc_s_mode_st_t st,
+                    oc_message_priority_t priority, const uint8_t *value_data,
+                    int value_size)
+{
+  if (OC_S_MODE_MIN_INTERVAL_MS == 0) {
+    return false;
+  }
+  oc_clock_time_t now = oc_clock_time();
+  oc_s_mode_queue_entry_t *entry =
+    oc_s_mode_queue_get_entry(scope, group_address, st, now);
+  if (entry == NULL) {
+    // queue is full with pending messages
+    return false;
+  }
+  if (priority == OC_MESSAGE_PRIORITY_HIGH ||
+      priority == OC_MESSAGE_PRIORITY_SYSTEM) {
+    // send now, a queued older value is dropped
+    oc_s_mode_queue_entry_drop(entry);
+    entry->last_sent = now;
+    return false;
+  }
+  if (!entry->pending &&
+      now - entry->last_sent >= oc_s_mode_queue_interval()) {
+    entry->last_sent = now;
+    return false;
+  }
+  if (!oc_s_mode_queue_entry_store(entry, value_data, value_size)) {
+    // no memory to keep the value, send it now
+    oc_s_mode_queue_entry_drop(entry);
+    entry->last_sent = now;
+    return false;
+  }
+  if (entry->pending) {
+    PRINT("  oc_issue_s_mode : ga %u st %s coalesced\n", group_address,
+          oc_s_mode_st_to_string(st));
+    g_s_mode_queue_stats.coalesced++;
+  } else {
+    PRINT("  oc_issue_s_mode : ga %u st %s delayed\n", group_address,
+          oc_s_mode_st_to_string(st));
+    g_s_mode_queue_stats.delayed++;
+  }
+  entry->pending = true;
+  entry->sia_value = sia_value;
+  entry->grpid = grpid;
+  entry->iid = iid;
+  entry->priority = priority;
+  oc_s_mode_queue_schedule(now);
+  return true;
+}
+
+const oc_s_mode_queue_stats_t *
+oc_s_mode_queue_get_stats(void)
+{
+  return &g_s_mode_queue_stats;
+}
+
+static void
+oc_issue_s_mode_st(int scope, int sia_value, uint32_t grpid,
+                   uint32_t group_address, uint64_t iid, oc_s_mode_st_t st,
+                   oc_message_priority_t priority, const uint8_t *value_data,
+                   int value_size)
+{
+  if (oc_s_mode_queue_add(scope, sia_value, grpid, group_address, iid, st,
+                          priority, value_data, value_size)) {
+    return;
+  }
+  g_s_mode_queue_stats.sent++;
+  oc_issue_s_mode_now(scope, sia_value, grpid, group_address, iid, st,
+                      priority, value_data, value_size);
+}
+
+void
+oc_issue_s_mode(int scope, int sia_value, uint32_t grpid,
+                uint32_t group_address, uint64_t iid, char *rp,
+                uint8_t *value_data, int value_size)
+{
+  oc_issue_s_mode_st(scope, sia_value, grpid, group_address, iid,
+                     oc_s_mode_st_from_string(rp), OC_MESSAGE_PRIORITY_NORMAL,
+                     value_data, value_size);
+}
+
+// ----------------------------------------------------------------------------
+// s-mode frame templates
+//
+// the payload { 4: <sia>, 5: { 7: <ga>, 6: <st>, 1: <value> } } only differs
+// in the value for a given (sia, ga, st). the encoded part in front of the
+// value is cached, so that sending copies the template and the value instead
+// of encoding the whole payload.
+
+#ifndef OC_S_MODE_TEMPLATE_CACHE_SIZE
+#define OC_S_MODE_TEMPLATE_CACHE_SIZE (8)
+#endif
+
+// map(1) + key(1) + sia(5) + key(1) + map(1) + key(1) + ga(5) + key(1) + st(3)
+#define OC_S_MODE_TEMPLATE_MAX_SIZE (19)
+
+typedef struct oc_s_mode_template_t
+{
+  uint32_t sia;                              /**< sender individual address */
+  uint32_t ga;                               /**< group address */
+  oc_s_mode_st_t st;                         /**< service type */
+  uint8_t len;                               /**< length of data */
+  uint8_t data[OC_S_MODE_TEMPLATE_MAX_SIZE]; /**< encoded payload up to the
+                                                  value */
+} oc_s_mode_template_t;
+
+static oc_s_mode_template_t g_s_mode_templates[OC_S_MODE_TEMPLATE_CACHE_SIZE];
+static int g_s_mode_templates_next = 0;
+
+/* returns the cached template, the template is created if needed */
+static const oc_s_mode_template_t *
+oc_s_mode_get_template(uint32_t sia_value, uint32_t group_address,
+                       oc_s_mode_st_t st)
+{
+  CborEncoder encoder, root, value;
+  CborError err = CborNoError;
+  const char *st_str = oc_s_mode_st_to_string(st);
+
+  for (int i = 0; i < OC_S_MODE_TEMPLATE_CACHE_SIZE; i++) {
+    oc_s_mode_template_t *t = &g_s_mode_templates[i];
+    if (t->len > 0 && t->sia == sia_value && t->ga == group_address &&
+        t->st == st) {
+      return t;
+    }
+  }
+
+  // replace the oldest template
+  oc_s_mode_template_t *t = &g_s_mode_templates[g_s_mode_templates_next];
+  g_s_mode_templates_next =
+    (g_s_mode_templates_next + 1) % OC_S_MODE_TEMPLATE_CACHE_SIZE;
+  memset(t, 0, sizeof(oc_s_mode_template_t));
+
+  // same encoding as oc_send_s_mode, without closing the maps
+  cbor_encoder_init(&encoder, t->data, sizeof(t->data), 0);
+  err |= cbor_encoder_create_map(&encoder, &root, CborIndefiniteLength);
+  err |= cbor_encode_int(&root, 4);
+  err |= cbor_encode_int(&root, sia_value);
+  err |= cbor_encode_int(&root, 5);
+  err |= cbor_encoder_create_map(&root, &value, CborIndefiniteLength);
+  err |= cbor_encode_int(&value, 7);
+  err |= cbor_encode_int(&value, group_address);
+  err |= cbor_encode_int(&value, 6);
+  err |= cbor_encode_text_string(&value, st_str, strlen(st_str));
+  if (err != CborNoError) {
+    return NULL;
+  }
+  t->sia = sia_value;
+  t->ga = group_address;
+  t->st = st;
+  t->len = (uint8_t)cbor_encoder_get_buffer_size(&value, t->data);
+  return t;
+}
+
+/* encodes the s-mode payload in the request */
+static void
+oc_s_mode_encode_frame(uint32_t sia_value, uint32_t group_address,
+                       oc_s_mode_st_t st, const uint8_t *value_data,
+                       int value_size)
+{
+  oc_rep_begin_root_object();
+
+  oc_rep_i_set_int(root, 4, sia_value);
+
+  oc_rep_i_set_key(&root_map, 5);
+  CborEncoder value_map;
+  cbor_encoder_create_map(&root_map, &value_map, CborIndefiniteLength);
+
+  // ga
+  oc_rep_i_set_int(value, 7, group_address);
+  // st M Service type code(write = w, read = r, response = a)
+  // Enum : w, r, a (rp)
+  oc_rep_i_set_text_string(value, 6, oc_s_mode_st_to_string(st));
+
+  // set the "value" key
+  // copy the data, this is the encoded value (without the { 1 : } of the
+  // resource GET function), see oc_s_mode_get_resource_value
+  if (value_size > 0) {
+    oc_rep_i_set_key(&value_map, 1);
+    oc_rep_encode_raw_encoder(&value_map, value_data, value_size);
+  }
+
+  cbor_encoder_close_container_checked(&root_map, &value_map);
+
+  oc_rep_end_root_object();
+}
+
 static void
 oc_send_s_mode(oc_endpoint_t *endpoint, char *path, uint32_t sia_value,
-               uint32_t group_address, char *rp, uint8_t *value_data,
-               int value_size)
+               uint32_t group_address, oc_s_mode_st_t st,
+               const uint8_t *value_data, int value_size)
 {
+  // key 1 of the value, and the end of both (indefinite length) maps
+  static const uint8_t value_key[] = { 0x01 };
+  static const uint8_t end_maps[] = { 0xff, 0xff };
   char token[8];
 
   PRINT("  oc_send_s_mode : \n");
@@ -547,35 +1170,23 @@ oc_send_s_mode(oc_endpoint_t *endpoint, char *path, uint32_t sia_value,
     /*
     { 4: <sia>, 5: { 6: <st>, 7: <ga>, 1: <value> } }
     */
-
-    oc_rep_begin_root_object();
-
-    oc_rep_i_set_int(root, 4, sia_value);
-
-    oc_rep_i_set_key(&root_map, 5);
-    CborEncoder value_map;
-    cbor_encoder_create_map(&root_map, &value_map, CborIndefiniteLength);
-
-    // ga
-    oc_rep_i_set_int(value, 7, group_address);
-    // st M Service type code(write = w, read = r, response = a)
-    // Enum : w, r, a (rp)
-    oc_rep_i_set_text_string(value, 6, rp);
-
-    // set the "value" key
-    // oc_rep_i_set_key(&value_map, 1);
-    // copy the data, this is already in cbor from the fake response of the
-    // resource GET function
-    // the GET function retrieves the data = { 1 : <value> } e.g including
-    // the open/close object data. hence this needs to be removed.
-    if (value_size > 2) {
-      oc_rep_encode_raw_encoder(&value_map, &value_data[1], value_size - 2);
+    const oc_s_mode_template_t *frame_template =
+      oc_s_mode_get_template(sia_value, group_address, st);
+    size_t available = (size_t)(g_encoder.end - g_encoder.data.ptr);
+    if (frame_template &&
+        available >= frame_template->len + sizeof(value_key) +
+                       (size_t)value_size + sizeof(end_maps)) {
+      oc_rep_encode_raw(frame_template->data, frame_template->len);
+      if (value_size > 0) {
+        oc_rep_encode_raw(value_key, sizeof(value_key));
+        oc_rep_encode_raw(value_data, value_size);
+      }
+      oc_rep_encode_raw(end_maps, sizeof(end_maps));
+    } else {
+      oc_s_mode_encode_frame(sia_value, group_address, st, value_data,
+                             value_size);
     }
 
-    cbor_encoder_close_container_checked(&root_map, &value_map);
-
-    oc_rep_end_root_object();
-
     PRINT("oc_send_s_mode: S-MODE Payload Size: %d\n",
           oc_rep_get_encoded_payload_size());
     OC_LOGbytes_OSCORE(oc_rep_get_encoder_buf(),
@@ -594,22 +1205,308 @@ oc_send_s_mode(oc_endpoint_t *endpoint, char *path, uint32_t sia_value,
   }
 }
 
+// ----------------------------------------------------------------------------
+// data point value store
+//
+// opt-in: the application publishes the current (CBOR encoded) value of a
+// data point. the s-mode sender uses the published value instead of calling
+// the GET handler of the resource, for data points that are not published
+// the GET handler is still used.
+
+#ifndef OC_S_MODE_VALUE_STORE_SIZE
+#define OC_S_MODE_VALUE_STORE_SIZE (16)
+#endif
+
+typedef struct oc_s_mode_value_t
+{
+  const oc_resource_t *resource; /**< the data point, NULL if not used */
+  uint8_t *value;                /**< the encoded value */
+  size_t value_len;              /**< length of the encoded value */
+  size_t value_alloc;            /**< allocated size of value */
+} oc_s_mode_value_t;
+
+static oc_s_mode_value_t g_s_mode_values[OC_S_MODE_VALUE_STORE_SIZE];
+
+static oc_s_mode_value_t *
+oc_s_mode_find_value(const oc_resource_t *resource)
+{
+  for (int i = 0; i < OC_S_MODE_VALUE_STORE_SIZE; i++) {
+    if (g_s_mode_values[i].resource == resource) {
+      return &g_s_mode_values[i];
+    }
+  }
+  return NULL;
+}
+
+bool
+oc_s_mode_publish_value(const char *resource_url, const uint8_t *value,
+                        size_t value_len)
+{
+  CborParser parser;
+  CborValue item;
+
+  if (resource_url == NULL || value == NULL || value_len == 0) {
+    return false;
+  }
+  // the value must be exactly one data item
+  if (cbor_parser_init(value, value_len, 0, &parser, &item) != CborNoError ||
+      cbor_value_advance(&item) != CborNoError ||
+      cbor_value_get_next_byte(&item) != value + value_len) {
+    OC_ERR("oc_s_mode_publish_value: invalid value for %s", resource_url);
+    return false;
+  }
+  const oc_resource_t *resource =
+    oc_ri_get_app_resource_by_uri(resource_url, strlen(resource_url), 0);
+  if (resource == NULL) {
+    OC_ERR("oc_s_mode_publish_value: no URL found %s", resource_url);
+    return false;
+  }
+  oc_s_mode_value_t *entry = oc_s_mode_find_value(resource);
+  if (entry == NULL) {
+    entry = oc_s_mode_find_value(NULL);
+    if (entry == NULL) {
+      OC_ERR("oc_s_mode_publish_value: store full");
+      return false;
+    }
+  }
+  if (entry->value_alloc < value_len) {
+    uint8_t *new_value = malloc(value_len);
+    if (new_value == NULL) {
+      return false;
+    }
+    free(entry->value);
+    entry->value = new_value;
+    entry->value_alloc = value_len;
+  }
+  memcpy(entry->value, value, value_len);
+  entry->value_len = value_len;
+  entry->resource = resource;
+  return true;
+}
+
+bool
+oc_s_mode_publish_bool(const char *resource_url, bool value)
+{
+  uint8_t buf[1];
+  CborEncoder encoder;
+  cbor_encoder_init(&encoder, buf, sizeof(buf), 0);
+  if (cbor_encode_boolean(&encoder, value) != CborNoError) {
+    return false;
+  }
+  return oc_s_mode_publish_value(resource_url, buf,
+                                 cbor_encoder_get_buffer_size(&encoder, buf));
+}
+
+bool
+oc_s_mode_publish_int(const char *resource_url, int64_t value)
+{
+  uint8_t buf[9];
+  CborEncoder encoder;
+  cbor_encoder_init(&encoder, buf, sizeof(buf), 0);
+  if (cbor_encode_int(&encoder, value) != CborNoError) {
+    return false;
+  }
+  return oc_s_mode_publish_value(resource_url, buf,
+                                 cbor_encoder_get_buffer_size(&encoder, buf));
+}
+
+bool
+oc_s_mode_publish_double(const char *resource_url, double value)
+{
+  uint8_t buf[9];
+  CborEncoder encoder;
+  cbor_encoder_init(&encoder, buf, sizeof(buf), 0);
+  if (cbor_encode_double(&encoder, value) != CborNoError) {
+    return false;
+  }
+  return oc_s_mode_publish_value(resource_url, buf,
+                                 cbor_encoder_get_buffer_size(&encoder, buf));
+}
+
+void
+oc_s_mode_unpublish_value(const char *resource_url)
+{
+  if (resource_url == NULL) {
+    return;
+  }
+  const oc_resource_t *resource =
+    oc_ri_get_app_resource_by_uri(resource_url, strlen(resource_url), 0);
+  oc_s_mode_value_t *entry = resource ? oc_s_mode_find_value(resource) : NULL;
+  if (entry) {
+    free(entry->value);
+    memset(entry, 0, sizeof(oc_s_mode_value_t));
+  }
+}
+
+bool
+oc_s_mode_is_value_published(const oc_resource_t *resource)
+{
+  return resource != NULL && oc_s_mode_find_value(resource) != NULL;
+}
+
+// ----------------------------------------------------------------------------
+// data point priorities
+//
+// the priority of the s-mode messages of a data point, the priority is used
+// for all group object table entries of the data point. data points that are
+// not in the list are sent with normal priority.
+
+#ifndef OC_S_MODE_PRIORITY_SIZE
+#define OC_S_MODE_PRIORITY_SIZE (8)
+#endif
+
+typedef struct oc_s_mode_priority_t
+{
+  const oc_resource_t *resource;  /**< the data point */
+  oc_message_priority_t priority; /**< the priority of the data point */
+} oc_s_mode_priority_t;
+
+static oc_s_mode_priority_t g_s_mode_priorities[OC_S_MODE_PRIORITY_SIZE];
+
+bool
+oc_s_mode_set_priority(const char *resource_url,
+                       oc_message_priority_t priority)
+{
+  if (resource_url == NULL) {
+    return false;
+  }
+  const oc_resource_t *resource =
+    oc_ri_get_app_resource_by_uri(resource_url, strlen(resource_url), 0);
+  if (resource == NULL) {
+    OC_ERR("oc_s_mode_set_priority: no resource %s", resource_url);
+    return false;
+  }
+  oc_s_mode_priority_t *free_entry = NULL;
+  for (int i = 0; i < OC_S_MODE_PRIORITY_SIZE; i++) {
+    if (g_s_mode_priorities[i].resource == resource) {
+      g_s_mode_priorities[i].priority = priority;
+      if (priority == OC_MESSAGE_PRIORITY_NORMAL) {
+        g_s_mode_priorities[i].resource = NULL;
+      }
+      return true;
+    }
+    if (free_entry == NULL && g_s_mode_priorities[i].resource == NULL) {
+      free_entry = &g_s_mode_priorities[i];
+    }
+  }
+  if (priority == OC_MESSAGE_PRIORITY_NORMAL) {
+    return true;
+  }
+  if (free_entry == NULL) {
+    OC_ERR("oc_s_mode_set_priority: no free entry for %s", resource_url);
+    return false;
+  }
+  free_entry->resource = resource;
+  free_entry->priority = priority;
+  return true;
+}
+
+oc_message_priority_t
+oc_s_mode_get_priority(const char *resource_url)
+{
+  if (resource_url == NULL) {
+    return OC_MESSAGE_PRIORITY_NORMAL;
+  }
+  const oc_resource_t *resource =
+    oc_ri_get_app_resource_by_uri(resource_url, strlen(resource_url), 0);
+  if (resource == NULL) {
+    return OC_MESSAGE_PRIORITY_NORMAL;
+  }
+  for (int i = 0; i < OC_S_MODE_PRIORITY_SIZE; i++) {
+    if (g_s_mode_priorities[i].resource == resource) {
+      return g_s_mode_priorities[i].priority;
+    }
+  }
+  return OC_MESSAGE_PRIORITY_NORMAL;
+}
+
+void
+oc_s_mode_resource_deleted(const oc_resource_t *resource)
+{
+  if (resource == NULL) {
+    return;
+  }
+  oc_s_mode_value_t *entry = oc_s_mode_find_value(resource);
+  if (entry) {
+    free(entry->value);
+    memset(entry, 0, sizeof(oc_s_mode_value_t));
+  }
+  for (int i = 0; i < OC_S_MODE_PRIORITY_SIZE; i++) {
+    if (g_s_mode_priorities[i].resource == resource) {
+      g_s_mode_priorities[i].resource = NULL;
+    }
+  }
+}
+
+/* returns the encoded value (the data item of key 1) of the GET response
+ * { 1 : <value> } in buf, moved to the start of buf */
 static int
-oc_s_mode_get_resource_value(const char *resource_url, char *rp, uint8_t *buf,
-                             int buf_size)
+oc_s_mode_extract_value(uint8_t *buf, int len)
+{
+  CborParser parser;
+  CborValue root, map;
+  int key;
+
+  if (cbor_parser_init(buf, len, 0, &parser, &root) != CborNoError ||
+      !cbor_value_is_map(&root) ||
+      cbor_value_enter_container(&root, &map) != CborNoError) {
+    return 0;
+  }
+  while (!cbor_value_at_end(&map)) {
+    if (oc_s_mode_frame_get_key(&map, &key) != CborNoError) {
+      return 0;
+    }
+    const uint8_t *start = cbor_value_get_next_byte(&map);
+    if (cbor_value_advance(&map) != CborNoError) {
+      return 0;
+    }
+    if (key == 1) {
+      int size = (int)(cbor_value_get_next_byte(&map) - start);
+      memmove(buf, start, size);
+      return size;
+    }
+  }
+  return 0;
+}
+
+/* returns the encoded value of the resource, e.g. the data item without the
+ * { 1 : } of the GET response.
+ * the published value (oc_s_mode_publish_value) is used if available,
+ * otherwise the GET handler of the resource is called.
+ * returns buf, or an allocated copy if the published value does not fit in
+ * buf, the caller needs to free the returned value if it is not buf */
+static uint8_t *
+oc_s_mode_get_resource_value(const char *resource_url, uint8_t *buf,
+                             int buf_size, int *value_size)
 {
-  (void)rp;
   uint8_t buffer[50];
 
+  *value_size = 0;
   if (resource_url == NULL) {
-    return 0;
+    return buf;
   }
 
   const oc_resource_t *my_resource =
     oc_ri_get_app_resource_by_uri(resource_url, strlen(resource_url), 0);
   if (my_resource == NULL) {
     PRINT(" oc_do_s_mode : error no URL found %s\n", resource_url);
-    return 0;
+    return buf;
+  }
+
+  // copy the published value, the store can be updated by the PUT handlers
+  // that are called while sending
+  oc_s_mode_value_t *published = oc_s_mode_find_value(my_resource);
+  if (published != NULL) {
+    uint8_t *value = buf;
+    if ((int)published->value_len > buf_size) {
+      value = malloc(published->value_len);
+      if (value == NULL) {
+        return buf;
+      }
+    }
+    memcpy(value, published->value, published->value_len);
+    *value_size = (int)published->value_len;
+    return value;
   }
 
   oc_request_t request = { 0 };
@@ -651,16 +1548,17 @@ oc_s_mode_get_resource_value(const char *resource_url, char *rp, uint8_t *buf,
                               my_resource->get_handler.user_data);
 
   // get the data
-  int value_size = oc_rep_get_encoded_payload_size();
+  int payload_size = oc_rep_get_encoded_payload_size();
   uint8_t *value_data = request.response->response_buffer->buffer;
 
   // Cache value data, as it gets overwritten in oc_issue_do_s_mode
-  if (value_size < buf_size) {
-    memcpy(buf, value_data, value_size);
-    return value_size;
+  if (payload_size < buf_size) {
+    memcpy(buf, value_data, payload_size);
+    *value_size = oc_s_mode_extract_value(buf, payload_size);
+    return buf;
   }
   OC_ERR(" allocated buffer too small to contain s-mode value");
-  return 0;
+  return buf;
 }
 
 void
@@ -679,44 +1577,81 @@ oc_do_s_mode_read(int64_t group_address)
   grpid = oc_find_grpid_in_recipient_table(group_address);
   if (grpid > 0) {
 #ifdef OC_USE_MULTICAST_SCOPE_2
-    oc_issue_s_mode(2, sia_value, grpid, group_address, iid, "r", 0, 0);
+    oc_issue_s_mode_st(2, sia_value, grpid, group_address, iid,
+                       OC_S_MODE_ST_READ, OC_MESSAGE_PRIORITY_NORMAL, 0, 0);
 #endif
-    oc_issue_s_mode(5, sia_value, grpid, group_address, iid, "r", 0, 0);
+    oc_issue_s_mode_st(5, sia_value, grpid, group_address, iid,
+                       OC_S_MODE_ST_READ, OC_MESSAGE_PRIORITY_NORMAL, 0, 0);
   } else if (group_address > 0) {
 
 #ifdef OC_USE_MULTICAST_SCOPE_2
-    oc_issue_s_mode(2, sia_value, group_address, group_address, iid, "r", 0, 0);
+    oc_issue_s_mode_st(2, sia_value, group_address, group_address, iid,
+                       OC_S_MODE_ST_READ, OC_MESSAGE_PRIORITY_NORMAL, 0, 0);
 #endif
-    oc_issue_s_mode(5, sia_value, group_address, group_address, iid, "r", 0, 0);
+    oc_issue_s_mode_st(5, sia_value, group_address, group_address, iid,
+                       OC_S_MODE_ST_READ, OC_MESSAGE_PRIORITY_NORMAL, 0, 0);
+  }
+}
+
+/* local loopback: the device does not handle its own s-mode messages, hence
+ * the value sent on the group address is handed to the other group objects
+ * of this device with the same group address and the "w" flag.
+ * the value is decoded once by the caller and shared by all group objects.
+ * a logical send is issued on scope 5 and, with OC_USE_MULTICAST_SCOPE_2,
+ * also on scope 2: the value is delivered with the scope 5 copy only */
+#define OC_S_MODE_LOCAL_SCOPE (5)
+
+static void
+oc_s_mode_deliver_local(int index, uint32_t group_address, size_t device,
+                        oc_rep_t *value)
+{
+  if (value == NULL) {
+    return;
+  }
+  int pos = 0;
+  oc_group_object_dispatch_t scan_entry;
+  const oc_group_object_dispatch_t *entry;
+  while ((entry = oc_core_next_group_object_table_dispatch(
+            group_address, device, &pos, &scan_entry)) != NULL) {
+    const oc_resource_t *other_resource = entry->resource;
+    if (entry->index == index || other_resource == NULL ||
+        (entry->cflags & OC_CFLAG_WRITE) == 0 ||
+        other_resource->put_handler.cb == NULL) {
+      continue;
+    }
+    // Update the resource internally
+    oc_request_t new_request;
+    memset(&new_request, 0, sizeof(oc_request_t));
+    new_request.request_payload = value;
+    new_request.uri_path = entry->href;
+    new_request.uri_path_len = strlen(entry->href);
+
+    other_resource->put_handler.cb(&new_request, OC_IF_NONE,
+                                   other_resource->put_handler.user_data);
   }
 }
 
 // note: this function does not check the transmit flag
 // the caller of this function needs to check if the flag is set.
-void
-oc_do_s_mode_with_scope_and_check(int scope, const char *resource_url, char *rp,
-                                  bool check)
+static void
+oc_do_s_mode_st_and_check(int scope, const char *resource_url,
+                          oc_s_mode_st_t st, oc_message_priority_t priority,
+                          bool check, bool local)
 {
+  const char *rp = oc_s_mode_st_to_string(st);
   PRINT("oc_do_s_mode_with_scope_and_check\nscope = %d\nurl = %s\nrp=%s\n",
         scope, resource_url, rp);
   int value_size;
-  bool error = true;
   uint8_t buffer[50];
+  uint8_t *value_data;
+  oc_rep_t *local_value = NULL;
+  oc_rep_t local_storage;
+  struct oc_memb rep_objects = { sizeof(oc_rep_t), 0, 0, 0, 0 };
+  struct oc_memb *caller_rep_objects = oc_rep_get_pool();
 
   // do the checks
-  if (strcmp(rp, "w") == 0) {
-    error = false;
-  } else if (strcmp(rp, "r") == 0) {
-    error = false;
-  } else if (strcmp(rp, "a") == 0) {
-    // spec 1.1
-    error = false;
-  } else if (strcmp(rp, "rp") == 0) {
-    // spec 1.0
-    error = false;
-  }
-  if (error) {
-    OC_ERR("oc_do_s_mode_with_scope_internal : rp value incorrect %s", rp);
+  if (st == OC_S_MODE_ST_NONE) {
+    OC_ERR("oc_do_s_mode_with_scope_internal : rp value incorrect");
     return;
   }
 
@@ -751,21 +1686,24 @@ oc_do_s_mode_with_scope_and_check(int scope, const char *resource_url, char *rp,
 
   oc_notify_observers(my_resource);
 
-  value_size = oc_s_mode_get_resource_value(resource_url, rp, buffer, 50);
-
   // get the sender ia
   uint32_t sia_value = device->ia;
   uint64_t iid = device->iid;
   uint32_t group_address = 0;
 
   // loop over all group addresses and issue the s-mode command
-  int index = oc_core_find_group_object_table_url(resource_url);
-  if (index == -1) {
+  int nr_entries = 0;
+  const int *indices =
+    oc_core_get_group_object_table_indices(my_resource, &nr_entries);
+  if (indices == NULL) {
     PRINT(" oc_do_s_mode_with_scope_internal : no table entry found for %s\n",
           resource_url);
     return;
   }
-  while (index != -1) {
+  value_data = oc_s_mode_get_resource_value(resource_url, buffer,
+                                            sizeof(buffer), &value_size);
+  for (int k = 0; k < nr_entries; k++) {
+    int index = indices[k];
     int ga_len = oc_core_find_group_object_table_number_group_entries(index);
     oc_cflag_mask_t cflags = oc_core_group_object_table_cflag_entries(index);
 
@@ -789,78 +1727,43 @@ oc_do_s_mode_with_scope_and_check(int scope, const char *resource_url, char *rp,
       for (int j = 0; j < ga_len; j++) {
         group_address = oc_core_find_group_object_table_group_entry(index, j);
         PRINT("      ga : %lu\n", group_address);
-        if (strcmp(rp, "a") == 0 || strcmp(rp, "rp") == 0) {
-          // Check if any other GOT entries have the same GA with "w" flag
+        if (j == 0 && local && scope == OC_S_MODE_LOCAL_SCOPE &&
+            st != OC_S_MODE_ST_READ) {
+          // update the other GOT entries that have the sent GA with "w" flag
           PRINT("Checking & updating internal group objects\n");
-          int other_index =
-            oc_core_find_group_object_table_index(group_address);
-          while (other_index != -1) {
-            if (other_index != index) {
-              oc_cflag_mask_t other_cflags =
-                oc_core_group_object_table_cflag_entries(other_index);
-              oc_string_t other_url =
-                oc_core_find_group_object_table_url_from_index(other_index);
-              const char *other_url_char = oc_string(other_url);
-              const oc_resource_t *other_resource =
-                oc_ri_get_app_resource_by_uri(other_url_char,
-                                              strlen(other_url_char), 0);
-              if (other_resource == NULL) {
-                other_index = oc_core_find_next_group_object_table_index(
-                  group_address, other_index);
-                continue;
-              }
-              if ((other_cflags & OC_CFLAG_WRITE) &&
-                  other_resource->put_handler.cb) {
-                // Update the resource internally
-                oc_request_t new_request;
-                memset(&new_request, 0, sizeof(oc_request_t));
-
-                oc_rep_t *rep;
-                struct oc_memb rep_objects = { sizeof(oc_rep_t), 0, 0, 0, 0 };
-                oc_rep_set_pool(&rep_objects);
-                oc_parse_rep(buffer, value_size, &rep);
-
-                new_request.request_payload = rep;
-                new_request.uri_path = other_url_char;
-                new_request.uri_path_len = strlen(other_url_char);
-
-                other_resource->put_handler.cb(
-                  &new_request, OC_IF_NONE,
-                  other_resource->put_handler.user_data);
-              }
-            }
-
-            other_index = oc_core_find_next_group_object_table_index(
-              group_address, other_index);
+          if (local_value == NULL) {
+            // decode the value once, for all local group objects
+            oc_rep_set_pool(&rep_objects);
+            local_value = oc_s_mode_decode_value(value_data, value_size,
+                                                 &local_storage);
           }
+          oc_s_mode_deliver_local(index, group_address, device_index,
+                                  local_value);
         }
         if (j == 0) {
           // issue the s-mode command, but only for the first ga entry
           uint32_t grpid = oc_find_grpid_in_recipient_table(group_address);
           if (grpid > 0) {
-            oc_issue_s_mode(scope, sia_value, grpid, group_address, iid, rp,
-                            buffer, value_size);
+            oc_issue_s_mode_st(scope, sia_value, grpid, group_address, iid,
+                               st, priority, value_data, value_size);
           } else {
             // send to group address in multicast address
-            oc_issue_s_mode(scope, sia_value, group_address, group_address, iid,
-                            rp, buffer, value_size);
+            oc_issue_s_mode_st(scope, sia_value, group_address, group_address,
+                               iid, st, priority, value_data, value_size);
           }
         }
         // the recipient table contains the list of destinations that will
-        // receive data. loop over the full recipient table and send a message
-        // if the group is there
-        for (int jr = 0; jr < oc_core_get_recipient_table_size(); jr++) {
-          bool found =
-            oc_core_check_recipient_index_on_group_address(jr, group_address);
-          if (found) {
-            char *url = oc_core_get_recipient_index_url_or_path(jr);
-            if (url) {
-              PRINT(" broker send: %s\n", url);
-              uint32_t ia = oc_core_get_recipient_ia(jr);
-              if (ia > 0) {
-                // ia == 0 is reserved, so only send with ia > 0
-                oc_knx_client_do_broker_request(resource_url, iid, ia, url, rp);
-              }
+        // receive data. send a message to all recipients of the group
+        int jr = oc_core_find_recipient_table_index(group_address);
+        for (; jr != -1;
+             jr = oc_core_find_next_recipient_table_index(group_address, jr)) {
+          char *url = oc_core_get_recipient_index_url_or_path(jr);
+          if (url) {
+            PRINT(" broker send: %s\n", url);
+            uint32_t ia = oc_core_get_recipient_ia(jr);
+            if (ia > 0) {
+              // ia == 0 is reserved, so only send with ia > 0
+              oc_knx_client_do_broker_request(resource_url, iid, ia, url, st);
             }
           }
         }
@@ -868,10 +1771,30 @@ oc_do_s_mode_with_scope_and_check(int scope, const char *resource_url, char *rp,
     } else {
       PRINT("    not send due to flags\n");
     }
-    /* cflag */
-    index = oc_core_find_next_group_object_table_url(resource_url, index);
   }
+  if (local_value) {
+    oc_rep_set_pool(&rep_objects);
+    oc_s_mode_free_value(local_value, &local_storage);
+  }
+  // the pool of the caller, e.g. of a request that is being handled
+  oc_rep_set_pool(caller_rep_objects);
+  if (value_data != buffer) {
+    free(value_data);
+  }
+}
+void
+oc_do_s_mode_with_scope_and_check(int scope, const char *resource_url, char *rp,
+                                  bool check)
+{
+  oc_s_mode_st_t st = oc_s_mode_st_from_string(rp);
+  if (st == OC_S_MODE_ST_NONE) {
+    OC_ERR("oc_do_s_mode_with_scope_internal : rp value incorrect %s", rp);
+    return;
+  }
+  oc_do_s_mode_st_and_check(scope, resource_url, st,
+                            oc_s_mode_get_priority(resource_url), check, true);
 }
+
 // note: this function does not check the transmit flag
 // the caller of this function needs to check if the flag is set.
 void
@@ -887,6 +1810,37 @@ oc_do_s_mode_with_scope(int scope, const char *resource_url, char *rp)
   oc_do_s_mode_with_scope_and_check(scope, resource_url, rp, true);
 }
 
+void
+oc_do_s_mode_st_no_check(int scope, const char *resource_url,
+                         oc_s_mode_st_t st)
+{
+  oc_do_s_mode_st_and_check(scope, resource_url, st,
+                            oc_s_mode_get_priority(resource_url), false, true);
+}
+
+void
+oc_do_s_mode_st(int scope, const char *resource_url, oc_s_mode_st_t st)
+{
+  oc_do_s_mode_st_and_check(scope, resource_url, st,
+                            oc_s_mode_get_priority(resource_url), true, true);
+}
+
+void
+oc_do_s_mode_st_no_loopback(int scope, const char *resource_url,
+                            oc_s_mode_st_t st)
+{
+  oc_do_s_mode_st_and_check(scope, resource_url, st,
+                            oc_s_mode_get_priority(resource_url), true, false);
+}
+
+void
+oc_do_s_mode_st_with_priority(int scope, const char *resource_url,
+                              oc_s_mode_st_t st,
+                              oc_message_priority_t priority)
+{
+  oc_do_s_mode_st_and_check(scope, resource_url, st, priority, true, true);
+}
+
 // ----------------------------------------------------------------------------
 
 bool
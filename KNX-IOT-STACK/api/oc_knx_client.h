@@ -156,6 +156,111 @@ bool oc_is_redirected_request(oc_request_t *request);
  */
 oc_rep_t *oc_s_mode_get_value(oc_request_t *request);
 
+/**
+ * @brief the s-mode service type (st)
+ *
+ * The service type is converted from/to the string on the wire only when
+ * decoding or encoding the s-mode message.
+ */
+typedef enum {
+  OC_S_MODE_ST_NONE = 0,    ///< no or unknown service type
+  OC_S_MODE_ST_WRITE,       ///< "w" write
+  OC_S_MODE_ST_READ,        ///< "r" read
+  OC_S_MODE_ST_RESPONSE,    ///< "a" response (spec 1.1)
+  OC_S_MODE_ST_RESPONSE_RP, ///< "rp" response (spec 1.0)
+} oc_s_mode_st_t;
+
+/**
+ * @brief converts the st string of an s-mode message to the service type
+ *
+ * @param st the string e.g. "w" | "r" | "a" | "rp"
+ * @return oc_s_mode_st_t the service type, OC_S_MODE_ST_NONE if not known
+ */
+oc_s_mode_st_t oc_s_mode_st_from_string(const char *st);
+
+/**
+ * @brief converts the service type to the st string of an s-mode message
+ *
+ * @param st the service type
+ * @return const char* the string, "" for OC_S_MODE_ST_NONE
+ */
+const char *oc_s_mode_st_to_string(oc_s_mode_st_t st);
+
+/**
+ * @brief result of decoding an s-mode frame
+ */
+typedef enum {
+  OC_S_MODE_FRAME_OK = 0,        ///< frame decoded
+  OC_S_MODE_FRAME_CBOR_ERROR,    ///< payload is not valid CBOR
+  OC_S_MODE_FRAME_NOT_A_MAP,     ///< top level or key 5 is not a map
+  OC_S_MODE_FRAME_INVALID_TYPE,  ///< sia, st or ga has the wrong type
+  OC_S_MODE_FRAME_INVALID_ST,    ///< st is not a known service type
+  OC_S_MODE_FRAME_MISSING_GA,    ///< no ga (7) in the frame
+  OC_S_MODE_FRAME_MISSING_ST,    ///< no st (6) in the frame
+  OC_S_MODE_FRAME_MISSING_VALUE, ///< no value (1) for a write/response
+} oc_s_mode_frame_error_t;
+
+/**
+ * @brief the decoded s-mode frame
+ * { 4:sia, 5:{ 6:st, 7:ga, 1:value } }
+ *
+ * The value is not decoded, it points to the encoded CBOR data item of the
+ * value inside the received payload.
+ */
+typedef struct oc_s_mode_frame_t
+{
+  uint32_t sia;         ///< sender individual address
+  uint32_t ga;          ///< group address
+  oc_s_mode_st_t st;    ///< service type
+  const uint8_t *value; ///< encoded value, NULL if not present
+  size_t value_len;     ///< length of the encoded value
+} oc_s_mode_frame_t;
+
+/**
+ * @brief decodes an s-mode frame in a single pass over the CBOR payload,
+ * without creating an oc_rep_t tree.
+ *
+ * @param payload the CBOR payload
+ * @param payload_len the length of the payload
+ * @param frame [out] the decoded frame
+ * @return OC_S_MODE_FRAME_OK on success, otherwise the reason of the failure
+ */
+oc_s_mode_frame_error_t oc_s_mode_decode_frame(const uint8_t *payload,
+                                               size_t payload_len,
+                                               oc_s_mode_frame_t *frame);
+
+/**
+ * @brief returns a readable string of the frame decode result
+ *
+ * @param error the result of oc_s_mode_decode_frame
+ * @return const char* the description
+ */
+const char *oc_s_mode_frame_error_str(oc_s_mode_frame_error_t error);
+
+/**
+ * @brief decodes the value of a decoded s-mode frame into a (single) rep with
+ * iname 1, as expected by the PUT handlers of the data points.
+ * A scalar value is decoded into storage, without allocations. Text and byte
+ * strings point into the frame and are not terminated, use oc_string_len.
+ * Arrays and maps are parsed into reps of the current rep pool.
+ *
+ * @param frame the decoded frame
+ * @param storage the caller owned rep for a scalar value
+ * @return oc_rep_t* the value, NULL if there is no (valid) value. The value
+ * is only valid as long as the frame and storage, free it with
+ * oc_s_mode_free_value.
+ */
+oc_rep_t *oc_s_mode_frame_get_value(const oc_s_mode_frame_t *frame,
+                                    oc_rep_t *storage);
+
+/**
+ * @brief frees the value returned by oc_s_mode_frame_get_value
+ *
+ * @param value the value, may be NULL
+ * @param storage the rep that was given to oc_s_mode_frame_get_value
+ */
+void oc_s_mode_free_value(oc_rep_t *value, oc_rep_t *storage);
+
 /** @} */ // end of doc_module_tag_s_mode_server
 
 /**
@@ -184,6 +289,10 @@ void oc_do_s_mode_read(int64_t group_address);
  * Note: function does check the T flag on the resource
  *       if the T flag is not set, then the message is NOT send.
  *
+ * The value is also handed to the other group objects of this device with
+ * the same (first) group address and the W flag, once per value: with the
+ * scope 5 message only, a scope 2 message is an extra copy.
+ *
  * @param scope the multi-cast scope
  * @param resource_url URI of the resource (e.g. implemented on the device that
  * is calling this function)
@@ -191,6 +300,37 @@ void oc_do_s_mode_read(int64_t group_address);
  */
 void oc_do_s_mode_with_scope(int scope, const char *resource_url, char *rp);
 
+/**
+ * @brief sends (transmits) an s-mode message, with the service type as enum
+ *
+ * Note: function does check the T flag on the resource
+ *
+ * @see oc_do_s_mode_with_scope
+ * @param scope the multi-cast scope
+ * @param resource_url URI of the resource (e.g. implemented on the device that
+ * is calling this function)
+ * @param st the service type to send
+ */
+void oc_do_s_mode_st(int scope, const char *resource_url, oc_s_mode_st_t st);
+
+/**
+ * @brief sends (transmits) an s-mode message, without handing the value to
+ * the local group objects with the same group address
+ *
+ * Used when the value was received from the bus: the local group objects
+ * have been updated by the receiving side already.
+ *
+ * Note: function does check the T flag on the resource
+ *
+ * @see oc_do_s_mode_st
+ * @param scope the multi-cast scope
+ * @param resource_url URI of the resource (e.g. implemented on the device that
+ * is calling this function)
+ * @param st the service type to send
+ */
+void oc_do_s_mode_st_no_loopback(int scope, const char *resource_url,
+                                 oc_s_mode_st_t st);
+
 /**
  * @brief sends (transmits) an s-mode message
  * the value comes from the GET of the resource indicated by the resource_url
@@ -215,6 +355,163 @@ void oc_do_s_mode_with_scope(int scope, const char *resource_url, char *rp);
 void oc_do_s_mode_with_scope_no_check(int scope, const char *resource_url,
                                       char *rp);
 
+/**
+ * @brief sends (transmits) an s-mode message, with the service type as enum
+ *
+ * Note: function does NOT check the T flag on the resource
+ *
+ * @see oc_do_s_mode_with_scope_no_check
+ * @param scope the multi-cast scope
+ * @param resource_url URI of the resource (e.g. implemented on the device that
+ * is calling this function)
+ * @param st the service type to send
+ */
+void oc_do_s_mode_st_no_check(int scope, const char *resource_url,
+                              oc_s_mode_st_t st);
+
+/**
+ * @brief sends (transmits) an s-mode message with a specific priority
+ *
+ * The priority overrides the priority set with oc_s_mode_set_priority.
+ * Messages with high or system priority are not delayed by the send queue.
+ *
+ * Note: function does check the T flag on the resource
+ *
+ * @see oc_do_s_mode_st
+ * @param scope the multi-cast scope
+ * @param resource_url URI of the resource (e.g. implemented on the device that
+ * is calling this function)
+ * @param st the service type to send
+ * @param priority the priority of the message
+ */
+void oc_do_s_mode_st_with_priority(int scope, const char *resource_url,
+                                   oc_s_mode_st_t st,
+                                   oc_message_priority_t priority);
+
+/**
+ * @brief publishes the current value of a data point
+ *
+ * The s-mode messages of the data point use the published value, instead of
+ * calling the GET handler of the resource. The application needs to publish
+ * each change of the value. Data points that are not published use the GET
+ * handler.
+ *
+ * Example: a boolean value true is published as { 0xf5 }
+ *
+ * @param resource_url URI of the resource (data point)
+ * @param value the CBOR encoded value (one data item, without the key 1)
+ * @param value_len the length of the encoded value
+ * @return true the value is stored
+ * @return false invalid value, unknown resource or the store is full
+ * (OC_S_MODE_VALUE_STORE_SIZE)
+ */
+bool oc_s_mode_publish_value(const char *resource_url, const uint8_t *value,
+                             size_t value_len);
+
+/**
+ * @brief publishes a boolean value of a data point
+ *
+ * @see oc_s_mode_publish_value
+ * @param resource_url URI of the resource (data point)
+ * @param value the value
+ * @return true the value is stored
+ */
+bool oc_s_mode_publish_bool(const char *resource_url, bool value);
+
+/**
+ * @brief publishes an integer value of a data point
+ *
+ * @see oc_s_mode_publish_value
+ * @param resource_url URI of the resource (data point)
+ * @param value the value
+ * @return true the value is stored
+ */
+bool oc_s_mode_publish_int(const char *resource_url, int64_t value);
+
+/**
+ * @brief publishes a floating point value of a data point
+ *
+ * @see oc_s_mode_publish_value
+ * @param resource_url URI of the resource (data point)
+ * @param value the value
+ * @return true the value is stored
+ */
+bool oc_s_mode_publish_double(const char *resource_url, double value);
+
+/**
+ * @brief removes the published value of a data point, the GET handler of the
+ * resource is used again
+ *
+ * @param resource_url URI of the resource (data point)
+ */
+void oc_s_mode_unpublish_value(const char *resource_url);
+
+/**
+ * @brief checks if a value has been published for a data point
+ *
+ * @param resource the resource (data point)
+ * @return true the s-mode messages use the published value
+ * @return false the GET handler of the resource is used
+ */
+bool oc_s_mode_is_value_published(const oc_resource_t *resource);
+
+/**
+ * @brief removes the published value and the priority of a resource
+ *
+ * Called when the resource is deleted, the entries are kept by resource.
+ *
+ * @param resource the resource that is deleted
+ */
+void oc_s_mode_resource_deleted(const oc_resource_t *resource);
+
+/**
+ * @brief sets the priority of the s-mode messages of a data point
+ *
+ * The priority is used for the messages to all group addresses of the data
+ * point. Messages with high or system priority are not delayed by the send
+ * queue and are sent with a higher transport priority.
+ *
+ * @param resource_url URI of the resource (data point)
+ * @param priority the priority, OC_MESSAGE_PRIORITY_NORMAL removes the entry
+ * @return true the priority is stored
+ */
+bool oc_s_mode_set_priority(const char *resource_url,
+                            oc_message_priority_t priority);
+
+/**
+ * @brief gets the priority of the s-mode messages of a data point
+ *
+ * @param resource_url URI of the resource (data point)
+ * @return oc_message_priority_t the priority, OC_MESSAGE_PRIORITY_NORMAL when
+ * not set
+ */
+oc_message_priority_t oc_s_mode_get_priority(const char *resource_url);
+
+/**
+ * @brief counters of the s-mode send queue
+ *
+ * @see oc_s_mode_queue_get_stats
+ */
+typedef struct oc_s_mode_queue_stats_t
+{
+  uint32_t sent;      /**< number of s-mode messages sent */
+  uint32_t delayed;   /**< number of messages delayed due to the interval */
+  uint32_t coalesced; /**< number of messages replaced by a newer value */
+} oc_s_mode_queue_stats_t;
+
+/**
+ * @brief retrieve the counters of the s-mode send queue
+ *
+ * s-mode messages with the same scope, group address and st value are sent at
+ * most once per OC_S_MODE_MIN_INTERVAL_MS milliseconds. Messages issued within
+ * the interval are delayed, only the latest value is sent when the interval
+ * has passed. The queue is disabled when OC_S_MODE_MIN_INTERVAL_MS is 0
+ * (default).
+ *
+ * @return the counters
+ */
+const oc_s_mode_queue_stats_t *oc_s_mode_queue_get_stats(void);
+
 /** @} */ // end of doc_module_tag_s_mode_client
 
 #ifdef __cplusplus
@@ -1037,6 +1037,9 @@ oc_core_dev_mport_put_handler(oc_request_t *request,
   if ((rep != NULL) && (rep->type == OC_REP_INT)) {
     PRINT("  oc_core_dev_mport_put_handler received : %d\n",
           (int)rep->value.integer);
+    if (device->mport != (uint32_t)rep->value.integer) {
+      oc_clear_multicast_group_address_cache();
+    }
     device->mport = (uint32_t)rep->value.integer;
     oc_send_response_no_format(request, OC_STATUS_CHANGED);
     oc_storage_write(KNX_STORAGE_MPORT, (uint8_t *)&(rep->value.integer), 1);
@@ -1449,6 +1452,7 @@ oc_knx_device_storage_reset(size_t device_index, int reset_mode)
     device->fid = zero;
     device->port = port;
     device->mport = mport;
+    oc_clear_multicast_group_address_cache();
     oc_free_string(&device->hostname);
     oc_new_string(&device->hostname, "", strlen(""));
 
@@ -20,6 +20,7 @@
 #include "oc_core_res.h"
 #include "oc_helpers.h"
 #include "oc_knx_helpers.h"
+#include "port/oc_random.h"
 #include <stdio.h>
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
@@ -29,6 +30,9 @@
 #define GOT_STORE "GOT_STORE"
 #define GPT_STORE "GPUBT_STORE"
 #define GRT_STORE "GRECT_STORE"
+#define GOT_BLOB_STORE "GOT_BLOB"
+#define GPT_BLOB_STORE "GPUBT_BLOB"
+#define GRT_BLOB_STORE "GRECT_BLOB"
 
 #ifndef GOT_MAX_ENTRIES
 #define GOT_MAX_ENTRIES 20
@@ -47,6 +51,942 @@ static oc_group_rp_table_t g_gpt[GPT_MAX_ENTRIES];
 #endif
 static oc_group_rp_table_t g_grt[GRT_MAX_ENTRIES];
 
+// -----------------------------------------------------------------------------
+// storage of the group addresses and strings of the tables
+//
+// default: each array of group addresses and each string is allocated
+// separately on the heap.
+// OC_FP_TABLE_POOL: all group addresses of all tables are stored in one
+// contiguous pool and all strings are stored (interned) in one string arena.
+// the pool and the arena are allocated on the heap when the first data is
+// stored, grow and shrink in steps and are freed when the tables are empty.
+// they are kept compact: when data is released the data after it is moved and
+// the references in the tables are adjusted.
+// the tables keep their oc_string_t and uint32_t * members, these point into
+// the pool and the arena. hence pointers to group addresses and strings of the
+// tables, e.g. obtained via the accessors, are only valid until the next change
+// of a table. with OC_DEBUG the data is moved to a new allocation on every
+// release, so that a pointer that is used after a change is reported by the
+// address sanitizer or valgrind.
+// measured with oc_core_get_fp_table_memory, for tables of 20 entries (2 group
+// addresses per group object table entry, 2 entries per href, recipients with
+// path "/k", publishers with an url): 947 bytes in 120 allocations without the
+// pool and 960 bytes in 2 allocations with the pool. with a heap that has an
+// 8 byte header per allocation that is 2400 versus 976 bytes.
+
+#ifdef OC_FP_TABLE_POOL
+
+#ifdef OC_PUBLISHER_TABLE
+#define OC_FP_TABLE_ENTRIES                                                    \
+  (GOT_MAX_ENTRIES + GPT_MAX_ENTRIES + GRT_MAX_ENTRIES)
+#else
+#define OC_FP_TABLE_ENTRIES (GOT_MAX_ENTRIES + GRT_MAX_ENTRIES)
+#endif
+
+#ifndef OC_FP_GA_POOL_SIZE
+/* maximum amount of group addresses, for all tables together */
+#define OC_FP_GA_POOL_SIZE (4 * OC_FP_TABLE_ENTRIES)
+#endif
+
+#ifndef OC_FP_STRING_ARENA_SIZE
+/* maximum amount of bytes for all (interned) strings of all tables together */
+#define OC_FP_STRING_ARENA_SIZE (32 * OC_FP_TABLE_ENTRIES)
+#endif
+
+#if OC_FP_STRING_ARENA_SIZE > UINT16_MAX
+#error "OC_FP_STRING_ARENA_SIZE does not fit the 16 bit string header"
+#endif
+
+/* the pool and the arena grow and shrink in these steps */
+#define OC_FP_GA_POOL_STEP (8)
+#define OC_FP_STRING_ARENA_STEP (64)
+
+/* size of the header of a string in the arena: reference count + length */
+#define OC_FP_STRING_HEADER_SIZE (4)
+
+static uint32_t *g_fp_ga_pool = NULL;
+static int g_fp_ga_pool_size = 0;
+static int g_fp_ga_pool_used = 0;
+
+static uint8_t *g_fp_string_arena = NULL;
+static size_t g_fp_string_arena_size = 0;
+static size_t g_fp_string_arena_used = 0;
+
+/* the group addresses from index "from" up to "to" in the pool at old_base
+   are now at index - shift in the pool at base, adjusts the pointer */
+static void
+oc_fp_move_ga(uint32_t **ga, const uint32_t *old_base, int from, int to,
+              uint32_t *base, int shift)
+{
+  if (*ga == NULL || *ga < old_base + from || *ga >= old_base + to) {
+    return;
+  }
+  *ga = base + (*ga - old_base) - shift;
+}
+
+/* adjusts the group address pointers of all tables, see oc_fp_move_ga */
+static void
+oc_fp_rebase_ga(const uint32_t *old_base, int from, int to, uint32_t *base,
+                int shift)
+{
+  for (int i = 0; i < GOT_MAX_ENTRIES; i++) {
+    oc_fp_move_ga(&g_got[i].ga, old_base, from, to, base, shift);
+  }
+  for (int i = 0; i < GRT_MAX_ENTRIES; i++) {
+    oc_fp_move_ga(&g_grt[i].ga, old_base, from, to, base, shift);
+  }
+#ifdef OC_PUBLISHER_TABLE
+  for (int i = 0; i < GPT_MAX_ENTRIES; i++) {
+    oc_fp_move_ga(&g_gpt[i].ga, old_base, from, to, base, shift);
+  }
+#endif /* OC_PUBLISHER_TABLE */
+}
+
+/* (re)allocates the pool with the given capacity, 0 frees the pool */
+static bool
+oc_fp_ga_pool_resize(int size)
+{
+  uint32_t *pool = NULL;
+  if (size > 0) {
+    pool = (uint32_t *)malloc(size * sizeof(uint32_t));
+    if (pool == NULL) {
+      return false;
+    }
+    if (g_fp_ga_pool_used > 0) {
+      memcpy(pool, g_fp_ga_pool, g_fp_ga_pool_used * sizeof(uint32_t));
+    }
+  }
+  if (g_fp_ga_pool != NULL) {
+    oc_fp_rebase_ga(g_fp_ga_pool, 0, g_fp_ga_pool_used, pool, 0);
+  }
+  free(g_fp_ga_pool);
+  g_fp_ga_pool = pool;
+  g_fp_ga_pool_size = size;
+  return true;
+}
+
+static uint32_t *
+oc_fp_ga_alloc(int len)
+{
+  if (len <= 0) {
+    return NULL;
+  }
+  int needed = g_fp_ga_pool_used + len;
+  if (needed > OC_FP_GA_POOL_SIZE) {
+    OC_ERR("group address pool full: used %d requested %d", g_fp_ga_pool_used,
+           len);
+    return NULL;
+  }
+  if (needed > g_fp_ga_pool_size) {
+    int size = (needed + OC_FP_GA_POOL_STEP - 1) / OC_FP_GA_POOL_STEP *
+               OC_FP_GA_POOL_STEP;
+    if (size > OC_FP_GA_POOL_SIZE) {
+      size = OC_FP_GA_POOL_SIZE;
+    }
+    if (!oc_fp_ga_pool_resize(size)) {
+      OC_ERR("out of memory: group address pool %d", size);
+      return NULL;
+    }
+  }
+  uint32_t *ga = &g_fp_ga_pool[g_fp_ga_pool_used];
+  g_fp_ga_pool_used += len;
+  return ga;
+}
+
+static void
+oc_fp_ga_release(uint32_t *ga, int len)
+{
+  if (g_fp_ga_pool == NULL || ga < g_fp_ga_pool ||
+      ga >= &g_fp_ga_pool[g_fp_ga_pool_used] || len <= 0) {
+    return;
+  }
+  int old_used = g_fp_ga_pool_used;
+  int offset = (int)(ga - g_fp_ga_pool);
+  if (offset + len > old_used) {
+    len = old_used - offset;
+  }
+  memmove(ga, ga + len, (old_used - offset - len) * sizeof(uint32_t));
+  g_fp_ga_pool_used -= len;
+  /* only the group addresses behind the released ones, within the pool */
+  oc_fp_rebase_ga(g_fp_ga_pool, offset + len, old_used, g_fp_ga_pool, len);
+
+  if (g_fp_ga_pool_used == 0) {
+    oc_fp_ga_pool_resize(0);
+  } else if (g_fp_ga_pool_size - g_fp_ga_pool_used >= 2 * OC_FP_GA_POOL_STEP) {
+    /* keeping the larger pool is fine when there is no memory to shrink */
+    oc_fp_ga_pool_resize(g_fp_ga_pool_size - OC_FP_GA_POOL_STEP);
+  }
+#ifdef OC_DEBUG
+  else {
+    /* stale pointers into the pool end up in freed memory */
+    oc_fp_ga_pool_resize(g_fp_ga_pool_size);
+  }
+#endif /* OC_DEBUG */
+}
+
+/* strings in the arena are referred to by their offset (+ 1), 0 is no string */
+typedef uint16_t oc_fp_string_ref_t;
+
+/* the header of the string with the offset (+ 1) in the arena */
+static uint8_t *
+oc_fp_string_header(oc_fp_string_ref_t str)
+{
+  return &g_fp_string_arena[str - 1 - OC_FP_STRING_HEADER_SIZE];
+}
+
+/* the string from offset "from" up to "to" in the arena at old_base is now at
+   offset - shift in the arena at base, adjusts the pointer */
+static void
+oc_fp_move_string(oc_string_t *str, const uint8_t *old_base, size_t from,
+                  size_t to, uint8_t *base, size_t shift)
+{
+  const uint8_t *ptr = (const uint8_t *)str->ptr;
+  if (ptr == NULL || ptr < old_base + from || ptr >= old_base + to) {
+    return;
+  }
+  str->ptr = (char *)base + (ptr - old_base) - shift;
+}
+
+static void
+oc_fp_move_rp_strings(oc_group_rp_table_t *entry, const uint8_t *old_base,
+                      size_t from, size_t to, uint8_t *base, size_t shift)
+{
+  oc_fp_move_string(&entry->path, old_base, from, to, base, shift);
+  oc_fp_move_string(&entry->url, old_base, from, to, base, shift);
+  oc_fp_move_string(&entry->at, old_base, from, to, base, shift);
+}
+
+/* the strings from offset "from" up to "to" in the arena at old_base are
+   now at offset - shift in the arena at base, adjusts all references */
+static void
+oc_fp_rebase_strings(const uint8_t *old_base, size_t from, size_t to,
+                     uint8_t *base, size_t shift)
+{
+  for (int i = 0; i < GOT_MAX_ENTRIES; i++) {
+    oc_fp_move_string(&g_got[i].href, old_base, from, to, base, shift);
+  }
+  for (int i = 0; i < GRT_MAX_ENTRIES; i++) {
+    oc_fp_move_rp_strings(&g_grt[i], old_base, from, to, base, shift);
+  }
+#ifdef OC_PUBLISHER_TABLE
+  for (int i = 0; i < GPT_MAX_ENTRIES; i++) {
+    oc_fp_move_rp_strings(&g_gpt[i], old_base, from, to, base, shift);
+  }
+#endif /* OC_PUBLISHER_TABLE */
+}
+
+/* (re)allocates the arena with the given capacity, 0 frees the arena */
+static bool
+oc_fp_string_arena_resize(size_t size)
+{
+  uint8_t *old_arena = g_fp_string_arena;
+  uint8_t *arena = NULL;
+  if (size > 0) {
+    arena = (uint8_t *)malloc(size);
+    if (arena == NULL) {
+      return false;
+    }
+    if (g_fp_string_arena_used > 0) {
+      memcpy(arena, old_arena, g_fp_string_arena_used);
+    }
+  }
+  if (old_arena != NULL) {
+    oc_fp_rebase_strings(old_arena, 0, g_fp_string_arena_used, arena, 0);
+  }
+  free(old_arena);
+  g_fp_string_arena = arena;
+  g_fp_string_arena_size = size;
+  return true;
+}
+
+/* returns the offset (+ 1) of the string in the arena, the reference count
+   is increased. 0 if there is no space */
+static oc_fp_string_ref_t
+oc_fp_string_intern(const char *value, size_t len)
+{
+  size_t pos = 0;
+  while (pos < g_fp_string_arena_used) {
+    uint16_t refs, str_len;
+    memcpy(&refs, &g_fp_string_arena[pos], sizeof(uint16_t));
+    memcpy(&str_len, &g_fp_string_arena[pos + 2], sizeof(uint16_t));
+    char *str = (char *)&g_fp_string_arena[pos + OC_FP_STRING_HEADER_SIZE];
+    if (str_len == len && memcmp(str, value, len) == 0) {
+      refs++;
+      memcpy(&g_fp_string_arena[pos], &refs, sizeof(uint16_t));
+      return (oc_fp_string_ref_t)(pos + OC_FP_STRING_HEADER_SIZE + 1);
+    }
+    pos += OC_FP_STRING_HEADER_SIZE + str_len + 1;
+  }
+
+  size_t size = OC_FP_STRING_HEADER_SIZE + len + 1;
+  size_t needed = g_fp_string_arena_used + size;
+  if (len > UINT16_MAX || needed > OC_FP_STRING_ARENA_SIZE) {
+    OC_ERR("string arena full: used %d requested %d",
+           (int)g_fp_string_arena_used, (int)size);
+    return 0;
+  }
+  if (needed > g_fp_string_arena_size) {
+    size_t arena_size = (needed + OC_FP_STRING_ARENA_STEP - 1) /
+                        OC_FP_STRING_ARENA_STEP * OC_FP_STRING_ARENA_STEP;
+    if (arena_size > OC_FP_STRING_ARENA_SIZE) {
+      arena_size = OC_FP_STRING_ARENA_SIZE;
+    }
+    if (!oc_fp_string_arena_resize(arena_size)) {
+      OC_ERR("out of memory: string arena %d", (int)arena_size);
+      return 0;
+    }
+  }
+  uint16_t refs = 1;
+  uint16_t str_len = (uint16_t)len;
+  memcpy(&g_fp_string_arena[pos], &refs, sizeof(uint16_t));
+  memcpy(&g_fp_string_arena[pos + 2], &str_len, sizeof(uint16_t));
+  char *str = (char *)&g_fp_string_arena[pos + OC_FP_STRING_HEADER_SIZE];
+  memcpy(str, value, len);
+  str[len] = '\0';
+  g_fp_string_arena_used += size;
+  return (oc_fp_string_ref_t)(pos + OC_FP_STRING_HEADER_SIZE + 1);
+}
+
+static void
+oc_fp_string_release(oc_fp_string_ref_t str)
+{
+  if (str <= OC_FP_STRING_HEADER_SIZE || str > g_fp_string_arena_used) {
+    return;
+  }
+  uint8_t *header = oc_fp_string_header(str);
+  uint16_t refs, str_len;
+  memcpy(&refs, header, sizeof(uint16_t));
+  memcpy(&str_len, header + 2, sizeof(uint16_t));
+  if (refs > 1) {
+    refs--;
+    memcpy(header, &refs, sizeof(uint16_t));
+    return;
+  }
+  size_t size = OC_FP_STRING_HEADER_SIZE + str_len + 1;
+  size_t offset = (size_t)(header - g_fp_string_arena);
+  size_t old_used = g_fp_string_arena_used;
+  memmove(header, header + size, old_used - offset - size);
+  g_fp_string_arena_used -= size;
+  /* only the strings behind the released string, within the arena */
+  oc_fp_rebase_strings(g_fp_string_arena, offset + size, old_used,
+                       g_fp_string_arena, size);
+
+  if (g_fp_string_arena_used == 0) {
+    oc_fp_string_arena_resize(0);
+  } else if (g_fp_string_arena_size - g_fp_string_arena_used >=
+             2 * OC_FP_STRING_ARENA_STEP) {
+    /* keeping the larger arena is fine when there is no memory to shrink */
+    oc_fp_string_arena_resize(g_fp_string_arena_size -
+                              OC_FP_STRING_ARENA_STEP);
+  }
+#ifdef OC_DEBUG
+  else {
+    /* stale pointers into the arena end up in freed memory */
+    oc_fp_string_arena_resize(g_fp_string_arena_size);
+  }
+#endif /* OC_DEBUG */
+}
+
+/* the offset (+ 1) of the string in the arena that str refers to */
+static oc_fp_string_ref_t
+oc_fp_string_ref(const oc_string_t *str)
+{
+  const uint8_t *ptr = (const uint8_t *)str->ptr;
+  if (ptr == NULL || g_fp_string_arena == NULL || ptr < g_fp_string_arena ||
+      ptr >= g_fp_string_arena + g_fp_string_arena_used) {
+    return 0;
+  }
+  return (oc_fp_string_ref_t)(ptr - g_fp_string_arena + 1);
+}
+
+/* the string of the table refers to the arena, it is not allocated with
+   oc_mmem and may not be freed with oc_free_string */
+static bool
+oc_fp_set_string(oc_string_t *str, const char *value, size_t len)
+{
+  oc_fp_string_ref_t new_str = 0;
+  if (len > 0) {
+    new_str = oc_fp_string_intern(value, len);
+  }
+  oc_fp_string_ref_t old_str = oc_fp_string_ref(str);
+  str->next = NULL;
+  str->size = new_str ? len + 1 : 0;
+  str->ptr = new_str ? g_fp_string_arena + new_str - 1 : NULL;
+  oc_fp_string_release(old_str);
+  return (new_str != 0 || len == 0);
+}
+
+static void
+oc_fp_free_string(oc_string_t *str)
+{
+  oc_fp_string_ref_t old_str = oc_fp_string_ref(str);
+  str->next = NULL;
+  str->size = 0;
+  str->ptr = NULL;
+  oc_fp_string_release(old_str);
+}
+
+#else /* OC_FP_TABLE_POOL */
+
+static uint32_t *
+oc_fp_ga_alloc(int len)
+{
+  if (len <= 0) {
+    return NULL;
+  }
+  return (uint32_t *)malloc(len * sizeof(uint32_t));
+}
+
+static void
+oc_fp_ga_release(uint32_t *ga, int len)
+{
+  (void)len;
+  free(ga);
+}
+
+static bool
+oc_fp_set_string(oc_string_t *str, const char *value, size_t len)
+{
+  oc_free_string(str);
+  oc_new_string(str, value, len);
+  return true;
+}
+
+static void
+oc_fp_free_string(oc_string_t *str)
+{
+  oc_free_string(str);
+}
+
+#endif /* OC_FP_TABLE_POOL */
+
+/* replaces the group addresses, the old array is released after the new
+   array has been assigned */
+static void
+oc_fp_assign_ga(uint32_t **ga, int *ga_len, uint32_t *new_ga, int new_len)
+{
+  uint32_t *old_ga = *ga;
+  int old_len = *ga_len;
+  *ga = new_ga;
+  *ga_len = new_ga ? new_len : 0;
+  oc_fp_ga_release(old_ga, old_len);
+}
+
+static bool
+oc_fp_set_ga(uint32_t **ga, int *ga_len, const uint32_t *values, int len)
+{
+  uint32_t *new_ga = oc_fp_ga_alloc(len);
+  if (new_ga == NULL && len > 0) {
+    OC_ERR("out of memory");
+    return false;
+  }
+  for (int i = 0; i < len; i++) {
+#pragma warning(suppress : 6386)
+    new_ga[i] = values[i];
+  }
+  oc_fp_assign_ga(ga, ga_len, new_ga, len);
+  return true;
+}
+
+static bool
+oc_fp_set_ga_from_int_array(uint32_t **ga, int *ga_len, const int64_t *values,
+                            int len)
+{
+  uint32_t *new_ga = oc_fp_ga_alloc(len);
+  if (new_ga == NULL && len > 0) {
+    OC_ERR("out of memory");
+    return false;
+  }
+  for (int i = 0; i < len; i++) {
+#pragma warning(suppress : 6386)
+    new_ga[i] = (uint32_t)values[i];
+  }
+  oc_fp_assign_ga(ga, ga_len, new_ga, len);
+  return true;
+}
+
+static void
+oc_fp_free_ga(uint32_t **ga, int *ga_len)
+{
+  oc_fp_assign_ga(ga, ga_len, NULL, 0);
+}
+
+#ifndef OC_FP_TABLE_POOL
+static void
+oc_fp_heap_add(oc_fp_table_memory_t *memory, const void *ptr, size_t size)
+{
+  if (ptr != NULL) {
+    memory->heap_size += size;
+    memory->heap_blocks++;
+  }
+}
+
+static void
+oc_fp_rp_table_memory(const oc_group_rp_table_t *rp_table, int max_size,
+                      oc_fp_table_memory_t *memory)
+{
+  for (int i = 0; i < max_size; i++) {
+    oc_fp_heap_add(memory, rp_table[i].ga,
+                   rp_table[i].ga_len * sizeof(uint32_t));
+    oc_fp_heap_add(memory, rp_table[i].path.ptr, rp_table[i].path.size);
+    oc_fp_heap_add(memory, rp_table[i].url.ptr, rp_table[i].url.size);
+    oc_fp_heap_add(memory, rp_table[i].at.ptr, rp_table[i].at.size);
+  }
+}
+#endif /* !OC_FP_TABLE_POOL */
+
+void
+oc_core_get_fp_table_memory(oc_fp_table_memory_t *memory)
+{
+  memset(memory, 0, sizeof(oc_fp_table_memory_t));
+  memory->table_size = sizeof(g_got) + sizeof(g_grt);
+#ifdef OC_PUBLISHER_TABLE
+  memory->table_size += sizeof(g_gpt);
+#endif /* OC_PUBLISHER_TABLE */
+#ifdef OC_FP_TABLE_POOL
+  if (g_fp_ga_pool != NULL) {
+    memory->heap_size += g_fp_ga_pool_size * sizeof(uint32_t);
+    memory->heap_blocks++;
+  }
+  if (g_fp_string_arena != NULL) {
+    memory->heap_size += g_fp_string_arena_size;
+    memory->heap_blocks++;
+  }
+#else  /* OC_FP_TABLE_POOL */
+  for (int i = 0; i < GOT_MAX_ENTRIES; i++) {
+    oc_fp_heap_add(memory, g_got[i].ga, g_got[i].ga_len * sizeof(uint32_t));
+    oc_fp_heap_add(memory, g_got[i].href.ptr, g_got[i].href.size);
+  }
+  oc_fp_rp_table_memory(g_grt, GRT_MAX_ENTRIES, memory);
+#ifdef OC_PUBLISHER_TABLE
+  oc_fp_rp_table_memory(g_gpt, GPT_MAX_ENTRIES, memory);
+#endif /* OC_PUBLISHER_TABLE */
+#endif /* !OC_FP_TABLE_POOL */
+}
+
+bool is_in_array(uint32_t value, uint32_t *array, int array_size);
+
+// -----------------------------------------------------------------------------
+// group address index (dispatch plan) of the Group Object Table
+//
+// sorted list of (group address, GOT index) pairs, so that the entries that
+// belong to a group address can be found with a binary search instead of
+// scanning all entries and all their group addresses.
+// each pair also contains the resolved resource and the cflags of the entry,
+// so that a received s-mode message can be handled without string compares.
+// the index is rebuilt (lazily) after the group object table or the set of
+// resources has been changed.
+
+// the href index contains the GOT indices grouped per resource, each
+// resource refers to its part of the list via its runtime data.
+// when there is no memory for the index, the iteration over the entries of a
+// group address scans the table instead.
+
+static oc_group_object_dispatch_t *g_got_ga_index = NULL;
+static int g_got_ga_index_len = 0;
+static int g_got_ga_index_size = 0;
+static bool g_got_ga_index_valid = false;
+static size_t g_got_ga_index_device = 0;
+static int g_got_href_index[GOT_MAX_ENTRIES];
+
+void
+oc_core_group_object_table_changed(void)
+{
+  g_got_ga_index_valid = false;
+}
+
+static bool
+oc_got_ga_index_less(uint32_t ga1, int index1, uint32_t ga2, int index2)
+{
+  if (ga1 != ga2) {
+    return ga1 < ga2;
+  }
+  return index1 < index2;
+}
+
+static void
+oc_got_ga_index_free(void)
+{
+  free(g_got_ga_index);
+  g_got_ga_index = NULL;
+  g_got_ga_index_len = 0;
+  g_got_ga_index_size = 0;
+  g_got_ga_index_valid = false;
+}
+
+static void
+oc_got_href_index_build(const oc_resource_t **got_resources)
+{
+  int pos = 0;
+  const oc_resource_t *res = oc_ri_get_app_resources();
+  for (; res != NULL; res = oc_ri_resource_next(res)) {
+    if (res->device == (size_t)-1 || res->runtime_data == NULL) {
+      continue;
+    }
+    res->runtime_data->got_first = (uint16_t)pos;
+    res->runtime_data->got_count = 0;
+    for (int i = 0; i < GOT_MAX_ENTRIES; i++) {
+      if (got_resources[i] == res) {
+        g_got_href_index[pos++] = i;
+        res->runtime_data->got_count++;
+      }
+    }
+  }
+}
+
+/* the resources of the hrefs are looked up on the given device */
+static bool
+oc_got_ga_index_build(size_t device)
+{
+  const oc_resource_t *got_resources[GOT_MAX_ENTRIES];
+  for (int i = 0; i < GOT_MAX_ENTRIES; i++) {
+    got_resources[i] = NULL;
+    if (g_got[i].id > -1 && oc_string_len(g_got[i].href) > 0) {
+      got_resources[i] = oc_ri_get_app_resource_by_uri(
+        oc_string(g_got[i].href), oc_string_len(g_got[i].href), device);
+    }
+  }
+  g_got_ga_index_device = device;
+  oc_got_href_index_build(got_resources);
+
+  int nr_ga = 0;
+  for (int i = 0; i < GOT_MAX_ENTRIES; i++) {
+    if (g_got[i].id > -1) {
+      nr_ga += g_got[i].ga_len;
+    }
+  }
+  if (nr_ga > g_got_ga_index_size) {
+    oc_group_object_dispatch_t *new_index =
+      (oc_group_object_dispatch_t *)malloc(nr_ga *
+                                           sizeof(oc_group_object_dispatch_t));
+    if (new_index == NULL) {
+      OC_ERR("out of memory: group address index");
+      return false;
+    }
+    free(g_got_ga_index);
+    g_got_ga_index = new_index;
+    g_got_ga_index_size = nr_ga;
+  }
+
+  /* insertion sort: the table is small and only rebuilt on changes */
+  int len = 0;
+  for (int i = 0; i < GOT_MAX_ENTRIES; i++) {
+    if (g_got[i].id < 0) {
+      continue;
+    }
+    const oc_resource_t *resource = got_resources[i];
+    for (int j = 0; j < g_got[i].ga_len; j++) {
+      uint32_t ga = g_got[i].ga[j];
+      int pos = len;
+      while (pos > 0 && oc_got_ga_index_less(ga, i, g_got_ga_index[pos - 1].ga,
+                                             g_got_ga_index[pos - 1].index)) {
+        pos--;
+      }
+      if (pos > 0 && g_got_ga_index[pos - 1].ga == ga &&
+          g_got_ga_index[pos - 1].index == i) {
+        /* same group address listed twice in the entry */
+        continue;
+      }
+      memmove(&g_got_ga_index[pos + 1], &g_got_ga_index[pos],
+              (len - pos) * sizeof(oc_group_object_dispatch_t));
+      g_got_ga_index[pos].ga = ga;
+      g_got_ga_index[pos].index = i;
+      g_got_ga_index[pos].cflags = g_got[i].cflags;
+      g_got_ga_index[pos].href = oc_string(g_got[i].href);
+      g_got_ga_index[pos].resource = resource;
+      len++;
+    }
+  }
+  g_got_ga_index_len = len;
+  g_got_ga_index_valid = true;
+  return true;
+}
+
+/* returns the position of the first pair >= (group_address, min_index),
+   or -1 if the index is not available */
+static int
+oc_got_ga_index_lower_bound(uint32_t group_address, int min_index,
+                            size_t device)
+{
+  if ((g_got_ga_index_valid == false || g_got_ga_index_device != device) &&
+      oc_got_ga_index_build(device) == false) {
+    return -1;
+  }
+
+  int low = 0;
+  int high = g_got_ga_index_len;
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (oc_got_ga_index_less(g_got_ga_index[mid].ga,
+                             g_got_ga_index[mid].index, group_address,
+                             min_index)) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+/* returns the first GOT index >= min_index that has the group address,
+   or -1 */
+static int
+oc_got_ga_index_find(uint32_t group_address, int min_index)
+{
+  /* only the table indices are used, the resources do not matter */
+  int pos = oc_got_ga_index_lower_bound(group_address, min_index,
+                                        g_got_ga_index_device);
+  if (pos < 0) {
+    /* no memory for the index, scan the table */
+    for (int i = min_index; i < GOT_MAX_ENTRIES; i++) {
+      if (g_got[i].id > -1 &&
+          is_in_array(group_address, g_got[i].ga, g_got[i].ga_len)) {
+        return i;
+      }
+    }
+    return -1;
+  }
+  if (pos < g_got_ga_index_len && g_got_ga_index[pos].ga == group_address) {
+    return g_got_ga_index[pos].index;
+  }
+  return -1;
+}
+
+const int *
+oc_core_get_group_object_table_indices(const oc_resource_t *resource,
+                                       int *nr_entries)
+{
+  *nr_entries = 0;
+  if (resource == NULL || resource->runtime_data == NULL) {
+    return NULL;
+  }
+  if (g_got_ga_index_valid == false ||
+      g_got_ga_index_device != resource->device) {
+    /* (re)builds the href index, even if the group address index fails */
+    oc_got_ga_index_build(resource->device);
+  }
+  if (resource->runtime_data->got_count == 0) {
+    return NULL;
+  }
+  *nr_entries = resource->runtime_data->got_count;
+  return &g_got_href_index[resource->runtime_data->got_first];
+}
+
+const oc_group_object_dispatch_t *
+oc_core_next_group_object_table_dispatch(uint32_t group_address,
+                                         size_t device, int *pos,
+                                         oc_group_object_dispatch_t *entry)
+{
+  /* *pos > 0: next position in the index + 1,
+     *pos < 0: -(next table index + 1), the index is not available */
+  if (*pos == 0) {
+    int first = oc_got_ga_index_lower_bound(group_address, 0, device);
+    *pos = (first < 0) ? -1 : first + 1;
+  }
+  if (*pos > 0) {
+    int p = *pos - 1;
+    if (p >= g_got_ga_index_len || g_got_ga_index[p].ga != group_address) {
+      return NULL;
+    }
+    (*pos)++;
+    /* the href is taken from the table, strings may have moved in the pool
+       without a change of the index */
+    *entry = g_got_ga_index[p];
+    entry->href = oc_string(g_got[entry->index].href);
+    return entry;
+  }
+
+  /* no memory for the index, scan the table */
+  for (int i = -(*pos) - 1; i < GOT_MAX_ENTRIES; i++) {
+    if (g_got[i].id < 0 ||
+        !is_in_array(group_address, g_got[i].ga, g_got[i].ga_len)) {
+      continue;
+    }
+    *pos = -(i + 2);
+    entry->ga = group_address;
+    entry->index = i;
+    entry->cflags = g_got[i].cflags;
+    entry->href = oc_string(g_got[i].href);
+    entry->resource = NULL;
+    if (oc_string_len(g_got[i].href) > 0) {
+      entry->resource = oc_ri_get_app_resource_by_uri(
+        oc_string(g_got[i].href), oc_string_len(g_got[i].href), device);
+    }
+    return entry;
+  }
+  *pos = -(GOT_MAX_ENTRIES + 1);
+  return NULL;
+}
+
+// -----------------------------------------------------------------------------
+// group address index of the recipient and publisher tables
+//
+// sorted list of (group address, table index) pairs per table, used to find
+// the recipients/publishers of a group address without scanning the table.
+// the index is rebuilt (lazily) after the table has been changed.
+
+typedef struct oc_rp_ga_index_entry_t
+{
+  uint32_t ga; /**< the group address */
+  int index;   /**< index in the recipient/publisher table */
+} oc_rp_ga_index_entry_t;
+
+typedef struct oc_rp_ga_index_t
+{
+  oc_group_rp_table_t *rp_table;   /**< the indexed table */
+  int max_size;                    /**< the size of the indexed table */
+  oc_rp_ga_index_entry_t *entries; /**< the sorted (ga, index) pairs */
+  int len;                         /**< the amount of used pairs */
+  int size;                        /**< the amount of allocated pairs */
+  bool valid;                      /**< false: needs to be rebuilt */
+} oc_rp_ga_index_t;
+
+static oc_rp_ga_index_t g_grt_ga_index = { g_grt, GRT_MAX_ENTRIES, NULL,
+                                           0,     0,               false };
+#ifdef OC_PUBLISHER_TABLE
+static oc_rp_ga_index_t g_gpt_ga_index = { g_gpt, GPT_MAX_ENTRIES, NULL,
+                                           0,     0,               false };
+#endif /* OC_PUBLISHER_TABLE */
+
+static oc_rp_ga_index_t *
+oc_rp_ga_index_of_table(oc_group_rp_table_t *rp_table)
+{
+  if (rp_table == g_grt) {
+    return &g_grt_ga_index;
+  }
+#ifdef OC_PUBLISHER_TABLE
+  if (rp_table == g_gpt) {
+    return &g_gpt_ga_index;
+  }
+#endif /* OC_PUBLISHER_TABLE */
+  return NULL;
+}
+
+static void
+oc_rp_table_changed(oc_group_rp_table_t *rp_table)
+{
+  oc_rp_ga_index_t *ga_index = oc_rp_ga_index_of_table(rp_table);
+  if (ga_index) {
+    ga_index->valid = false;
+  }
+}
+
+static void
+oc_rp_ga_index_free(oc_rp_ga_index_t *ga_index)
+{
+  free(ga_index->entries);
+  ga_index->entries = NULL;
+  ga_index->len = 0;
+  ga_index->size = 0;
+  ga_index->valid = false;
+}
+
+static bool
+oc_rp_ga_index_build(oc_rp_ga_index_t *ga_index)
+{
+  oc_group_rp_table_t *rp_table = ga_index->rp_table;
+  int nr_ga = 0;
+  for (int i = 0; i < ga_index->max_size; i++) {
+    if (rp_table[i].id > -1) {
+      nr_ga += rp_table[i].ga_len;
+    }
+  }
+  if (nr_ga > ga_index->size) {
+    oc_rp_ga_index_entry_t *new_entries =
+      (oc_rp_ga_index_entry_t *)malloc(nr_ga * sizeof(oc_rp_ga_index_entry_t));
+    if (new_entries == NULL) {
+      OC_ERR("out of memory: recipient/publisher group address index");
+      return false;
+    }
+    free(ga_index->entries);
+    ga_index->entries = new_entries;
+    ga_index->size = nr_ga;
+  }
+
+  /* insertion sort: the table is small and only rebuilt on changes */
+  oc_rp_ga_index_entry_t *entries = ga_index->entries;
+  int len = 0;
+  for (int i = 0; i < ga_index->max_size; i++) {
+    if (rp_table[i].id < 0) {
+      continue;
+    }
+    for (int j = 0; j < rp_table[i].ga_len; j++) {
+      uint32_t ga = rp_table[i].ga[j];
+      int pos = len;
+      while (pos > 0 && oc_got_ga_index_less(ga, i, entries[pos - 1].ga,
+                                             entries[pos - 1].index)) {
+        pos--;
+      }
+      if (pos > 0 && entries[pos - 1].ga == ga && entries[pos - 1].index == i) {
+        /* same group address listed twice in the entry */
+        continue;
+      }
+      memmove(&entries[pos + 1], &entries[pos],
+              (len - pos) * sizeof(oc_rp_ga_index_entry_t));
+      entries[pos].ga = ga;
+      entries[pos].index = i;
+      len++;
+    }
+  }
+  ga_index->len = len;
+  ga_index->valid = true;
+  return true;
+}
+
+/* returns the first table index >= min_index that has the group address,
+   or -1 */
+static int
+oc_rp_ga_index_find(oc_group_rp_table_t *rp_table, int max_size,
+                    uint32_t group_address, int min_index)
+{
+  oc_rp_ga_index_t *ga_index = oc_rp_ga_index_of_table(rp_table);
+  if (ga_index == NULL ||
+      (ga_index->valid == false && oc_rp_ga_index_build(ga_index) == false)) {
+    /* not an indexed table or no memory for the index, scan the table */
+    for (int i = min_index; i < max_size; i++) {
+      if (rp_table[i].id > -1 &&
+          is_in_array(group_address, rp_table[i].ga, rp_table[i].ga_len)) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  /* lower bound of (group_address, min_index) */
+  int low = 0;
+  int high = ga_index->len;
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (oc_got_ga_index_less(ga_index->entries[mid].ga,
+                             ga_index->entries[mid].index, group_address,
+                             min_index)) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  if (low < ga_index->len && ga_index->entries[low].ga == group_address) {
+    return ga_index->entries[low].index;
+  }
+  return -1;
+}
+
+int
+oc_core_find_recipient_table_index(uint32_t group_address)
+{
+  return oc_rp_ga_index_find(g_grt, GRT_MAX_ENTRIES, group_address, 0);
+}
+
+int
+oc_core_find_next_recipient_table_index(uint32_t group_address, int cur_index)
+{
+  if (cur_index == -1) {
+    return -1;
+  }
+  return oc_rp_ga_index_find(g_grt, GRT_MAX_ENTRIES, group_address,
+                             cur_index + 1);
+}
+
 // -----------------------------------------------------------------------------
 
 static void oc_print_group_rp_table_entry(int entry, char *Store,
@@ -153,24 +1093,14 @@ oc_core_set_group_object_table(int index, oc_group_object_table_t entry)
   g_got[index].cflags = entry.cflags;
   g_got[index].id = entry.id;
 
-  oc_free_string(&g_got[index].href);
-  oc_new_string(&g_got[index].href, oc_string(entry.href),
-                oc_string_len(entry.href));
+  oc_fp_set_string(&g_got[index].href, oc_string(entry.href),
+                 oc_string_len(entry.href));
   /* copy the ga array */
-  g_got[index].ga_len = 0;
-  uint32_t *new_array = (uint32_t *)malloc(entry.ga_len * sizeof(uint32_t));
-
-  if ((new_array != NULL) && (entry.id > -1)) {
-    for (int i = 0; i < entry.ga_len; i++) {
-#pragma warning(suppress : 6386)
-      new_array[i] = entry.ga[i];
-    }
-    if (g_got[index].ga != 0) {
-      free(g_got[index].ga);
-    }
-    g_got[index].ga_len = entry.ga_len;
-    g_got[index].ga = new_array;
+  if (entry.id > -1) {
+    oc_fp_set_ga(&g_got[index].ga, &g_got[index].ga_len, entry.ga,
+                 entry.ga_len);
   }
+  oc_core_group_object_table_changed();
   return 0;
 }
 
@@ -206,18 +1136,7 @@ oc_core_find_index_in_group_object_table_from_id(int id)
 int
 oc_core_find_group_object_table_index(uint32_t group_address)
 {
-  int i, j;
-  for (i = 0; i < GOT_MAX_ENTRIES; i++) {
-
-    if (g_got[i].id > -1) {
-      for (j = 0; j < g_got[i].ga_len; j++) {
-        if (group_address == g_got[i].ga[j]) {
-          return i;
-        }
-      }
-    }
-  }
-  return -1;
+  return oc_got_ga_index_find(group_address, 0);
 }
 
 int
@@ -228,18 +1147,7 @@ oc_core_find_next_group_object_table_index(uint32_t group_address,
     return -1;
   }
 
-  int i, j;
-  for (i = cur_index + 1; i < GOT_MAX_ENTRIES; i++) {
-
-    if (g_got[i].id > -1) {
-      for (j = 0; j < g_got[i].ga_len; j++) {
-        if (group_address == g_got[i].ga[j]) {
-          return i;
-        }
-      }
-    }
-  }
-  return -1;
+  return oc_got_ga_index_find(group_address, cur_index + 1);
 }
 
 oc_string_t
@@ -457,15 +1365,392 @@ oc_core_fp_g_get_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
       }
     }
   }
-
-  if (more_request_needed) {
-    int next_page_num = query_pn > -1 ? query_pn + 1 : 1;
-    response_length +=
-      add_next_page_indicator(oc_string(request->resource->uri), next_page_num);
-  }
-  oc_send_linkformat_response(request, OC_STATUS_OK, response_length);
-
-  PRINT("oc_core_fp_g_get_handler - end\n");
+
+  if (more_request_needed) {
+    int next_page_num = query_pn > -1 ? query_pn + 1 : 1;
+    response_length +=
+      add_next_page_indicator(oc_string(request->resource->uri), next_page_num);
+  }
+  oc_send_linkformat_response(request, OC_STATUS_OK, response_length);
+
+  PRINT("oc_core_fp_g_get_handler - end\n");
+}
+
+// -----------------------------------------------------------------------------
+// streaming decoding of the table entries of a POST request
+//
+// the /fp/g, /fp/r and /fp/p resources have the OC_RAW_PAYLOAD property, so
+// the request payload is not parsed into a tree of oc_rep_t objects.
+// instead the handlers walk the (reassembled) payload with a CborValue
+// iterator and store the values directly in the tables.
+// the memory needed does not depend on the number of entries in the request.
+
+#define OC_FP_CBOR_NAME_SIZE (8)
+
+/* information collected while decoding an entry of a table */
+typedef struct oc_fp_cbor_entry_t
+{
+  int mandatory_items;    /**< number of mandatory items found */
+  bool id_only;           /**< the entry only contains the id */
+  bool identifier_exists; /**< one of ia, grpid or url found */
+  bool out_of_memory;     /**< a value could not be stored */
+} oc_fp_cbor_entry_t;
+
+/* checks the payload and enters the top level array */
+static bool
+oc_fp_cbor_enter_array(oc_request_t *request, CborParser *parser,
+                       CborValue *array)
+{
+  CborValue root;
+  if (request->_payload == NULL || request->_payload_len == 0 ||
+      (request->content_format != APPLICATION_CBOR &&
+       request->content_format != APPLICATION_OSCORE)) {
+    OC_ERR("  no cbor payload");
+    return false;
+  }
+  CborError err = cbor_parser_init(request->_payload, request->_payload_len,
+                                   0, parser, &root);
+  if (err == CborNoError) {
+    err = cbor_value_validate_basic(&root);
+  }
+  if (err != CborNoError || !cbor_value_is_array(&root)) {
+    OC_ERR("  invalid payload, tinyCBOR error code: %d", err);
+    return false;
+  }
+  return cbor_value_enter_container(&root, array) == CborNoError;
+}
+
+/* reads the key of a map item and moves the iterator to the value
+ * integer keys are returned in iname, text keys (e.g. "non") in name */
+static CborError
+oc_fp_cbor_get_key(CborValue *map, int *iname, char *name, size_t name_size)
+{
+  CborError err = CborNoError;
+  *iname = -1;
+  if (name) {
+    name[0] = '\0';
+  }
+  if (cbor_value_is_integer(map)) {
+    err = cbor_value_get_int(map, iname);
+  } else if (cbor_value_is_text_string(map)) {
+    size_t len = 0;
+    if (name) {
+      err = cbor_value_calculate_string_length(map, &len);
+    }
+    if (name && err == CborNoError) {
+      // longer names are cut off, the names are compared by their prefix
+      char *buf = name;
+      if (++len > name_size) {
+        buf = malloc(len);
+      }
+      if (buf && cbor_value_copy_text_string(map, buf, &len, NULL) ==
+                   CborNoError) {
+        if (buf != name) {
+          strncpy(name, buf, name_size - 1);
+          name[name_size - 1] = '\0';
+        }
+      }
+      if (buf != name) {
+        free(buf);
+      }
+    }
+  } else {
+    return CborErrorIllegalType;
+  }
+  if (err == CborNoError) {
+    err = cbor_value_advance(map);
+  }
+  /* skip over CBOR Tags */
+  while (err == CborNoError && cbor_value_is_tag(map)) {
+    err = cbor_value_skip_tag(map);
+  }
+  return err;
+}
+
+/* returns the id (0) of the entry, -1 if the entry does not have an id */
+static int
+oc_fp_cbor_find_id(const CborValue *entry)
+{
+  CborValue map;
+  int iname;
+  if (cbor_value_enter_container(entry, &map) != CborNoError) {
+    return -1;
+  }
+  while (!cbor_value_at_end(&map)) {
+    if (oc_fp_cbor_get_key(&map, &iname, NULL, 0) != CborNoError) {
+      return -1;
+    }
+    if (iname == 0 && cbor_value_is_integer(&map)) {
+      int64_t id = -1;
+      cbor_value_get_int64(&map, &id);
+      PRINT(" oc_fp_cbor_find_id id=%d \n", (int)id);
+      return (int)id;
+    }
+    if (cbor_value_advance(&map) != CborNoError) {
+      return -1;
+    }
+  }
+  PRINT("  oc_fp_cbor_find_id ERR: id=-1 \n");
+  return -1;
+}
+
+/* stores the text string in str, does not advance the iterator */
+static CborError
+oc_fp_cbor_get_string(const CborValue *value, oc_string_t *str,
+                      bool *out_of_memory)
+{
+  char short_buf[OC_MAX_URL_LENGTH + 1];
+  char *buf = short_buf;
+  size_t len = 0;
+  CborError err = cbor_value_calculate_string_length(value, &len);
+  if (err != CborNoError) {
+    return err;
+  }
+  len++;
+  if (len > sizeof(short_buf)) {
+    buf = malloc(len);
+    if (buf == NULL) {
+      OC_ERR("out of memory");
+      *out_of_memory = true;
+      return CborNoError;
+    }
+  }
+  err = cbor_value_copy_text_string(value, buf, &len, NULL);
+  if (err == CborNoError) {
+    if (!oc_fp_set_string(str, buf, len)) {
+      *out_of_memory = true;
+    }
+  }
+  if (buf != short_buf) {
+    free(buf);
+  }
+  return err;
+}
+
+/* stores the integers of the array as group addresses, does not advance the
+ * iterator. the number of group addresses is returned in len, an array
+ * without integers does not change the group addresses. */
+static CborError
+oc_fp_cbor_get_ga(const CborValue *value, uint32_t **ga, int *ga_len, int *len,
+                  bool *out_of_memory)
+{
+  CborValue array;
+  *len = 0;
+  CborError err = cbor_value_enter_container(value, &array);
+  while (err == CborNoError && !cbor_value_at_end(&array)) {
+    if (cbor_value_is_integer(&array)) {
+      (*len)++;
+    }
+    err = cbor_value_advance(&array);
+  }
+  if (err != CborNoError || *len == 0) {
+    return err;
+  }
+
+  uint32_t *new_ga = oc_fp_ga_alloc(*len);
+  if (new_ga == NULL) {
+    OC_ERR("out of memory");
+    *out_of_memory = true;
+    return CborNoError;
+  }
+  int i = 0;
+  err = cbor_value_enter_container(value, &array);
+  while (err == CborNoError && !cbor_value_at_end(&array)) {
+    if (cbor_value_is_integer(&array)) {
+      int64_t group_address = 0;
+      err = cbor_value_get_int64(&array, &group_address);
+      new_ga[i++] = (uint32_t)group_address;
+    }
+    if (err == CborNoError) {
+      err = cbor_value_advance(&array);
+    }
+  }
+  if (err != CborNoError) {
+    oc_fp_ga_release(new_ga, *len);
+    return err;
+  }
+  oc_fp_assign_ga(ga, ga_len, new_ga, *len);
+  return err;
+}
+
+/* converts the array of cflag values to the cflags bitmap, does not advance
+ * the iterator. the number of values is returned in len. */
+static CborError
+oc_fp_cbor_get_cflags(const CborValue *value, oc_cflag_mask_t *cflags,
+                      int *len)
+{
+  CborValue array;
+  oc_cflag_mask_t new_cflags = OC_CFLAG_NONE;
+  *len = 0;
+  CborError err = cbor_value_enter_container(value, &array);
+  while (err == CborNoError && !cbor_value_at_end(&array)) {
+    if (cbor_value_is_integer(&array)) {
+      int flag = 0;
+      err = cbor_value_get_int(&array, &flag);
+      (*len)++;
+      if (flag == 1) {
+        new_cflags += OC_CFLAG_READ;
+      } else if (flag == 2) {
+        new_cflags += OC_CFLAG_WRITE;
+      } else if (flag == 3) {
+        new_cflags += OC_CFLAG_TRANSMISSION;
+      } else if (flag == 4) {
+        new_cflags += OC_CFLAG_UPDATE;
+      } else if (flag == 5) {
+        new_cflags += OC_CFLAG_INIT;
+      }
+    }
+    if (err == CborNoError) {
+      err = cbor_value_advance(&array);
+    }
+  }
+  if (err == CborNoError && *len > 0) {
+    *cflags = new_cflags;
+  }
+  return err;
+}
+
+/* decodes an entry of the /fp/g request into the Group Object Table */
+static CborError
+oc_fp_cbor_decode_got_entry(const CborValue *entry, int index,
+                            oc_fp_cbor_entry_t *info)
+{
+  CborValue map;
+  int iname;
+  int len;
+  CborError err = cbor_value_enter_container(entry, &map);
+  while (err == CborNoError && !cbor_value_at_end(&map)) {
+    err = oc_fp_cbor_get_key(&map, &iname, NULL, 0);
+    if (err != CborNoError) {
+      break;
+    }
+    if (cbor_value_is_text_string(&map)) {
+      info->id_only = false;
+      if (iname == 11) {
+        // href (11)
+        info->mandatory_items++;
+        err = oc_fp_cbor_get_string(&map, &g_got[index].href,
+                                    &info->out_of_memory);
+      }
+    } else if (cbor_value_is_integer(&map)) {
+      int64_t value = 0;
+      err = cbor_value_get_int64(&map, &value);
+      if (iname == 0) {
+        // id (0)
+        info->mandatory_items++;
+        g_got[index].id = (int)value;
+      }
+      if (iname == 8) {
+        // cflags (8)
+        info->mandatory_items++;
+        info->id_only = false;
+        g_got[index].cflags = (oc_cflag_mask_t)value;
+      }
+    } else if (cbor_value_is_array(&map)) {
+      if (iname == 8) {
+        // cflags (8)
+        err = oc_fp_cbor_get_cflags(&map, &g_got[index].cflags, &len);
+        if (len > 0) {
+          info->mandatory_items++;
+          info->id_only = false;
+        }
+      }
+      if (iname == 7) {
+        // ga (7)
+        err = oc_fp_cbor_get_ga(&map, &g_got[index].ga, &g_got[index].ga_len,
+                                &len, &info->out_of_memory);
+        if (len > 0) {
+          info->mandatory_items++;
+          info->id_only = false;
+        }
+      }
+    }
+    if (err == CborNoError) {
+      err = cbor_value_advance(&map);
+    }
+  }
+  return err;
+}
+
+/* decodes an entry of the /fp/r or /fp/p request into the rp table entry.
+ * the unicast options (non, mt) are only used for the recipient table */
+static CborError
+oc_fp_cbor_decode_rp_entry(const CborValue *entry,
+                           oc_group_rp_table_t *rp_entry, bool unicast_options,
+                           oc_fp_cbor_entry_t *info)
+{
+  CborValue map;
+  int iname;
+  int len;
+  char name[OC_FP_CBOR_NAME_SIZE];
+  CborError err = cbor_value_enter_container(entry, &map);
+  while (err == CborNoError && !cbor_value_at_end(&map)) {
+    err = oc_fp_cbor_get_key(&map, &iname, name, sizeof(name));
+    if (err != CborNoError) {
+      break;
+    }
+    if (cbor_value_is_boolean(&map)) {
+      if (unicast_options && strncmp(name, "non", 3) == 0) {
+        err = cbor_value_get_boolean(&map, &rp_entry->non);
+      }
+    } else if (cbor_value_is_integer(&map)) {
+      int64_t value = 0;
+      err = cbor_value_get_int64(&map, &value);
+      if (iname == 0) {
+        info->mandatory_items++;
+      } else {
+        info->id_only = false;
+      }
+      if (iname == 12) {
+        info->identifier_exists = true;
+        rp_entry->ia = (int)value;
+      }
+      if (iname == 13) {
+        info->identifier_exists = true;
+        rp_entry->grpid = (uint32_t)value;
+      }
+      if (iname == 26) {
+        rp_entry->iid = value;
+      }
+      if (iname == 25) {
+        rp_entry->fid = value;
+      }
+      if (unicast_options && strncmp(name, "mt", 2) == 0) {
+        rp_entry->mt = (int)value;
+      }
+    } else if (cbor_value_is_text_string(&map)) {
+      info->id_only = false;
+      if (iname == 112) {
+        err = oc_fp_cbor_get_string(&map, &rp_entry->path,
+                                    &info->out_of_memory);
+      }
+      if (iname == 10) {
+        info->identifier_exists = true;
+        err =
+          oc_fp_cbor_get_string(&map, &rp_entry->url, &info->out_of_memory);
+      }
+      if (iname == 14) {
+        err = oc_fp_cbor_get_string(&map, &rp_entry->at, &info->out_of_memory);
+      }
+    } else if (cbor_value_is_array(&map)) {
+      if (iname == 7) {
+        info->mandatory_items++;
+        err = oc_fp_cbor_get_ga(&map, &rp_entry->ga, &rp_entry->ga_len, &len,
+                                &info->out_of_memory);
+        if (len > 0) {
+          info->id_only = false;
+        }
+      }
+    } else if (cbor_value_is_null(&map)) {
+      if (iname == 7) {
+        info->mandatory_items++;
+      }
+    }
+    if (err == CborNoError) {
+      err = cbor_value_advance(&map);
+    }
+  }
+  return err;
 }
 
 static bool
@@ -532,20 +1817,21 @@ oc_core_fp_g_post_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
     return;
   }
 
-  /* debugging info */
-  oc_print_rep_as_json(request->request_payload, true);
+  CborParser parser;
+  CborValue entry;
+  if (oc_fp_cbor_enter_array(request, &parser, &entry) == false) {
+    oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
+    return;
+  }
 
   int index = -1;
   int id;
-  oc_rep_t *rep = request->request_payload;
-
-  while (rep != NULL) {
-    switch (rep->type) {
-    case OC_REP_OBJECT: {
+  CborError err = CborNoError;
 
+  while (err == CborNoError && !cbor_value_at_end(&entry)) {
+    if (cbor_value_is_map(&entry)) {
       // find id and the storage index for this object
-      oc_rep_t *object = rep->value.object;
-      id = oc_table_find_id_from_rep(object);
+      id = oc_fp_cbor_find_id(&entry);
       if (id == -1) {
         OC_ERR("  ERROR id %d", index);
         oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
@@ -566,90 +1852,27 @@ oc_core_fp_g_post_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
         }
       }
 
-      bool id_only = true;
-      int mandatory_items =
-        0; // Needs to be 4 for creating new entry, i.e. id, ga, cflag & href
-      object = rep->value.object;
-      while (object != NULL) {
-        switch (object->type) {
-        case OC_REP_STRING: {
-          id_only = false;
-          if (object->iname == 11) {
-            // href (11)
-            mandatory_items++;
-            oc_free_string(&g_got[index].href);
-            oc_new_string(&g_got[index].href, oc_string(object->value.string),
-                          oc_string_len(object->value.string));
-          }
-        } break;
-        case OC_REP_INT: {
-          if (oc_string_len(object->name) == 0 && object->iname == 0) {
-            // id (0)
-            mandatory_items++;
-            g_got[index].id = (int)object->value.integer;
-          }
-          if (oc_string_len(object->name) == 0 && object->iname == 8) {
-            // cflags (8)
-            mandatory_items++;
-            id_only = false;
-            g_got[index].cflags = object->value.integer;
-          }
-        } break;
-        case OC_REP_INT_ARRAY: {
-          id_only = false;
-          if (object->iname == 8) {
-            // cflags (8)
-            mandatory_items++;
-            g_got[index].cflags = OC_CFLAG_NONE;
-            int64_t *arr = oc_int_array(object->value.array);
-            for (int i = 0; i < (int)oc_int_array_size(object->value.array);
-                 i++) {
-              if (arr[i] == 1) {
-                g_got[index].cflags += OC_CFLAG_READ;
-              } else if (arr[i] == 2) {
-                g_got[index].cflags += OC_CFLAG_WRITE;
-              } else if (arr[i] == 3) {
-                g_got[index].cflags += OC_CFLAG_TRANSMISSION;
-              } else if (arr[i] == 4) {
-                g_got[index].cflags += OC_CFLAG_UPDATE;
-              } else if (arr[i] == 5) {
-                g_got[index].cflags += OC_CFLAG_INIT;
-              }
-            }
-          }
-          if (object->iname == 7) {
-            // ga (7)
-            mandatory_items++;
-            int64_t *arr = oc_int_array(object->value.array);
-            int array_size = (int)oc_int_array_size(object->value.array);
-            uint32_t *new_array =
-              (uint32_t *)malloc(array_size * sizeof(uint32_t));
-            if (new_array) {
-              for (int i = 0; i < array_size; i++) {
-                new_array[i] = (uint32_t)arr[i];
-              }
-              if (g_got[index].ga != 0) {
-                free(g_got[index].ga);
-              }
-              g_got[index].ga_len = array_size;
-              g_got[index].ga = new_array;
-            } else {
-              OC_ERR("out of memory");
-              return_status = OC_STATUS_INTERNAL_SERVER_ERROR;
-            }
-          }
-        } break;
-        default:
-          break;
-        } // switch
-
-        object = object->next;
-      } // next object in array
-      if (id_only) {
+      // Needs 4 mandatory items for creating new entry, i.e. id, ga, cflag &
+      // href
+      oc_fp_cbor_entry_t info = { 0, true, false, false };
+      err = oc_fp_cbor_decode_got_entry(&entry, index, &info);
+      if (info.out_of_memory) {
+        return_status = OC_STATUS_INTERNAL_SERVER_ERROR;
+      }
+      if (err != CborNoError) {
+        OC_ERR("  ERROR decoding entry at index %d: %d", index, err);
+        if (return_status == OC_STATUS_CREATED) {
+          oc_delete_group_object_table_entry(index);
+        }
+        status_ok = false;
+        break;
+      }
+      if (info.id_only) {
         PRINT("  only found id in request, deleting entry at index: %d\n",
               index);
         oc_delete_group_object_table_entry(index);
-      } else if (return_status == OC_STATUS_CREATED && mandatory_items != 4) {
+      } else if (return_status == OC_STATUS_CREATED &&
+                 info.mandatory_items != 4) {
         PRINT("Mandatory items missing!\n");
         oc_delete_group_object_table_entry(index);
         oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
@@ -659,11 +1882,10 @@ oc_core_fp_g_post_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
         status_ok = oc_fp_g_check_and_save(index, device_index, status_ok);
       }
     }
-    default:
-      break;
-    } // object level
-    rep = rep->next;
-  } // top level
+    err = cbor_value_advance(&entry);
+  }
+
+  oc_core_group_object_table_changed();
 
   PRINT("oc_core_fp_g_post_handler status=%d - end\n", (int)status_ok);
   if (status_ok) {
@@ -676,8 +1898,9 @@ oc_core_fp_g_post_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
 
 OC_CORE_CREATE_CONST_RESOURCE_LINKED(knx_fp_g, knx_fp_g_x, 0, "/fp/g",
                                      OC_IF_C | OC_IF_B, APPLICATION_CBOR,
-                                     OC_DISCOVERABLE, oc_core_fp_g_get_handler,
-                                     0, oc_core_fp_g_post_handler, 0, NULL,
+                                     OC_DISCOVERABLE | OC_RAW_PAYLOAD,
+                                     oc_core_fp_g_get_handler, 0,
+                                     oc_core_fp_g_post_handler, 0, NULL,
                                      OC_SIZE_MANY(1), "urn:knx:if.c");
 
 void
@@ -685,7 +1908,7 @@ oc_create_fp_g_resource(int resource_idx, size_t device)
 {
   OC_DBG("oc_create_fp_g_resource\n");
   oc_core_populate_resource(resource_idx, device, "/fp/g", OC_IF_C | OC_IF_B,
-                            APPLICATION_CBOR, OC_DISCOVERABLE,
+                            APPLICATION_CBOR, OC_DISCOVERABLE | OC_RAW_PAYLOAD,
                             oc_core_fp_g_get_handler, 0,
                             oc_core_fp_g_post_handler, 0, 1, "urn:knx:if.c");
 }
@@ -809,18 +2032,7 @@ oc_create_fp_g_x_resource(int resource_idx, size_t device)
 int
 oc_core_find_publisher_table_index(uint32_t group_address)
 {
-  int i, j;
-  for (i = 0; i < GPT_MAX_ENTRIES; i++) {
-
-    if (g_gpt[i].id > -1) {
-      for (j = 0; j < g_gpt[i].ga_len; j++) {
-        if (group_address == g_gpt[i].ga[j]) {
-          return i;
-        }
-      }
-    }
-  }
-  return -1;
+  return oc_rp_ga_index_find(g_gpt, GPT_MAX_ENTRIES, group_address, 0);
 }
 
 oc_string_t
@@ -950,18 +2162,26 @@ oc_core_fp_p_post_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
     return;
   }
 
-  oc_print_rep_as_json(request->request_payload, true);
+  CborParser parser;
+  CborValue entry;
+  if (oc_fp_cbor_enter_array(request, &parser, &entry) == false) {
+    oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
+    return;
+  }
 
   int index = -1;
-  int id;
-  oc_rep_t *rep = request->request_payload;
-
-  while (rep != NULL) {
-    switch (rep->type) {
-    case OC_REP_OBJECT: {
-      /* find the storage index, e.g. for this object */
-      oc_rep_t *object = rep->value.object;
-      id = oc_table_find_id_from_rep(object);
+  int id = -1;
+  CborError err = CborNoError;
+
+  while (err == CborNoError && !cbor_value_at_end(&entry)) {
+    if (cbor_value_is_map(&entry)) {
+      // find the storage index, e.g. for this object
+      id = oc_fp_cbor_find_id(&entry);
+      if (id == -1) {
+        OC_ERR("  ERROR id %d", index);
+        oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
+        return;
+      }
       index = oc_core_find_index_in_rp_table_from_id(
         id, g_gpt, oc_core_get_publisher_table_size());
       if (index != -1) {
@@ -980,93 +2200,28 @@ oc_core_fp_p_post_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
       }
       g_gpt[index].id = id;
 
-      bool id_only = true;
-      int mandatory_items = 0; // Needs to be 2 for creating entry, i.e. id & ga
-      bool identifier_exists = false; // Once of ia, grpid or url
-      object = rep->value.object;
-      while (object != NULL) {
-        switch (object->type) {
-        case OC_REP_INT: {
-          if (object->iname == 0) {
-            mandatory_items++;
-          } else {
-            id_only = false;
-          }
-          if (object->iname == 12) {
-            identifier_exists = true;
-            g_gpt[index].ia = (int)object->value.integer;
-          }
-          if (object->iname == 13) {
-            identifier_exists = true;
-            g_gpt[index].grpid = (uint32_t)object->value.integer;
-          }
-          if (object->iname == 26) {
-            g_gpt[index].iid = object->value.integer;
-          }
-          if (object->iname == 25) {
-            g_gpt[index].fid = object->value.integer;
-          }
-        } break;
-        case OC_REP_STRING: {
-          id_only = false;
-          if (object->iname == 112) {
-            oc_free_string(&g_gpt[index].path);
-            oc_new_string(&g_gpt[index].path, oc_string(object->value.string),
-                          oc_string_len(object->value.string));
-          }
-          if (object->iname == 10) {
-            identifier_exists = true;
-            oc_free_string(&g_gpt[index].url);
-            oc_new_string(&g_gpt[index].url, oc_string(object->value.string),
-                          oc_string_len(object->value.string));
-          }
-          if (object->iname == 14) {
-            oc_free_string(&g_gpt[index].at);
-            oc_new_string(&g_gpt[index].at, oc_string(object->value.string),
-                          oc_string_len(object->value.string));
-          }
-        } break;
-        case OC_REP_INT_ARRAY: {
-          id_only = false;
-          if (object->iname == 7) {
-            mandatory_items++;
-            // g_got[index].id = object->value.integer;
-            int64_t *arr = oc_int_array(object->value.array);
-            int array_size = (int)oc_int_array_size(object->value.array);
-            uint32_t *new_array =
-              (uint32_t *)malloc(array_size * sizeof(uint32_t));
-            if (new_array) {
-              for (int i = 0; i < array_size; i++) {
-                new_array[i] = (uint32_t)arr[i];
-              }
-              if (g_gpt[index].ga != 0) {
-                free(g_gpt[index].ga);
-              }
-              g_gpt[index].ga_len = array_size;
-              g_gpt[index].ga = new_array;
-            } else {
-              OC_ERR("out of memory");
-              return_status = OC_STATUS_INTERNAL_SERVER_ERROR;
-            }
-          }
-        } break;
-        case OC_REP_NIL: {
-          if (object->iname == 7) {
-            mandatory_items++;
-          }
-        } break;
-        default:
-          break;
+      // Needs 2 mandatory items for creating entry, i.e. id & ga
+      // and one of ia, grpid or url as identifier
+      oc_fp_cbor_entry_t info = { 0, true, false, false };
+      err = oc_fp_cbor_decode_rp_entry(&entry, &g_gpt[index], false, &info);
+      if (info.out_of_memory) {
+        return_status = OC_STATUS_INTERNAL_SERVER_ERROR;
+      }
+      if (err != CborNoError) {
+        OC_ERR("  ERROR decoding entry at index %d: %d", index, err);
+        if (return_status == OC_STATUS_CREATED) {
+          oc_delete_group_rp_table_entry(index, GPT_STORE, g_gpt,
+                                         GPT_MAX_ENTRIES);
         }
-        object = object->next;
+        break;
       }
-      if (id_only) {
+      if (info.id_only) {
         PRINT("  only found id in request, deleting entry at index: %d\n",
               index);
         oc_delete_group_rp_table_entry(index, GPT_STORE, g_gpt,
                                        GPT_MAX_ENTRIES);
       } else if (return_status == OC_STATUS_CREATED &&
-                 (mandatory_items != 2 || !identifier_exists)) {
+                 (info.mandatory_items != 2 || !info.identifier_exists)) {
         PRINT("Mandatory items missing!\n");
         oc_delete_group_rp_table_entry(index, GPT_STORE, g_gpt,
                                        GPT_MAX_ENTRIES);
@@ -1092,15 +2247,16 @@ oc_core_fp_p_post_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
                                        oc_core_get_publisher_table_size());
         }
       }
-    } break;
-    case OC_REP_NIL:
-      break;
-    default:
-      break;
     }
-    rep = rep->next;
-  };
+    err = cbor_value_advance(&entry);
+  }
+  if (err != CborNoError) {
+    oc_rp_table_changed(g_gpt);
+    oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
+    return;
+  }
 
+  oc_rp_table_changed(g_gpt);
   oc_knx_increase_fingerprint();
   PRINT("oc_core_fp_p_post_handler - end\n");
   oc_send_response_no_format(request, return_status);
@@ -1108,8 +2264,9 @@ oc_core_fp_p_post_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
 
 OC_CORE_CREATE_CONST_RESOURCE_LINKED(knx_fp_p, knx_fp_p_x, 0, "/fp/p",
                                      OC_IF_C | OC_IF_B, APPLICATION_CBOR,
-                                     OC_DISCOVERABLE, oc_core_fp_p_get_handler,
-                                     0, oc_core_fp_p_post_handler, 0, NULL,
+                                     OC_DISCOVERABLE | OC_RAW_PAYLOAD,
+                                     oc_core_fp_p_get_handler, 0,
+                                     oc_core_fp_p_post_handler, 0, NULL,
                                      OC_SIZE_MANY(1), "urn:knx:if.c");
 
 void
@@ -1117,7 +2274,7 @@ oc_create_fp_p_resource(int resource_idx, size_t device)
 {
   OC_DBG("oc_create_fp_p_resource\n");
   oc_core_populate_resource(resource_idx, device, "/fp/p", OC_IF_C | OC_IF_B,
-                            APPLICATION_CBOR, OC_DISCOVERABLE,
+                            APPLICATION_CBOR, OC_DISCOVERABLE | OC_RAW_PAYLOAD,
                             oc_core_fp_p_get_handler, 0,
                             oc_core_fp_p_post_handler, 0, 1, "urn:knx:if.c");
 }
@@ -1379,18 +2536,21 @@ oc_core_fp_r_post_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
     return;
   }
 
-  oc_print_rep_as_json(request->request_payload, true);
+  CborParser parser;
+  CborValue entry;
+  if (oc_fp_cbor_enter_array(request, &parser, &entry) == false) {
+    oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
+    return;
+  }
 
   int index = -1;
   int id = -1;
-  oc_rep_t *rep = request->request_payload;
+  CborError err = CborNoError;
 
-  while (rep != NULL) {
-    switch (rep->type) {
-    case OC_REP_OBJECT: {
+  while (err == CborNoError && !cbor_value_at_end(&entry)) {
+    if (cbor_value_is_map(&entry)) {
       // find the storage index, e.g. for this object
-      oc_rep_t *object = rep->value.object;
-      id = oc_table_find_id_from_rep(object);
+      id = oc_fp_cbor_find_id(&entry);
       if (id == -1) {
         OC_ERR("  ERROR id %d", index);
         oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
@@ -1417,106 +2577,28 @@ oc_core_fp_r_post_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
       }
       g_grt[index].id = id;
 
-      bool id_only = true;
-      int mandatory_items = 0; // Needs to be 2 for creating entry, i.e. id & ga
-      bool identifier_exists = false; // Once of ia, grpid or url
-      object = rep->value.object;
-      while (object != NULL) {
-        switch (object->type) {
-
-        case OC_REP_BOOL: {
-          if (oc_string_len(object->name) > 0 &&
-              strncmp(oc_string(object->name), "non", 3) == 0) {
-            g_grt[index].non = object->value.boolean;
-          }
-        } break;
-
-        case OC_REP_INT: {
-          if (object->iname == 0) {
-            mandatory_items++;
-          } else {
-            id_only = false;
-          }
-          if (object->iname == 12) {
-            identifier_exists = true;
-            g_grt[index].ia = (int)object->value.integer;
-          }
-          if (object->iname == 13) {
-            identifier_exists = true;
-            g_grt[index].grpid = (uint32_t)object->value.integer;
-          }
-          if (object->iname == 26) {
-            g_grt[index].iid = object->value.integer;
-          }
-          if (object->iname == 25) {
-            g_grt[index].fid = object->value.integer;
-          }
-          if (oc_string_len(object->name) > 0 &&
-              strncmp(oc_string(object->name), "mt", 2) == 0) {
-            g_grt[index].mt = object->value.integer;
-          }
-        } break;
-
-        case OC_REP_STRING: {
-          id_only = false;
-          if (object->iname == 112) {
-            oc_free_string(&g_grt[index].path);
-            oc_new_string(&g_grt[index].path, oc_string(object->value.string),
-                          oc_string_len(object->value.string));
-          }
-          if (object->iname == 10) {
-            identifier_exists = true;
-            oc_free_string(&g_grt[index].url);
-            oc_new_string(&g_grt[index].url, oc_string(object->value.string),
-                          oc_string_len(object->value.string));
-          }
-          if (object->iname == 14) {
-            oc_free_string(&g_grt[index].at);
-            oc_new_string(&g_grt[index].at, oc_string(object->value.string),
-                          oc_string_len(object->value.string));
-          }
-        } break;
-        case OC_REP_INT_ARRAY: {
-          id_only = false;
-          if (object->iname == 7) {
-            mandatory_items++;
-            // g_got[index].id = object->value.integer;
-            int64_t *arr = oc_int_array(object->value.array);
-            int array_size = (int)oc_int_array_size(object->value.array);
-            uint32_t *new_array =
-              (uint32_t *)malloc(array_size * sizeof(uint32_t));
-            if (new_array) {
-              for (int i = 0; i < array_size; i++) {
-                new_array[i] = (uint32_t)arr[i];
-              }
-              if (g_grt[index].ga != 0) {
-                free(g_grt[index].ga);
-              }
-              g_grt[index].ga_len = array_size;
-              g_grt[index].ga = new_array;
-            } else {
-              OC_ERR("out of memory");
-              return_status = OC_STATUS_INTERNAL_SERVER_ERROR;
-            }
-          }
-        } break;
-        case OC_REP_NIL: {
-          if (object->iname == 7) {
-            mandatory_items++;
-          }
-        } break;
-        default:
-          break;
+      // Needs 2 mandatory items for creating entry, i.e. id & ga
+      // and one of ia, grpid or url as identifier
+      oc_fp_cbor_entry_t info = { 0, true, false, false };
+      err = oc_fp_cbor_decode_rp_entry(&entry, &g_grt[index], true, &info);
+      if (info.out_of_memory) {
+        return_status = OC_STATUS_INTERNAL_SERVER_ERROR;
+      }
+      if (err != CborNoError) {
+        OC_ERR("  ERROR decoding entry at index %d: %d", index, err);
+        if (return_status == OC_STATUS_CREATED) {
+          oc_delete_group_rp_table_entry(index, GRT_STORE, g_grt,
+                                         GRT_MAX_ENTRIES);
         }
-        object = object->next;
+        break;
       }
-      if (id_only) {
+      if (info.id_only) {
         PRINT("  only found id in request, deleting entry at index: %d\n",
               index);
         oc_delete_group_rp_table_entry(index, GRT_STORE, g_grt,
                                        GRT_MAX_ENTRIES);
       } else if (return_status == OC_STATUS_CREATED &&
-                 (mandatory_items != 2 || !identifier_exists)) {
+                 (info.mandatory_items != 2 || !info.identifier_exists)) {
         PRINT("Mandatory items missing!\n");
         oc_delete_group_rp_table_entry(index, GRT_STORE, g_grt,
                                        GRT_MAX_ENTRIES);
@@ -1541,14 +2623,15 @@ oc_core_fp_r_post_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
         }
       }
     }
-    case OC_REP_NIL:
-      break;
-    default:
-      break;
-    }
-    rep = rep->next;
-  };
+    err = cbor_value_advance(&entry);
+  }
+  if (err != CborNoError) {
+    oc_rp_table_changed(g_grt);
+    oc_send_response_no_format(request, OC_STATUS_BAD_REQUEST);
+    return;
+  }
 
+  oc_rp_table_changed(g_grt);
   oc_knx_increase_fingerprint();
 
   PRINT("oc_core_fp_r_post_handler - end\n");
@@ -1557,15 +2640,16 @@ oc_core_fp_r_post_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
 
 OC_CORE_CREATE_CONST_RESOURCE_LINKED(knx_fp_r, knx_fp_r_x, 0, "/fp/r",
                                      OC_IF_C | OC_IF_B, APPLICATION_CBOR,
-                                     OC_DISCOVERABLE, oc_core_fp_r_get_handler,
-                                     0, oc_core_fp_r_post_handler, 0, NULL,
+                                     OC_DISCOVERABLE | OC_RAW_PAYLOAD,
+                                     oc_core_fp_r_get_handler, 0,
+                                     oc_core_fp_r_post_handler, 0, NULL,
                                      OC_SIZE_MANY(1), "urn:knx:if.c");
 void
 oc_create_fp_r_resource(int resource_idx, size_t device)
 {
   OC_DBG("oc_create_fp_r_resource\n");
   oc_core_populate_resource(resource_idx, device, "/fp/r", OC_IF_C | OC_IF_B,
-                            APPLICATION_CBOR, OC_DISCOVERABLE,
+                            APPLICATION_CBOR, OC_DISCOVERABLE | OC_RAW_PAYLOAD,
                             oc_core_fp_r_get_handler, 0,
                             oc_core_fp_r_post_handler, 0, 1, "urn:knx:if.c");
 }
@@ -1705,12 +2789,7 @@ oc_core_check_recipient_index_on_group_address(int index,
   if (group_address <= 0) {
     return -1;
   }
-  for (int i = 0; g_grt[index].ga_len; i++) {
-    if (g_grt[index].ga[i] == group_address) {
-      return true;
-    }
-  }
-  return false;
+  return is_in_array(group_address, g_grt[index].ga, g_grt[index].ga_len);
 }
 
 uint32_t
@@ -1734,7 +2813,7 @@ oc_core_get_recipient_index_url_or_path(int index)
     PRINT("oc_core_get_recipient_index_url_or_path: ia %d\n", g_grt[index].ia);
     if (oc_string_len(g_grt[index].path) > 0) {
       PRINT("      oc_core_get_recipient_index_url_or_path path %s\n",
-            oc_string_checked(g_grt[index].path));
+            oc_string(g_grt[index].path));
       return oc_string(g_grt[index].path);
 
     } else {
@@ -1749,7 +2828,7 @@ oc_core_get_recipient_index_url_or_path(int index)
     if (oc_string_len(g_grt[index].url) > 0) {
       //
       PRINT("      oc_core_get_recipient_index_url_or_path url %s\n",
-            oc_string_checked(g_grt[index].url));
+            oc_string(g_grt[index].url));
       return oc_string(g_grt[index].url);
     }
   }
@@ -1791,84 +2870,478 @@ oc_cflags_as_string(char *buffer, oc_cflag_mask_t cflags)
   }
 }
 
-void
-oc_print_cflags(oc_cflag_mask_t cflags)
+void
+oc_print_cflags(oc_cflag_mask_t cflags)
+{
+
+  if (cflags & OC_CFLAG_READ) {
+    PRINT("r");
+  }
+  if (cflags & OC_CFLAG_WRITE) {
+    PRINT("w");
+  }
+  if (cflags & OC_CFLAG_INIT) {
+    PRINT("i");
+  }
+  if (cflags & OC_CFLAG_TRANSMISSION) {
+    PRINT("t");
+  }
+  if (cflags & OC_CFLAG_UPDATE) {
+    PRINT("u");
+  }
+  PRINT("\n");
+}
+
+void
+oc_print_group_object_table_entry(int entry)
+{
+  if (g_got[entry].id == -1) {
+    return;
+  }
+
+  PRINT("    id (0)     : %d\n", g_got[entry].id);
+  PRINT("    href (11)  : %s\n", oc_string_checked(g_got[entry].href));
+  PRINT("    cflags (8) : %d string: ", g_got[entry].cflags);
+  oc_print_cflags(g_got[entry].cflags);
+  PRINT("    ga (7)     : [");
+  for (int i = 0; i < g_got[entry].ga_len; i++) {
+    PRINT(" %u", g_got[entry].ga[i]);
+  }
+  PRINT(" ]\n");
+}
+
+// -----------------------------------------------------------------------------
+// persistent storage of the tables
+//
+// each table is stored as one blob (one storage key), instead of one key per
+// entry. the blob starts with a header:
+// | magic (4) | version (1) | table (1) | count (2) | length (4) | crc32 (4) |
+// followed by "count" records, one for each used entry of the table.
+// all integers are stored little endian.
+// changes are collected: dumping an entry marks the table as dirty and the
+// dirty tables are written once, after the current request has been handled.
+// an empty table is stored as a blob without records (not erased), hence the
+// (old) per entry format is only searched for when there is no valid blob:
+// those tables are converted when they are loaded.
+
+#define OC_FP_BLOB_MAGIC (0x4B464254) /* "KFBT" */
+#define OC_FP_BLOB_VERSION (1)
+#define OC_FP_BLOB_HEADER_SIZE (16)
+
+typedef enum {
+  OC_FP_BLOB_GOT = 0, /**< group object table */
+  OC_FP_BLOB_GRT = 1, /**< group recipient table */
+  OC_FP_BLOB_GPT = 2, /**< group publisher table */
+  OC_FP_BLOB_NUM = 3
+} oc_fp_blob_table_t;
+
+static bool g_fp_blob_dirty[OC_FP_BLOB_NUM];
+static bool g_fp_blob_commit_scheduled = false;
+
+typedef struct oc_fp_blob_t
+{
+  uint8_t *buf; /**< the data */
+  size_t size;  /**< size of the data */
+  size_t pos;   /**< current read/write position */
+  bool error;   /**< read past the end of the data */
+} oc_fp_blob_t;
+
+static uint32_t
+oc_fp_blob_crc32(const uint8_t *data, size_t len)
+{
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int j = 0; j < 8; j++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+static void
+oc_fp_blob_put(oc_fp_blob_t *blob, uint64_t value, int nr_bytes)
+{
+  for (int i = 0; i < nr_bytes; i++) {
+    blob->buf[blob->pos++] = (uint8_t)(value >> (8 * i));
+  }
+}
+
+static void
+oc_fp_blob_put_data(oc_fp_blob_t *blob, const void *data, size_t len)
+{
+  if (len > 0) {
+    memcpy(&blob->buf[blob->pos], data, len);
+    blob->pos += len;
+  }
+}
+
+static uint64_t
+oc_fp_blob_get(oc_fp_blob_t *blob, int nr_bytes)
+{
+  uint64_t value = 0;
+  if (blob->pos + nr_bytes > blob->size) {
+    blob->error = true;
+    return 0;
+  }
+  for (int i = 0; i < nr_bytes; i++) {
+    value |= (uint64_t)blob->buf[blob->pos++] << (8 * i);
+  }
+  return value;
+}
+
+static const uint8_t *
+oc_fp_blob_get_data(oc_fp_blob_t *blob, size_t len)
+{
+  if (blob->pos + len > blob->size) {
+    blob->error = true;
+    return NULL;
+  }
+  const uint8_t *data = &blob->buf[blob->pos];
+  blob->pos += len;
+  return data;
+}
+
+/* reads the group addresses of a record into the table entry */
+static void
+oc_fp_blob_get_ga(oc_fp_blob_t *blob, uint32_t **ga, int *ga_len, int len)
+{
+  if (blob->pos + 4 * (size_t)len > blob->size) {
+    blob->error = true;
+    return;
+  }
+  uint32_t *new_ga = oc_fp_ga_alloc(len);
+  if (new_ga == NULL && len > 0) {
+    OC_ERR("out of memory");
+    blob->pos += 4 * (size_t)len;
+    return;
+  }
+  for (int i = 0; i < len; i++) {
+    new_ga[i] = (uint32_t)oc_fp_blob_get(blob, 4);
+  }
+  oc_fp_assign_ga(ga, ga_len, new_ga, len);
+}
+
+static void
+oc_fp_blob_get_string(oc_fp_blob_t *blob, oc_string_t *str, size_t len)
+{
+  const uint8_t *data = oc_fp_blob_get_data(blob, len);
+  if (data) {
+    oc_fp_set_string(str, (const char *)data, len);
+  }
+}
+
+/* writes the blob, returns 0 on success or -1 */
+static int
+oc_fp_blob_write(const char *store, oc_fp_blob_table_t table,
+                 oc_fp_blob_t *blob, int count)
+{
+  size_t len = blob->pos - OC_FP_BLOB_HEADER_SIZE;
+  uint32_t crc = oc_fp_blob_crc32(&blob->buf[OC_FP_BLOB_HEADER_SIZE], len);
+  blob->pos = 0;
+  oc_fp_blob_put(blob, OC_FP_BLOB_MAGIC, 4);
+  oc_fp_blob_put(blob, OC_FP_BLOB_VERSION, 1);
+  oc_fp_blob_put(blob, table, 1);
+  oc_fp_blob_put(blob, count, 2);
+  oc_fp_blob_put(blob, len, 4);
+  oc_fp_blob_put(blob, crc, 4);
+
+  size_t size = OC_FP_BLOB_HEADER_SIZE + len;
+  long written_size = oc_storage_write(store, blob->buf, size);
+  OC_DBG("oc_fp_blob_write: [%s] entries %d size %d", store, count, (int)size);
+  if (written_size != (long)size) {
+    OC_ERR("oc_fp_blob_write: %s written %d != %d (towrite)", store,
+           (int)written_size, (int)size);
+    return -1;
+  }
+  return 0;
+}
+
+/* reads and validates the blob, the returned buffer needs to be freed */
+static uint8_t *
+oc_fp_blob_read(const char *store, oc_fp_blob_table_t table, oc_fp_blob_t *blob,
+                int *count)
+{
+  uint8_t header[OC_FP_BLOB_HEADER_SIZE];
+  long ret = oc_storage_read(store, header, OC_FP_BLOB_HEADER_SIZE);
+  if (ret != OC_FP_BLOB_HEADER_SIZE) {
+    return NULL;
+  }
+  blob->buf = header;
+  blob->size = OC_FP_BLOB_HEADER_SIZE;
+  blob->pos = 0;
+  blob->error = false;
+  uint32_t magic = (uint32_t)oc_fp_blob_get(blob, 4);
+  uint8_t version = (uint8_t)oc_fp_blob_get(blob, 1);
+  uint8_t blob_table = (uint8_t)oc_fp_blob_get(blob, 1);
+  *count = (int)oc_fp_blob_get(blob, 2);
+  size_t len = (size_t)oc_fp_blob_get(blob, 4);
+  uint32_t crc = (uint32_t)oc_fp_blob_get(blob, 4);
+  if (magic != OC_FP_BLOB_MAGIC || version != OC_FP_BLOB_VERSION ||
+      blob_table != table) {
+    OC_ERR("oc_fp_blob_read: %s unknown format/version %d", store,
+           (int)version);
+    return NULL;
+  }
+
+  size_t size = OC_FP_BLOB_HEADER_SIZE + len;
+  uint8_t *buf = malloc(size);
+  if (!buf) {
+    OC_ERR("oc_fp_blob_read: out of memory %d", (int)size);
+    return NULL;
+  }
+  ret = oc_storage_read(store, buf, size);
+  if (ret != (long)size ||
+      oc_fp_blob_crc32(&buf[OC_FP_BLOB_HEADER_SIZE], len) != crc) {
+    OC_ERR("oc_fp_blob_read: %s corrupt (size %d)", store, (int)ret);
+    free(buf);
+    return NULL;
+  }
+  blob->buf = buf;
+  blob->size = size;
+  blob->pos = OC_FP_BLOB_HEADER_SIZE;
+  return buf;
+}
+
+static int
+oc_dump_group_object_table_blob(void)
+{
+  int count = 0;
+  size_t size = OC_FP_BLOB_HEADER_SIZE;
+  for (int i = 0; i < GOT_MAX_ENTRIES; i++) {
+    if (g_got[i].id > -1) {
+      count++;
+      size += 14 + oc_string_len(g_got[i].href) + 4 * g_got[i].ga_len;
+    }
+  }
+  /* an empty table is stored as an empty blob: only the header, so that the
+     old format is not searched for at the next start */
+  oc_fp_blob_t blob = { malloc(size), size, OC_FP_BLOB_HEADER_SIZE, false };
+  if (!blob.buf) {
+    OC_ERR("oc_dump_group_object_table_blob: out of memory %d", (int)size);
+    return -1;
+  }
+  for (int i = 0; i < GOT_MAX_ENTRIES; i++) {
+    if (g_got[i].id > -1) {
+      size_t href_len = oc_string_len(g_got[i].href);
+      oc_fp_blob_put(&blob, i, 2);
+      oc_fp_blob_put(&blob, (uint32_t)g_got[i].id, 4);
+      oc_fp_blob_put(&blob, g_got[i].cflags, 4);
+      oc_fp_blob_put(&blob, href_len, 2);
+      oc_fp_blob_put(&blob, g_got[i].ga_len, 2);
+      oc_fp_blob_put_data(&blob, oc_string(g_got[i].href), href_len);
+      for (int j = 0; j < g_got[i].ga_len; j++) {
+        oc_fp_blob_put(&blob, g_got[i].ga[j], 4);
+      }
+    }
+  }
+  int ret = oc_fp_blob_write(GOT_BLOB_STORE, OC_FP_BLOB_GOT, &blob, count);
+  free(blob.buf);
+  return ret;
+}
+
+static bool
+oc_load_group_object_table_blob(void)
+{
+  oc_fp_blob_t blob;
+  int count = 0;
+  uint8_t *buf =
+    oc_fp_blob_read(GOT_BLOB_STORE, OC_FP_BLOB_GOT, &blob, &count);
+  if (!buf) {
+    return false;
+  }
+  for (int n = 0; n < count && blob.error == false; n++) {
+    int index = (int)oc_fp_blob_get(&blob, 2);
+    int id = (int)(int32_t)oc_fp_blob_get(&blob, 4);
+    uint32_t cflags = (uint32_t)oc_fp_blob_get(&blob, 4);
+    size_t href_len = (size_t)oc_fp_blob_get(&blob, 2);
+    int ga_len = (int)oc_fp_blob_get(&blob, 2);
+    if (index >= GOT_MAX_ENTRIES || blob.error) {
+      OC_ERR("oc_load_group_object_table_blob: invalid index %d", index);
+      break;
+    }
+    g_got[index].id = id;
+    g_got[index].cflags = (oc_cflag_mask_t)cflags;
+    oc_fp_blob_get_string(&blob, &g_got[index].href, href_len);
+    oc_fp_blob_get_ga(&blob, &g_got[index].ga, &g_got[index].ga_len, ga_len);
+  }
+  free(buf);
+  oc_core_group_object_table_changed();
+  return true;
+}
+
+static int
+oc_dump_group_rp_table_blob(const char *store, oc_fp_blob_table_t table,
+                            oc_group_rp_table_t *rp_table, int max_size)
+{
+  int count = 0;
+  size_t size = OC_FP_BLOB_HEADER_SIZE;
+  for (int i = 0; i < max_size; i++) {
+    if (rp_table[i].id > -1) {
+      count++;
+      size += 43 + oc_string_len(rp_table[i].path) +
+              oc_string_len(rp_table[i].url) +
+              oc_string_len(rp_table[i].at) + 4 * rp_table[i].ga_len;
+    }
+  }
+  /* an empty table is stored as an empty blob, see the group object table */
+  oc_fp_blob_t blob = { malloc(size), size, OC_FP_BLOB_HEADER_SIZE, false };
+  if (!blob.buf) {
+    OC_ERR("oc_dump_group_rp_table_blob: out of memory %d", (int)size);
+    return -1;
+  }
+  for (int i = 0; i < max_size; i++) {
+    if (rp_table[i].id > -1) {
+      size_t path_len = oc_string_len(rp_table[i].path);
+      size_t url_len = oc_string_len(rp_table[i].url);
+      size_t at_len = oc_string_len(rp_table[i].at);
+      oc_fp_blob_put(&blob, i, 2);
+      oc_fp_blob_put(&blob, (uint32_t)rp_table[i].id, 4);
+      oc_fp_blob_put(&blob, (uint32_t)rp_table[i].ia, 4);
+      oc_fp_blob_put(&blob, (uint64_t)rp_table[i].iid, 8);
+      oc_fp_blob_put(&blob, (uint64_t)rp_table[i].fid, 8);
+      oc_fp_blob_put(&blob, rp_table[i].grpid, 4);
+      oc_fp_blob_put(&blob, (uint32_t)rp_table[i].mt, 4);
+      oc_fp_blob_put(&blob, rp_table[i].non, 1);
+      oc_fp_blob_put(&blob, path_len, 2);
+      oc_fp_blob_put(&blob, url_len, 2);
+      oc_fp_blob_put(&blob, at_len, 2);
+      oc_fp_blob_put(&blob, rp_table[i].ga_len, 2);
+      oc_fp_blob_put_data(&blob, oc_string(rp_table[i].path), path_len);
+      oc_fp_blob_put_data(&blob, oc_string(rp_table[i].url), url_len);
+      oc_fp_blob_put_data(&blob, oc_string(rp_table[i].at), at_len);
+      for (int j = 0; j < rp_table[i].ga_len; j++) {
+        oc_fp_blob_put(&blob, rp_table[i].ga[j], 4);
+      }
+    }
+  }
+  int ret = oc_fp_blob_write(store, table, &blob, count);
+  free(blob.buf);
+  return ret;
+}
+
+static bool
+oc_load_group_rp_table_blob(const char *store, oc_fp_blob_table_t table,
+                            oc_group_rp_table_t *rp_table, int max_size)
 {
-
-  if (cflags & OC_CFLAG_READ) {
-    PRINT("r");
-  }
-  if (cflags & OC_CFLAG_WRITE) {
-    PRINT("w");
-  }
-  if (cflags & OC_CFLAG_INIT) {
-    PRINT("i");
-  }
-  if (cflags & OC_CFLAG_TRANSMISSION) {
-    PRINT("t");
+  oc_fp_blob_t blob;
+  int count = 0;
+  uint8_t *buf = oc_fp_blob_read(store, table, &blob, &count);
+  if (!buf) {
+    return false;
   }
-  if (cflags & OC_CFLAG_UPDATE) {
-    PRINT("u");
+  for (int n = 0; n < count && blob.error == false; n++) {
+    int index = (int)oc_fp_blob_get(&blob, 2);
+    int id = (int)(int32_t)oc_fp_blob_get(&blob, 4);
+    int ia = (int)(int32_t)oc_fp_blob_get(&blob, 4);
+    int64_t iid = (int64_t)oc_fp_blob_get(&blob, 8);
+    int64_t fid = (int64_t)oc_fp_blob_get(&blob, 8);
+    uint32_t grpid = (uint32_t)oc_fp_blob_get(&blob, 4);
+    int mt = (int)(int32_t)oc_fp_blob_get(&blob, 4);
+    bool non = oc_fp_blob_get(&blob, 1) != 0;
+    size_t path_len = (size_t)oc_fp_blob_get(&blob, 2);
+    size_t url_len = (size_t)oc_fp_blob_get(&blob, 2);
+    size_t at_len = (size_t)oc_fp_blob_get(&blob, 2);
+    int ga_len = (int)oc_fp_blob_get(&blob, 2);
+    if (index >= max_size || blob.error) {
+      OC_ERR("oc_load_group_rp_table_blob: %s invalid index %d", store, index);
+      break;
+    }
+    rp_table[index].id = id;
+    rp_table[index].ia = ia;
+    rp_table[index].iid = iid;
+    rp_table[index].fid = fid;
+    rp_table[index].grpid = grpid;
+    rp_table[index].mt = mt;
+    rp_table[index].non = non;
+    oc_fp_blob_get_string(&blob, &rp_table[index].path, path_len);
+    oc_fp_blob_get_string(&blob, &rp_table[index].url, url_len);
+    oc_fp_blob_get_string(&blob, &rp_table[index].at, at_len);
+    oc_fp_blob_get_ga(&blob, &rp_table[index].ga, &rp_table[index].ga_len,
+                      ga_len);
   }
-  PRINT("\n");
+  free(buf);
+  oc_rp_table_changed(rp_table);
+  return true;
 }
 
-void
-oc_print_group_object_table_entry(int entry)
+/* writes the table, the table stays dirty when it could not be written so
+   that the next commit tries again */
+static int
+oc_fp_blob_commit(oc_fp_blob_table_t table)
 {
-  if (g_got[entry].id == -1) {
-    return;
+  int ret = -1;
+  switch (table) {
+  case OC_FP_BLOB_GOT:
+    ret = oc_dump_group_object_table_blob();
+    break;
+  case OC_FP_BLOB_GRT:
+    ret = oc_dump_group_rp_table_blob(GRT_BLOB_STORE, OC_FP_BLOB_GRT, g_grt,
+                                      GRT_MAX_ENTRIES);
+    break;
+#ifdef OC_PUBLISHER_TABLE
+  case OC_FP_BLOB_GPT:
+    ret = oc_dump_group_rp_table_blob(GPT_BLOB_STORE, OC_FP_BLOB_GPT, g_gpt,
+                                      GPT_MAX_ENTRIES);
+    break;
+#endif /* OC_PUBLISHER_TABLE */
+  default:
+    return 0;
   }
+  g_fp_blob_dirty[table] = (ret != 0);
+  return ret;
+}
 
-  PRINT("    id (0)     : %d\n", g_got[entry].id);
-  PRINT("    href (11)  : %s\n", oc_string_checked(g_got[entry].href));
-  PRINT("    cflags (8) : %d string: ", g_got[entry].cflags);
-  oc_print_cflags(g_got[entry].cflags);
-  PRINT("    ga (7)     : [");
-  for (int i = 0; i < g_got[entry].ga_len; i++) {
-    PRINT(" %u", g_got[entry].ga[i]);
+int
+oc_commit_fp_tables(void)
+{
+  int ret = 0;
+  g_fp_blob_commit_scheduled = false;
+  for (int table = 0; table < OC_FP_BLOB_NUM; table++) {
+    if (g_fp_blob_dirty[table] &&
+        oc_fp_blob_commit((oc_fp_blob_table_t)table) != 0) {
+      ret = -1;
+    }
   }
-  PRINT(" ]\n");
+  return ret;
 }
 
-void
-oc_dump_group_object_table_entry(int entry)
+static oc_event_callback_retval_t
+oc_fp_blob_commit_cb(void *data)
 {
-  char filename[20];
-  snprintf(filename, 20, "%s_%d", GOT_STORE, entry);
-
-  uint8_t *buf = malloc(OC_MAX_APP_DATA_SIZE);
-  if (!buf)
-    return;
-
-  oc_rep_new(buf, OC_MAX_APP_DATA_SIZE);
-  // write the data
-  oc_rep_begin_root_object();
-  // id 0
-  oc_rep_i_set_int(root, 0, g_got[entry].id);
-  // href- 11
-  oc_rep_i_set_text_string(root, 11, oc_string(g_got[entry].href));
-  // ga - 7
-  oc_rep_i_set_int_array(root, 7, g_got[entry].ga, g_got[entry].ga_len);
-
-  // cflags 8 /// this is different than the response on the wire
-  oc_rep_i_set_int(root, 8, g_got[entry].cflags);
+  (void)data;
+  oc_commit_fp_tables();
+  return OC_EVENT_DONE;
+}
 
-  oc_rep_end_root_object();
+/* marks the table as dirty, the table is written after the current request */
+static void
+oc_fp_blob_set_dirty(oc_fp_blob_table_t table)
+{
+  g_fp_blob_dirty[table] = true;
+  if (g_fp_blob_commit_scheduled == false) {
+    g_fp_blob_commit_scheduled = true;
+    oc_set_delayed_callback(NULL, oc_fp_blob_commit_cb, 0);
+  }
+}
 
-  int size = oc_rep_get_encoded_payload_size();
-  if (size > 0) {
-    OC_DBG("oc_dump_group_object_table_entry: dumped current state [%s] [%d]: "
-           "size %d",
-           filename, entry, size);
-    long written_size = oc_storage_write(filename, buf, size);
-    if (written_size != (long)size) {
-      PRINT("oc_dump_group_object_table_entry: written %d != %d (towrite)\n",
-            (int)written_size, size);
-    }
+static oc_fp_blob_table_t
+oc_fp_blob_table_of_rp_table(oc_group_rp_table_t *rp_table)
+{
+#ifdef OC_PUBLISHER_TABLE
+  if (rp_table == g_gpt) {
+    return OC_FP_BLOB_GPT;
   }
+#endif /* OC_PUBLISHER_TABLE */
+  (void)rp_table;
+  return OC_FP_BLOB_GRT;
+}
 
-  free(buf);
+void
+oc_dump_group_object_table_entry(int entry)
+{
+  (void)entry;
+  oc_fp_blob_set_dirty(OC_FP_BLOB_GOT);
 }
 
 #define GOT_ENTRY_MAX_SIZE (1024)
@@ -1907,28 +3380,19 @@ oc_load_group_object_table_entry(int entry)
         case OC_REP_STRING:
           if (rep->iname == 11) {
 
-            oc_free_string(&g_got[entry].href);
-            oc_new_string(&g_got[entry].href, oc_string(rep->value.string),
-                          oc_string_len(rep->value.string));
+            oc_fp_set_string(&g_got[entry].href, oc_string(rep->value.string),
+                           oc_string_len(rep->value.string));
           }
           break;
         case OC_REP_INT_ARRAY:
           if (rep->iname == 7) {
             int64_t *arr = oc_int_array(rep->value.array);
             int array_size = (int)oc_int_array_size(rep->value.array);
-            uint32_t *new_array =
-              (uint32_t *)malloc(array_size * sizeof(uint32_t));
-            if ((new_array) && (array_size > 0)) {
-              for (int i = 0; i < array_size; i++) {
-#pragma warning(suppress : 6386)
-                new_array[i] = (uint32_t)arr[i];
-              }
-              if (g_got[entry].ga != 0) {
-                free(g_got[entry].ga);
-              }
+            if (array_size > 0 &&
+                oc_fp_set_ga_from_int_array(&g_got[entry].ga,
+                                            &g_got[entry].ga_len, arr,
+                                            array_size)) {
               PRINT("  ga size %d\n", array_size);
-              g_got[entry].ga_len = array_size;
-              g_got[entry].ga = new_array;
             }
           }
           break;
@@ -1939,16 +3403,42 @@ oc_load_group_object_table_entry(int entry)
       }
     }
     oc_free_rep(head);
+    oc_core_group_object_table_changed();
   }
   free(buf);
 }
 
+/* loads the table stored per entry (old format) and stores it as blob */
+static void
+oc_convert_group_object_table(void)
+{
+  bool converted = false;
+  for (int i = 0; i < GOT_MAX_ENTRIES; i++) {
+    oc_load_group_object_table_entry(i);
+    if (g_got[i].id > -1) {
+      converted = true;
+    }
+  }
+  /* also without entries, the empty blob marks the conversion as done. the
+     old entries are kept until the blob has been written */
+  if (oc_fp_blob_commit(OC_FP_BLOB_GOT) == 0 && converted) {
+    PRINT("  converted Group Object Table to %s\n", GOT_BLOB_STORE);
+    char filename[20];
+    for (int i = 0; i < GOT_MAX_ENTRIES; i++) {
+      snprintf(filename, 20, "%s_%d", GOT_STORE, i);
+      oc_storage_erase(filename);
+    }
+  }
+}
+
 void
 oc_load_group_object_table()
 {
   PRINT("Loading Group Object Table from Persistent storage\n");
+  if (oc_load_group_object_table_blob() == false) {
+    oc_convert_group_object_table();
+  }
   for (int i = 0; i < GOT_MAX_ENTRIES; i++) {
-    oc_load_group_object_table_entry(i);
     oc_print_group_object_table_entry(i);
   }
 }
@@ -1958,23 +3448,21 @@ oc_free_group_object_table_entry(int entry, bool init)
 {
   g_got[entry].id = -1;
   if (init == false) {
-    oc_free_string(&g_got[entry].href);
-    free(g_got[entry].ga);
+    oc_fp_free_string(&g_got[entry].href);
+    oc_fp_free_ga(&g_got[entry].ga, &g_got[entry].ga_len);
   }
 
   g_got[entry].ga = NULL;
   g_got[entry].ga_len = 0;
   g_got[entry].cflags = 0;
+  oc_core_group_object_table_changed();
 }
 
 void
 oc_delete_group_object_table_entry(int entry)
 {
-  char filename[20];
-  snprintf(filename, 20, "%s_%d", GOT_STORE, entry);
-  oc_storage_erase(filename);
-
   oc_free_group_object_table_entry(entry, false);
+  oc_fp_blob_set_dirty(OC_FP_BLOB_GOT);
 }
 
 void
@@ -1982,9 +3470,10 @@ oc_delete_group_object_table()
 {
   PRINT("Deleting Group Object Table from Persistent storage\n");
   for (int i = 0; i < GOT_MAX_ENTRIES; i++) {
-    oc_delete_group_object_table_entry(i);
+    oc_free_group_object_table_entry(i, false);
     oc_print_group_object_table_entry(i);
   }
+  oc_fp_blob_commit(OC_FP_BLOB_GOT);
 }
 
 void
@@ -1994,6 +3483,7 @@ oc_free_group_object_table()
   for (int i = 0; i < GOT_MAX_ENTRIES; i++) {
     oc_free_group_object_table_entry(i, false);
   }
+  oc_got_ga_index_free();
 }
 
 // -----------------------------------------------------------------------------
@@ -2025,13 +3515,13 @@ oc_print_group_rp_table_entry(int entry, char *Store,
   PRINT("    fid (25)   : %" PRIu64 "\n", rp_table[entry].fid);
   PRINT("    grpid (13) : %u\n", rp_table[entry].grpid);
   if (oc_string_len(rp_table[entry].path) > 0) {
-    PRINT("    path (112) : '%s'\n", oc_string_checked(rp_table[entry].path));
+    PRINT("    path (112) : '%s'\n", oc_string(rp_table[entry].path));
   }
   if (oc_string_len(rp_table[entry].url) > 0) {
-    PRINT("    url (10)   : '%s'\n", oc_string_checked(rp_table[entry].url));
+    PRINT("    url (10)   : '%s'\n", oc_string(rp_table[entry].url));
   }
   if (oc_string_len(rp_table[entry].at) > 0) {
-    PRINT("    at (14) : %s\n", oc_string_checked(rp_table[entry].at));
+    PRINT("    at (14) : %s\n", oc_string(rp_table[entry].at));
   }
   PRINT("    ga (7)     : [");
   for (int i = 0; i < rp_table[entry].ga_len; i++) {
@@ -2065,62 +3555,14 @@ oc_print_reduced_group_rp_table_entry(int entry, char *Store,
   printf(" ]\n");
 }
 
-#define RP_ENTRY_MAX_SIZE (1024)
 static void
 oc_dump_group_rp_table_entry(int entry, char *Store,
                              oc_group_rp_table_t *rp_table, int max_size)
 {
+  (void)entry;
+  (void)Store;
   (void)max_size;
-  char filename[20];
-  snprintf(filename, 20, "%s_%d", Store, entry);
-  // PRINT("oc_dump_group_rp_table_entry %s, fname=%s\n", Store, filename);
-
-  uint8_t *buf = malloc(RP_ENTRY_MAX_SIZE);
-  if (!buf) {
-    PRINT("oc_dump_group_rp_table_entry: no allocated mem\n");
-    return;
-  }
-
-  oc_rep_new(buf, RP_ENTRY_MAX_SIZE);
-  // write the data
-  oc_rep_begin_root_object();
-  // id 0
-  oc_rep_i_set_int(root, 0, rp_table[entry].id);
-  // ia- 12
-  oc_rep_i_set_int(root, 12, rp_table[entry].ia);
-  // iid 26
-  oc_rep_i_set_int(root, 26, rp_table[entry].iid);
-  // fid - 25
-  oc_rep_i_set_int(root, 25, rp_table[entry].fid);
-  // grpid - 13
-  oc_rep_i_set_int(root, 13, rp_table[entry].grpid);
-  // at - 14
-  oc_rep_i_set_text_string(root, 14, oc_string(rp_table[entry].at));
-  // path- 112
-  oc_rep_i_set_text_string(root, 112, oc_string(rp_table[entry].path));
-  // url - 10
-  oc_rep_i_set_text_string(root, 10, oc_string(rp_table[entry].url));
-  // ga - 7
-  oc_rep_i_set_int_array(root, 7, rp_table[entry].ga, rp_table[entry].ga_len);
-
-  // cflags 8 /// this is different than the response on the wire
-  // oc_rep_i_set_int(root, 8, rp_table[entry].cflags);
-
-  oc_rep_end_root_object();
-
-  int size = oc_rep_get_encoded_payload_size();
-  if (size > 0) {
-    OC_DBG("oc_dump_group_rp_table_entry: dumped current state [%s] [%s] [%d]: "
-           "size %d",
-           filename, Store, entry, size);
-    long written_size = oc_storage_write(filename, buf, size);
-    if (written_size != (long)size) {
-      PRINT("oc_dump_group_rp_table_entry: written %d != %d (towrite)\n",
-            (int)written_size, size);
-    }
-  }
-
-  free(buf);
+  oc_fp_blob_set_dirty(oc_fp_blob_table_of_rp_table(rp_table));
 }
 
 void
@@ -2168,43 +3610,27 @@ oc_load_group_rp_table_entry(int entry, char *Store,
           break;
         case OC_REP_STRING:
           if (rep->iname == 112) {
-            oc_free_string(&rp_table[entry].path);
-            oc_new_string(&rp_table[entry].path, oc_string(rep->value.string),
-                          oc_string_len(rep->value.string));
+            oc_fp_set_string(&rp_table[entry].path,
+                             oc_string(rep->value.string),
+                             oc_string_len(rep->value.string));
           }
           if (rep->iname == 10) {
-            oc_free_string(&rp_table[entry].url);
-            oc_new_string(&rp_table[entry].url, oc_string(rep->value.string),
-                          oc_string_len(rep->value.string));
+            oc_fp_set_string(&rp_table[entry].url, oc_string(rep->value.string),
+                             oc_string_len(rep->value.string));
           }
           if (rep->iname == 14) {
-            oc_free_string(&rp_table[entry].at);
-            oc_new_string(&rp_table[entry].at, oc_string(rep->value.string),
-                          oc_string_len(rep->value.string));
+            oc_fp_set_string(&rp_table[entry].at, oc_string(rep->value.string),
+                             oc_string_len(rep->value.string));
           }
           break;
         case OC_REP_INT_ARRAY:
           if (rep->iname == 7) {
             int64_t *arr = oc_int_array(rep->value.array);
             int array_size = (int)oc_int_array_size(rep->value.array);
-            uint32_t *new_array =
-              (uint32_t *)malloc(array_size * sizeof(uint32_t));
-            if ((new_array != NULL) && (array_size > 0)) {
-              for (int i = 0; i < array_size; i++) {
-#pragma warning(suppress : 6386)
-                new_array[i] = (uint32_t)arr[i];
-              }
-              // assign only when the new array is allocated correctly
-              rp_table[entry].ga_len = array_size;
-            }
-            if (rp_table[entry].ga != 0) {
-              free(rp_table[entry].ga);
-            }
+            oc_fp_set_ga_from_int_array(&rp_table[entry].ga,
+                                        &rp_table[entry].ga_len, arr,
+                                        array_size);
             PRINT("  ga size %d\n", array_size);
-            // if (rp_table[entry].ga) {
-            //   free(rp_table[entry].ga);
-            // }
-            rp_table[entry].ga = new_array;
           }
           break;
         default:
@@ -2214,25 +3640,58 @@ oc_load_group_rp_table_entry(int entry, char *Store,
       }
     }
     oc_free_rep(head);
+    oc_rp_table_changed(rp_table);
   }
   free(buf);
 }
 
+/* loads the table stored per entry (old format) and stores it as blob */
+static void
+oc_convert_group_rp_table(char *Store, const char *blob_store,
+                          oc_fp_blob_table_t table,
+                          oc_group_rp_table_t *rp_table, int max_size)
+{
+  bool converted = false;
+  for (int i = 0; i < max_size; i++) {
+    oc_load_group_rp_table_entry(i, Store, rp_table, max_size);
+    if (rp_table[i].id > -1) {
+      converted = true;
+    }
+  }
+  /* also without entries, the empty blob marks the conversion as done. the
+     old entries are kept until the blob has been written */
+  if (oc_fp_blob_commit(table) == 0 && converted) {
+    PRINT("  converted %s to %s\n", Store, blob_store);
+    char filename[20];
+    for (int i = 0; i < max_size; i++) {
+      snprintf(filename, 20, "%s_%d", Store, i);
+      oc_storage_erase(filename);
+    }
+  }
+}
+
 void
 oc_load_rp_object_table()
 {
 
   PRINT("Loading Group Recipient Table from Persistent storage\n");
+  if (oc_load_group_rp_table_blob(GRT_BLOB_STORE, OC_FP_BLOB_GRT, g_grt,
+                                  GRT_MAX_ENTRIES) == false) {
+    oc_convert_group_rp_table(GRT_STORE, GRT_BLOB_STORE, OC_FP_BLOB_GRT, g_grt,
+                              GRT_MAX_ENTRIES);
+  }
   for (int i = 0; i < GRT_MAX_ENTRIES; i++) {
-    oc_load_group_rp_table_entry(i, GRT_STORE, g_grt, GRT_MAX_ENTRIES);
     oc_print_group_rp_table_entry(i, GRT_STORE, g_grt, GRT_MAX_ENTRIES);
   }
 
 #ifdef OC_PUBLISHER_TABLE
   PRINT("Loading Group Publisher Table from Persistent storage\n");
+  if (oc_load_group_rp_table_blob(GPT_BLOB_STORE, OC_FP_BLOB_GPT, g_gpt,
+                                  GPT_MAX_ENTRIES) == false) {
+    oc_convert_group_rp_table(GPT_STORE, GPT_BLOB_STORE, OC_FP_BLOB_GPT, g_gpt,
+                              GPT_MAX_ENTRIES);
+  }
   for (int i = 0; i < oc_core_get_publisher_table_size(); i++) {
-    oc_load_group_rp_table_entry(i, GPT_STORE, g_gpt,
-                                 oc_core_get_publisher_table_size());
     oc_print_group_rp_table_entry(i, GPT_STORE, g_gpt,
                                   oc_core_get_publisher_table_size());
   }
@@ -2252,24 +3711,22 @@ oc_free_group_rp_table_entry(int entry, char *Store,
   rp_table[entry].fid = -1;
   rp_table[entry].grpid = 0;
   if (init == false) {
-    oc_free_string(&rp_table[entry].path);
-    oc_free_string(&rp_table[entry].url);
-    oc_free_string(&rp_table[entry].at);
-    free(rp_table[entry].ga);
+    oc_fp_free_string(&rp_table[entry].path);
+    oc_fp_free_string(&rp_table[entry].url);
+    oc_fp_free_string(&rp_table[entry].at);
+    oc_fp_free_ga(&rp_table[entry].ga, &rp_table[entry].ga_len);
   }
   rp_table[entry].ga = NULL;
   rp_table[entry].ga_len = 0;
+  oc_rp_table_changed(rp_table);
 }
 
 static void
 oc_delete_group_rp_table_entry(int entry, char *Store,
                                oc_group_rp_table_t *rp_table, int max_size)
 {
-  char filename[20];
-  snprintf(filename, 20, "%s_%d", Store, entry);
-  oc_storage_erase(filename);
-
   oc_free_group_rp_table_entry(entry, Store, rp_table, max_size, false);
+  oc_fp_blob_set_dirty(oc_fp_blob_table_of_rp_table(rp_table));
 }
 
 void
@@ -2277,18 +3734,20 @@ oc_delete_group_rp_table()
 {
   PRINT("Deleting Group Recipient Table from Persistent storage\n");
   for (int i = 0; i < GRT_MAX_ENTRIES; i++) {
-    oc_delete_group_rp_table_entry(i, GRT_STORE, g_grt, GRT_MAX_ENTRIES);
+    oc_free_group_rp_table_entry(i, GRT_STORE, g_grt, GRT_MAX_ENTRIES, false);
     oc_print_group_rp_table_entry(i, GRT_STORE, g_grt, GRT_MAX_ENTRIES);
   }
+  oc_fp_blob_commit(OC_FP_BLOB_GRT);
 
 #ifdef OC_PUBLISHER_TABLE
   PRINT("Deleting Group Publisher Table from Persistent storage\n");
   for (int i = 0; i < oc_core_get_publisher_table_size(); i++) {
-    oc_delete_group_rp_table_entry(i, GPT_STORE, g_gpt,
-                                   oc_core_get_publisher_table_size());
+    oc_free_group_rp_table_entry(i, GPT_STORE, g_gpt,
+                                 oc_core_get_publisher_table_size(), false);
     oc_print_group_rp_table_entry(i, GPT_STORE, g_gpt,
                                   oc_core_get_publisher_table_size());
   }
+  oc_fp_blob_commit(OC_FP_BLOB_GPT);
 #endif /*  OC_PUBLISHER_TABLE */
 }
 
@@ -2299,6 +3758,7 @@ oc_free_group_rp_table()
   for (int i = 0; i < GRT_MAX_ENTRIES; i++) {
     oc_free_group_rp_table_entry(i, GRT_STORE, g_grt, GRT_MAX_ENTRIES, false);
   }
+  oc_rp_ga_index_free(&g_grt_ga_index);
 
 #ifdef OC_PUBLISHER_TABLE
   PRINT("Deleting Group Publisher Table from Persistent storage\n");
@@ -2306,6 +3766,7 @@ oc_free_group_rp_table()
     oc_free_group_rp_table_entry(i, GPT_STORE, g_gpt,
                                  oc_core_get_publisher_table_size(), false);
   }
+  oc_rp_ga_index_free(&g_gpt_ga_index);
 #endif /*  OC_PUBLISHER_TABLE */
 }
 
@@ -2357,20 +3818,11 @@ oc_core_add_rp_entry(int index, oc_group_rp_table_t *rp_table,
   rp_table[index].grpid = entry.grpid;
 
   // Copy group addresses
-  rp_table[index].ga_len = 0;
-  uint32_t *new_array = (uint32_t *)malloc(entry.ga_len * sizeof(uint32_t));
-  if ((new_array != NULL) && (entry.id > -1)) {
-    for (int i = 0; i < entry.ga_len; i++) {
-#pragma warning(suppress : 6386)
-      new_array[i] = entry.ga[i];
-    }
-    // copy only when the allocation was done correctly
-    rp_table[index].ga_len = entry.ga_len;
-    if (rp_table[index].ga != 0) {
-      free(rp_table[index].ga);
-    }
-    rp_table[index].ga = new_array;
+  if (entry.id > -1) {
+    oc_fp_set_ga(&rp_table[index].ga, &rp_table[index].ga_len, entry.ga,
+                 entry.ga_len);
   }
+  oc_rp_table_changed(rp_table);
 
   return 0;
 }
@@ -2636,18 +4088,78 @@ oc_create_multicast_group_address(oc_endpoint_t in, uint32_t group_nr,
                                                      5683);
 }
 
+// -----------------------------------------------------------------------------
+// multicast address cache
+//
+// the multicast endpoints are derived once per (group number, installation
+// id, scope, port) and kept in a small cache. the cache is cleared when the
+// installation id or the multicast port of the device changes.
+
+#ifndef OC_MCAST_ADDRESS_CACHE_SIZE
+#define OC_MCAST_ADDRESS_CACHE_SIZE (16)
+#endif
+
+typedef struct oc_mcast_address_t
+{
+  bool in_use;            /**< entry is used */
+  uint32_t group_nr;      /**< the group number */
+  int64_t iid;            /**< the installation id */
+  int scope;              /**< the address scope */
+  int port;               /**< the port */
+  oc_endpoint_t endpoint; /**< the derived multicast endpoint */
+} oc_mcast_address_t;
+
+static oc_mcast_address_t g_mcast_addresses[OC_MCAST_ADDRESS_CACHE_SIZE];
+static int g_mcast_addresses_next = 0;
+
+const oc_endpoint_t *
+oc_get_multicast_group_address_with_port(uint32_t group_nr, int64_t iid,
+                                         int scope, int port)
+{
+  for (int i = 0; i < OC_MCAST_ADDRESS_CACHE_SIZE; i++) {
+    oc_mcast_address_t *entry = &g_mcast_addresses[i];
+    if (entry->in_use && entry->group_nr == group_nr && entry->iid == iid &&
+        entry->scope == scope && entry->port == port) {
+      return &entry->endpoint;
+    }
+  }
+
+  // replace the oldest entry
+  oc_mcast_address_t *entry = &g_mcast_addresses[g_mcast_addresses_next];
+  g_mcast_addresses_next =
+    (g_mcast_addresses_next + 1) % OC_MCAST_ADDRESS_CACHE_SIZE;
+
+  memset(&entry->endpoint, 0, sizeof(oc_endpoint_t));
+  entry->endpoint = oc_create_multicast_group_address_with_port(
+    entry->endpoint, group_nr, iid, scope, port);
+  entry->group_nr = group_nr;
+  entry->iid = iid;
+  entry->scope = scope;
+  entry->port = port;
+  entry->in_use = true;
+  return &entry->endpoint;
+}
+
+const oc_endpoint_t *
+oc_get_multicast_group_address(uint32_t group_nr, int64_t iid, int scope)
+{
+  return oc_get_multicast_group_address_with_port(group_nr, iid, scope, 5683);
+}
+
+void
+oc_clear_multicast_group_address_cache(void)
+{
+  memset(g_mcast_addresses, 0, sizeof(g_mcast_addresses));
+  g_mcast_addresses_next = 0;
+}
+
 void
 subscribe_group_to_multicast_with_port(uint32_t group_nr, int64_t iid,
                                        int scope, int port)
 {
-  // create the multi cast address from group and scope and port
-  oc_endpoint_t group_mcast;
-  memset(&group_mcast, 0, sizeof(group_mcast));
-
-  group_mcast = oc_create_multicast_group_address_with_port(
-    group_mcast, group_nr, iid, scope, port);
-
-  // subscribe
+  // subscribe to the multi cast address from group and scope and port
+  oc_endpoint_t group_mcast =
+    *oc_get_multicast_group_address_with_port(group_nr, iid, scope, port);
   oc_connectivity_subscribe_mcast_ipv6(&group_mcast);
 }
 
@@ -2656,14 +4168,9 @@ subscribe_group_to_multicast(uint32_t group_nr, int64_t iid, int scope)
 {
   // FF35::30: <ULA-routing-prefix>::<group id>
   //
-  // create the multi cast address from group and scope
-  oc_endpoint_t group_mcast;
-  memset(&group_mcast, 0, sizeof(group_mcast));
-
-  group_mcast =
-    oc_create_multicast_group_address(group_mcast, group_nr, iid, scope);
-
-  // subscribe
+  // subscribe to the multi cast address from group and scope
+  oc_endpoint_t group_mcast =
+    *oc_get_multicast_group_address(group_nr, iid, scope);
   oc_connectivity_subscribe_mcast_ipv6(&group_mcast);
 }
 
@@ -2671,14 +4178,9 @@ void
 unsubscribe_group_to_multicast_with_port(uint32_t group_nr, int64_t iid,
                                          int scope, int port)
 {
-  // create the multi cast address from group and scope
-  oc_endpoint_t group_mcast;
-  memset(&group_mcast, 0, sizeof(group_mcast));
-
-  group_mcast = oc_create_multicast_group_address_with_port(
-    group_mcast, group_nr, iid, scope, port);
-
-  // un subscribe
+  // un subscribe from the multi cast address from group and scope and port
+  oc_endpoint_t group_mcast =
+    *oc_get_multicast_group_address_with_port(group_nr, iid, scope, port);
   oc_connectivity_unsubscribe_mcast_ipv6(&group_mcast);
 }
 
@@ -2687,14 +4189,9 @@ unsubscribe_group_to_multicast(uint32_t group_nr, int64_t iid, int scope)
 {
   // FF35::30: <ULA-routing-prefix>::<group id>
   //
-  // create the multi cast address from group and scope
-  oc_endpoint_t group_mcast;
-  memset(&group_mcast, 0, sizeof(group_mcast));
-
-  group_mcast =
-    oc_create_multicast_group_address(group_mcast, group_nr, iid, scope);
-
-  // un subscribe
+  // un subscribe from the multi cast address from group and scope
+  oc_endpoint_t group_mcast =
+    *oc_get_multicast_group_address(group_nr, iid, scope);
   oc_connectivity_unsubscribe_mcast_ipv6(&group_mcast);
 }
 
@@ -2702,14 +4199,9 @@ uint32_t
 oc_find_grpid_in_table(oc_group_rp_table_t *rp_table, int max_size,
                        uint32_t group_address)
 {
-  int index;
-  for (index = 0; index < max_size; index++) {
-    uint32_t *array = rp_table[index].ga;
-    int array_size = rp_table[index].ga_len;
-    bool found = is_in_array(group_address, array, array_size);
-    if (found) {
-      return rp_table[index].grpid;
-    }
+  int index = oc_rp_ga_index_find(rp_table, max_size, group_address, 0);
+  if (index > -1) {
+    return rp_table[index].grpid;
   }
   // not found
   return 0;
@@ -2728,6 +4220,81 @@ oc_find_grpid_in_recipient_table(uint32_t group_address)
   return oc_find_grpid_in_table(g_grt, GRT_MAX_ENTRIES, group_address);
 }
 
+// -----------------------------------------------------------------------------
+// multicast subscriptions
+//
+// the group numbers (group addresses or grpids) of the joined multicast
+// addresses are kept in a sorted list, together with the installation id and
+// port that were used to form the addresses.
+// registering computes the new list of group numbers and only joins the
+// addresses that are new and leaves the addresses that are no longer used.
+// each group number is joined once for scope 2 and scope 5.
+// when the stack shuts down or an interface changes, all addresses are left
+// and the list is reset so that the next registration joins them again.
+
+static uint32_t *g_mcast_groups = NULL;
+static int g_mcast_groups_len = 0;
+static int64_t g_mcast_iid = 0;
+static uint32_t g_mcast_port = 0;
+
+/* adds the group number to the sorted list, if not yet in the list */
+static void
+oc_mcast_groups_add(uint32_t *groups, int *len, uint32_t group_nr)
+{
+  int low = 0;
+  int high = *len;
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (groups[mid] < group_nr) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  if (low < *len && groups[low] == group_nr) {
+    return;
+  }
+  memmove(&groups[low + 1], &groups[low], (*len - low) * sizeof(uint32_t));
+  groups[low] = group_nr;
+  (*len)++;
+}
+
+static void
+oc_mcast_subscribe(uint32_t group_nr, int64_t iid, uint32_t port)
+{
+  PRINT(" oc_register_group_multicasts: join group %u\n", group_nr);
+  subscribe_group_to_multicast_with_port(group_nr, iid, 2, port);
+  subscribe_group_to_multicast_with_port(group_nr, iid, 5, port);
+}
+
+static void
+oc_mcast_unsubscribe(uint32_t group_nr, int64_t iid, uint32_t port)
+{
+  PRINT(" oc_register_group_multicasts: leave group %u\n", group_nr);
+  unsubscribe_group_to_multicast_with_port(group_nr, iid, 2, port);
+  unsubscribe_group_to_multicast_with_port(group_nr, iid, 5, port);
+}
+
+void
+oc_reset_group_multicasts(void)
+{
+  for (int i = 0; i < g_mcast_groups_len; i++) {
+    oc_mcast_unsubscribe(g_mcast_groups[i], g_mcast_iid, g_mcast_port);
+  }
+  free(g_mcast_groups);
+  g_mcast_groups = NULL;
+  g_mcast_groups_len = 0;
+  g_mcast_iid = 0;
+  g_mcast_port = 0;
+}
+
+void
+oc_rejoin_group_multicasts(void)
+{
+  oc_reset_group_multicasts();
+  oc_register_group_multicasts();
+}
+
 void
 oc_register_group_multicasts()
 {
@@ -2742,7 +4309,6 @@ oc_register_group_multicasts()
 
   PRINT("oc_register_group_multicasts: mport %d \n", port);
 
-  bool registered_pub = false;
   bool pub_entry = false;
 
   int index;
@@ -2753,60 +4319,173 @@ oc_register_group_multicasts()
       break;
     }
   }
-  if (pub_entry == true) {
-    for (index = 0; index < oc_core_get_publisher_table_size(); index++) {
-      int nr_entries = g_got[index].ga_len;
 
-      oc_cflag_mask_t cflags = g_got[index].cflags;
-      // check if the group address is used for receiving.
-      // e.g. WRITE or UPDATE
-      if (((cflags & OC_CFLAG_WRITE) > 0) || ((cflags & OC_CFLAG_UPDATE) > 0) ||
-          ((cflags & OC_CFLAG_READ) > 0)) {
+  int max_groups = 0;
+  for (index = 0; index < GOT_MAX_ENTRIES; index++) {
+    max_groups += g_got[index].ga_len;
+  }
+  uint32_t *groups = NULL;
+  int groups_len = 0;
+  if (max_groups > 0) {
+    groups = (uint32_t *)malloc(max_groups * sizeof(uint32_t));
+    if (groups == NULL) {
+      OC_ERR("oc_register_group_multicasts: out of memory %d", max_groups);
+      return;
+    }
+  }
 
-        for (int i = 0; i < nr_entries; i++) {
-          uint32_t grpid = oc_find_grpid_in_table(
-            g_gpt, oc_core_get_publisher_table_size(), g_got[index].ga[i]);
+  for (index = 0; index < GOT_MAX_ENTRIES; index++) {
+    int nr_entries = g_got[index].ga_len;
 
-          PRINT(" oc_register_group_multicasts index=%d i=%d grpid: %u "
-                "group_address: %d cflags=",
-                index, i, grpid, g_got[index].ga[i]);
-          oc_print_cflags(cflags);
+    oc_cflag_mask_t cflags = g_got[index].cflags;
+    // check if the group address is used for receiving.
+    // e.g. WRITE or UPDATE
+    if (((cflags & OC_CFLAG_WRITE) > 0) || ((cflags & OC_CFLAG_UPDATE) > 0) ||
+        ((cflags & OC_CFLAG_READ) > 0)) {
 
+      for (int i = 0; i < nr_entries; i++) {
+        if (pub_entry) {
+          // register via the grpid of the publisher table
+          uint32_t grpid = oc_find_grpid_in_table(
+            g_gpt, oc_core_get_publisher_table_size(), g_got[index].ga[i]);
           if (grpid > 0) {
-            subscribe_group_to_multicast_with_port(grpid, installation_id, 2,
-                                                   port);
-            subscribe_group_to_multicast_with_port(grpid, installation_id, 5,
-                                                   port);
+            oc_mcast_groups_add(groups, &groups_len, grpid);
           }
+        } else {
+          // register via group object table
+          oc_mcast_groups_add(groups, &groups_len, g_got[index].ga[i]);
         }
       }
     }
   }
-  if (pub_entry == false) {
-    // register via group object table
-    int index;
-    for (index = 0; index < GOT_MAX_ENTRIES; index++) {
-      int nr_entries = g_got[index].ga_len;
 
-      oc_cflag_mask_t cflags = g_got[index].cflags;
-      // check if the group address is used for receiving.
-      // e.g. WRITE or UPDATE
-      if (((cflags & OC_CFLAG_WRITE) > 0) || ((cflags & OC_CFLAG_UPDATE) > 0) ||
-          ((cflags & OC_CFLAG_READ) > 0)) {
-
-        for (int i = 0; i < nr_entries; i++) {
-          PRINT(
-            " oc_register_group_multicasts index=%d i=%d group: %u  cflags=",
-            index, i, g_got[index].ga[i]);
-          oc_print_cflags(cflags);
-          subscribe_group_to_multicast_with_port(g_got[index].ga[i],
-                                                 installation_id, 2, port);
-          subscribe_group_to_multicast_with_port(g_got[index].ga[i],
-                                                 installation_id, 5, port);
-        }
-      }
+  if (installation_id != g_mcast_iid || port != g_mcast_port) {
+    // the addresses of the joined groups have changed
+    for (int i = 0; i < g_mcast_groups_len; i++) {
+      oc_mcast_unsubscribe(g_mcast_groups[i], g_mcast_iid, g_mcast_port);
+    }
+    g_mcast_groups_len = 0;
+  }
+
+  // merge the sorted lists: leave the removed groups, join the new groups
+  int i = 0;
+  int j = 0;
+  while (i < g_mcast_groups_len || j < groups_len) {
+    if (j >= groups_len ||
+        (i < g_mcast_groups_len && g_mcast_groups[i] < groups[j])) {
+      oc_mcast_unsubscribe(g_mcast_groups[i], installation_id, port);
+      i++;
+    } else if (i >= g_mcast_groups_len || groups[j] < g_mcast_groups[i]) {
+      oc_mcast_subscribe(groups[j], installation_id, port);
+      j++;
+    } else {
+      i++;
+      j++;
+    }
+  }
+
+  free(g_mcast_groups);
+  g_mcast_groups = groups;
+  g_mcast_groups_len = groups_len;
+  g_mcast_iid = installation_id;
+  g_mcast_port = port;
+  PRINT("oc_register_group_multicasts: %d groups\n", groups_len);
+}
+
+// -----------------------------------------------------------------------------
+// scheduling of the s-mode read messages at initialization
+//
+// the read messages of the group objects with the I flag are not sent at
+// once, but spread over a window with a random delay per group address.
+// this avoids that all devices send their reads at the same moment, e.g.
+// after a power failure. a read is sent once for a group address, and a
+// pending read is cancelled when a value for the group address is received
+// before the read is sent.
+
+#ifndef OC_INIT_READ_WINDOW_MS
+#define OC_INIT_READ_WINDOW_MS (5000)
+#endif
+
+typedef struct oc_init_read_t
+{
+  uint32_t ga;          /**< the group address to read */
+  oc_clock_time_t time; /**< the time to send the read */
+} oc_init_read_t;
+
+static oc_init_read_t g_init_reads[GOT_MAX_ENTRIES];
+static int g_init_reads_len = 0;
+static bool g_init_read_in_cb = false;
+
+static oc_event_callback_retval_t oc_init_read_cb(void *data);
+
+static void
+oc_init_read_schedule_next(void)
+{
+  if (g_init_read_in_cb) {
+    // the callback schedules the next read when it is done
+    return;
+  }
+  oc_ri_remove_timed_event_callback(NULL, oc_init_read_cb);
+  if (g_init_reads_len == 0) {
+    return;
+  }
+  oc_clock_time_t now = oc_clock_time();
+  oc_clock_time_t ticks = 0;
+  if (g_init_reads[0].time > now) {
+    ticks = g_init_reads[0].time - now;
+  }
+  oc_ri_add_timed_event_callback_ticks(NULL, oc_init_read_cb, ticks);
+}
+
+static void
+oc_init_read_remove(int index)
+{
+  memmove(&g_init_reads[index], &g_init_reads[index + 1],
+          (g_init_reads_len - index - 1) * sizeof(oc_init_read_t));
+  g_init_reads_len--;
+}
+
+static oc_event_callback_retval_t
+oc_init_read_cb(void *data)
+{
+  (void)data;
+  oc_clock_time_t now = oc_clock_time();
+  g_init_read_in_cb = true;
+  // send the reads that are due, the list is sorted on time
+  while (g_init_reads_len > 0 && g_init_reads[0].time <= now) {
+    uint32_t ga = g_init_reads[0].ga;
+    oc_init_read_remove(0);
+    PRINT("oc_init_read_cb: issue read on group address %u\n", ga);
+    oc_do_s_mode_read(ga);
+  }
+  g_init_read_in_cb = false;
+  if (g_init_reads_len > 0) {
+    oc_clock_time_t ticks = g_init_reads[0].time - now;
+    oc_ri_add_timed_event_callback_ticks(NULL, oc_init_read_cb, ticks);
+  }
+  return OC_EVENT_DONE;
+}
+
+/* adds the read to the list (sorted on time), once per group address */
+static void
+oc_init_read_add(uint32_t ga, oc_clock_time_t time)
+{
+  for (int i = 0; i < g_init_reads_len; i++) {
+    if (g_init_reads[i].ga == ga) {
+      return;
     }
   }
+  if (g_init_reads_len >= GOT_MAX_ENTRIES) {
+    return;
+  }
+  int i = g_init_reads_len;
+  while (i > 0 && g_init_reads[i - 1].time > time) {
+    g_init_reads[i] = g_init_reads[i - 1];
+    i--;
+  }
+  g_init_reads[i].ga = ga;
+  g_init_reads[i].time = time;
+  g_init_reads_len++;
 }
 
 void
@@ -2815,6 +4494,8 @@ oc_init_datapoints_at_initialization()
   int index;
   PRINT("oc_init_datapoints_at_initialization\n");
 
+  g_init_reads_len = 0;
+  oc_clock_time_t now = oc_clock_time();
   for (index = 0; index < GOT_MAX_ENTRIES; index++) {
     int nr_entries = g_got[index].ga_len;
 
@@ -2824,11 +4505,33 @@ oc_init_datapoints_at_initialization()
         // Case 5)
         // @sender : cflags = i After device restart(power up)
         // Sent : -st r, sending association(1st assigned ga)
-        PRINT("oc_init_datapoints_at_initialization: index: %d issue read on "
-              "group address %d\n",
-              index, g_got[index].ga[0]);
-        oc_do_s_mode_read(g_got[index].ga[0]);
+        oc_clock_time_t delay = 0;
+        if (OC_INIT_READ_WINDOW_MS > 0) {
+          delay = (oc_clock_time_t)(oc_random_value() %
+                                    (uint32_t)OC_INIT_READ_WINDOW_MS) *
+                  OC_CLOCK_SECOND / 1000;
+        }
+        PRINT("oc_init_datapoints_at_initialization: index: %d schedule read "
+              "on group address %u in %d ms\n",
+              index, g_got[index].ga[0],
+              (int)(delay * 1000 / OC_CLOCK_SECOND));
+        oc_init_read_add(g_got[index].ga[0], now + delay);
       }
     }
   }
+  oc_init_read_schedule_next();
+}
+
+void
+oc_cancel_init_read(uint32_t group_address)
+{
+  for (int i = 0; i < g_init_reads_len; i++) {
+    if (g_init_reads[i].ga == group_address) {
+      PRINT("oc_cancel_init_read: group address %u already received\n",
+            group_address);
+      oc_init_read_remove(i);
+      oc_init_read_schedule_next();
+      return;
+    }
+  }
 }
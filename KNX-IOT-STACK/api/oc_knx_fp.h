@@ -114,6 +114,11 @@ void oc_cflags_as_string(char *buffer, oc_cflag_mask_t cflags);
  * - delete an index, e.g. delete the array entry of data (persistent)
  * - make the entry persistent
  * - free the data
+ *
+ * With OC_FP_TABLE_POOL the href and the group addresses of all tables are
+ * stored in a shared pool: pointers to them are only valid until the next
+ * change of the tables, and they are changed via the table functions only
+ * (not with oc_free_string or free).
  */
 typedef struct oc_group_object_table_t
 {
@@ -124,6 +129,24 @@ typedef struct oc_group_object_table_t
   uint32_t *ga;           /**< array of group addresses (unsigned integers) */
 } oc_group_object_table_t;
 
+/**
+ * @brief dispatch information of a group address
+ *
+ * One entry per (group address, group object table entry) combination.
+ * The entries are precomputed when the group object table changes, so that
+ * a received s-mode message can be handled without looking up the resource.
+ * The data is valid until the next change of the group object table.
+ */
+typedef struct oc_group_object_dispatch_t
+{
+  uint32_t ga;                   /**< the group address */
+  int index;                     /**< index in the group object table */
+  oc_cflag_mask_t cflags;        /**< cflags of the table entry */
+  const char *href;              /**< href of the table entry, used to
+                                      transmit the value */
+  const oc_resource_t *resource; /**< the resource of the href, or NULL */
+} oc_group_object_dispatch_t;
+
 /**
  * @brief Function point Recipient - Publisher Table Resource (/fp/r) (/fp/p)
  *
@@ -171,6 +194,9 @@ typedef struct oc_group_object_table_t
  * - make the entry persistent
  * - free up the allocated data
  * - return the structure at a specific index
+ *
+ * With OC_FP_TABLE_POOL the strings and the group addresses are stored in a
+ * shared pool, see oc_group_object_table_t.
  */
 typedef struct oc_group_rp_table_t
 {
@@ -221,6 +247,50 @@ int oc_table_find_id_from_rep(oc_rep_t *object);
  */
 int oc_core_set_group_object_table(int index, oc_group_object_table_t entry);
 
+/**
+ * @brief signal that the group object table has been changed
+ *
+ * The lookup of group object table entries by group address uses an index
+ * that is rebuilt after a change of the table.
+ * Changes via /fp/g, storage and oc_core_set_group_object_table are handled
+ * internally, as are the adding and deleting of resources.
+ * This function needs to be called when an entry has been modified directly
+ * via oc_core_get_group_object_table_entry.
+ */
+void oc_core_group_object_table_changed(void);
+
+/**
+ * @brief iterate over the dispatch information of a group address
+ *
+ * The entries are returned ordered by group object table index. The entry is
+ * stored in \p entry. When there is no memory for the index the table is
+ * scanned, hence this never fails for lack of memory.
+ *
+ * @param group_address the group address
+ * @param device the device index, the resources are looked up on this device
+ * @param pos [in,out] the iteration state, 0 to start
+ * @param entry [out] storage for the entry
+ * @return const oc_group_object_dispatch_t* the next entry, NULL at the end
+ */
+const oc_group_object_dispatch_t *oc_core_next_group_object_table_dispatch(
+  uint32_t group_address, size_t device, int *pos,
+  oc_group_object_dispatch_t *entry);
+
+/**
+ * @brief retrieve the group object table indices that refer to a resource
+ *
+ * The list is stored per resource and is kept in sync with the group object
+ * table, hence no string compares are needed to find the entries.
+ * The returned indices are ascending.
+ *
+ * @param resource the (application) resource
+ * @param nr_entries [out] the number of returned indices
+ * @return const int* array of indices, NULL if the resource is not used in
+ * the group object table
+ */
+const int *oc_core_get_group_object_table_indices(
+  const oc_resource_t *resource, int *nr_entries);
+
 /**
  * @brief retrieve the group object table total size,
  * e.g. the number of entries that can be stored
@@ -275,9 +345,33 @@ int find_empty_slot_in_group_object_table(int id);
  *
  * function is called when the device is (re)started in run-time mode (e.g.
  * state = "loaded")
+ *
+ * The joined multicast addresses are remembered: only the addresses that are
+ * new are joined and the addresses that are no longer used are left. Each
+ * address is joined once, also if it is used by multiple entries.
  */
 void oc_register_group_multicasts();
 
+/**
+ * @brief leave all joined group multicast addresses
+ *
+ * Called when the stack shuts down, before the connectivity is shut down.
+ * The next call of oc_register_group_multicasts() joins all addresses again.
+ *
+ * @see oc_register_group_multicasts
+ */
+void oc_reset_group_multicasts(void);
+
+/**
+ * @brief join all group multicast addresses again
+ *
+ * To be called when a network interface comes up or goes down, so that the
+ * addresses are joined on the current set of interfaces.
+ *
+ * @see oc_reset_group_multicasts
+ */
+void oc_rejoin_group_multicasts(void);
+
 /**
  * @brief find the grpid from the group_address in the publisher table
  *
@@ -304,9 +398,21 @@ uint32_t oc_find_grpid_in_recipient_table(uint32_t group_address);
  * @brief initializes the data points at initialization
  * e.g. sends out an read s-mode message when the I flag is set.
  *
+ * The read messages are spread over OC_INIT_READ_WINDOW_MS milliseconds,
+ * with a random delay per group address. Each group address is read once.
  */
 void oc_init_datapoints_at_initialization();
 
+/**
+ * @brief cancel the pending initialization read of the group address
+ *
+ * Called when a value for the group address has been received (s-mode "w" or
+ * "a"), so that the read at initialization is no longer needed.
+ *
+ * @param group_address the group address
+ */
+void oc_cancel_init_read(uint32_t group_address);
+
 /**
  * @brief find index belonging to the id
  *
@@ -393,6 +499,10 @@ void oc_print_group_object_table_entry(int entry);
 /**
  * @brief dump the entry of the Group Object Table (to persistent) storage
  *
+ * The table is stored as a single blob, this function marks the table as
+ * changed. The table is written once after the current request has been
+ * handled, see oc_commit_fp_tables().
+ *
  * @param entry the index of the entry in the Group Object Table
  */
 void oc_dump_group_object_table_entry(int entry);
@@ -400,6 +510,9 @@ void oc_dump_group_object_table_entry(int entry);
 /**
  * @brief load the entry of the Group Object Table (from persistent) storage
  *
+ * Reads the entry stored in the old format (one storage entry per table
+ * entry). Only used to convert the old format to the blob format.
+ *
  * @param entry the index of the entry in the Group Object Table
  */
 void oc_load_group_object_table_entry(int entry);
@@ -407,12 +520,13 @@ void oc_load_group_object_table_entry(int entry);
 /**
  * @brief load all entries of the Group Object Table (from persistent) storage
  *
+ * A table stored in the old format is converted to the blob format.
  */
 void oc_load_group_object_table();
 
 /**
  * @brief delete entry of the Group Object Table
- * does not make the change persistent
+ * the change is made persistent after the current request has been handled
  *
  * @param entry the index of the entry in the Group Object Table
  */
@@ -431,6 +545,63 @@ void oc_delete_group_object_table();
  */
 void oc_delete_group_rp_table();
 
+/**
+ * @brief write the changed Group Object, Recipient and Publisher tables to
+ * persistent storage
+ *
+ * Each table is stored as one versioned and checksummed blob. Changes to the
+ * tables are collected and written by this function, which is scheduled
+ * automatically after a change. Call this function to write the changes
+ * immediately, e.g. before a reset.
+ * A table that could not be written stays marked as changed and is written
+ * again with the next commit.
+ *
+ * @return int 0 == success, -1 a table could not be written
+ */
+int oc_commit_fp_tables(void);
+
+/**
+ * @brief memory used by the Group Object, Recipient and Publisher tables
+ */
+typedef struct oc_fp_table_memory_t
+{
+  size_t table_size; /**< bytes of the table arrays */
+  size_t heap_size;  /**< bytes allocated for the group addresses and strings */
+  int heap_blocks;   /**< number of heap allocations */
+} oc_fp_table_memory_t;
+
+/**
+ * @brief retrieve the memory used by the Group Object, Recipient and Publisher
+ * tables
+ *
+ * Used to compare the storage of the tables with and without OC_FP_TABLE_POOL
+ * for a configuration. The overhead of the heap per allocation is not
+ * included, it depends on the platform.
+ *
+ * @param memory [out] the memory usage
+ */
+void oc_core_get_fp_table_memory(oc_fp_table_memory_t *memory);
+
+/**
+ * @brief find (first) index in the recipient table that contains the group
+ * address
+ *
+ * @param group_address the group address
+ * @return int the index in the table or -1
+ */
+int oc_core_find_recipient_table_index(uint32_t group_address);
+
+/**
+ * @brief find next index in the recipient table that contains the group
+ * address
+ *
+ * @param group_address the group address
+ * @param cur_index the current index to start from.
+ * @return int the index in the table or -1
+ */
+int oc_core_find_next_recipient_table_index(uint32_t group_address,
+                                            int cur_index);
+
 /**
  * @brief checks if the group address is part of the recipient table at index
  *
@@ -445,6 +616,9 @@ bool oc_core_check_recipient_index_on_group_address(int index,
 /**
  * @brief get the destination (path or url) of the recipient table at index
  *
+ * With OC_FP_TABLE_POOL the string is only valid until the next change of
+ * the tables.
+ *
  * @param index the index in the table
  * @return char* NULL or path or url of the destination
  */
@@ -640,6 +814,40 @@ oc_endpoint_t oc_create_multicast_group_address_with_port(oc_endpoint_t in,
                                                           int64_t iid,
                                                           int scope, int port);
 
+/**
+ * @brief get the group multi cast address with port from the cache
+ *
+ * the address is created with oc_create_multicast_group_address_with_port
+ * when it is not yet in the cache.
+ *
+ * @param group_nr the group number
+ * @param iid the installation id
+ * @param scope the address scope
+ * @param port the port to be used
+ * @return const oc_endpoint_t* the cached endpoint, copy it before changing it
+ */
+const oc_endpoint_t *oc_get_multicast_group_address_with_port(
+  uint32_t group_nr, int64_t iid, int scope, int port);
+
+/**
+ * @brief get the group multi cast address from the cache
+ * using the default port 5683
+ *
+ * @param group_nr the group number
+ * @param iid the installation id
+ * @param scope the address scope
+ * @return const oc_endpoint_t* the cached endpoint, copy it before changing it
+ */
+const oc_endpoint_t *oc_get_multicast_group_address(uint32_t group_nr,
+                                                    int64_t iid, int scope);
+
+/**
+ * @brief clear the cache of group multi cast addresses
+ *
+ * to be called when the installation id or the multicast port changes.
+ */
+void oc_clear_multicast_group_address_cache(void);
+
 /**
  * @brief subscribe to a multicast address, defined by group number and
  * installation id
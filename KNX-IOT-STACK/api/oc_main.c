@@ -261,6 +261,10 @@ static void
 oc_shutdown_all_devices(void)
 {
   size_t device;
+#ifdef OC_SERVER
+  // leave the group multicast addresses while the sockets are still open
+  oc_reset_group_multicasts();
+#endif
   for (device = 0; device < oc_core_get_num_devices(); device++) {
     oc_connectivity_shutdown(device);
   }
@@ -34,6 +34,12 @@ oc_rep_set_pool(struct oc_memb *rep_objects_pool)
   rep_objects = rep_objects_pool;
 }
 
+struct oc_memb *
+oc_rep_get_pool(void)
+{
+  return rep_objects;
+}
+
 void
 oc_rep_new(uint8_t *out_payload, int size)
 {
@@ -588,6 +594,90 @@ oc_parse_rep(const uint8_t *in_payload, int payload_size, oc_rep_t **out_rep)
   return err;
 }
 
+int
+oc_parse_rep_single_value(const uint8_t *in_payload, int payload_size,
+                          oc_rep_t **out_rep)
+{
+  CborParser parser;
+  CborValue root_value;
+  CborError err = CborNoError;
+  err |= cbor_parser_init(in_payload, payload_size, 0, &parser, &root_value);
+  *out_rep = 0;
+  if (err == CborNoError && cbor_value_is_valid(&root_value)) {
+    oc_parse_single_entity(&root_value, out_rep, &err);
+  }
+  if (*out_rep) {
+    (*out_rep)->next = NULL;
+  }
+  return err;
+}
+
+int
+oc_parse_rep_scalar_value(const uint8_t *in_payload, int payload_size,
+                          oc_rep_t *out_rep)
+{
+  CborParser parser;
+  CborValue value, next;
+  size_t len = 0;
+  memset(out_rep, 0, sizeof(oc_rep_t));
+  CborError err =
+    cbor_parser_init(in_payload, payload_size, 0, &parser, &value);
+  /* skip over CBOR Tags */
+  while (err == CborNoError && cbor_value_is_tag(&value)) {
+    err = cbor_value_skip_tag(&value);
+  }
+  if (err != CborNoError) {
+    return err;
+  }
+
+  switch (value.type) {
+  case CborIntegerType:
+    err = cbor_value_get_int64(&value, &out_rep->value.integer);
+    out_rep->type = OC_REP_INT;
+    break;
+  case CborBooleanType:
+    err = cbor_value_get_boolean(&value, &out_rep->value.boolean);
+    out_rep->type = OC_REP_BOOL;
+    break;
+  case CborFloatType:
+    err = cbor_value_get_float(&value, &out_rep->value.float_p);
+    out_rep->type = OC_REP_FLOAT;
+    break;
+  case CborDoubleType:
+    err = cbor_value_get_double(&value, &out_rep->value.double_p);
+    out_rep->type = OC_REP_DOUBLE;
+    break;
+  case CborByteStringType:
+  case CborTextStringType:
+    /* the string is not copied, it ends where the next data item starts */
+    next = value;
+    err = cbor_value_get_string_length(&value, &len);
+    if (err == CborNoError) {
+      err = cbor_value_advance(&next);
+    }
+    if (err == CborNoError &&
+        cbor_value_get_next_byte(&next) > in_payload + payload_size) {
+      err = CborErrorUnexpectedEOF;
+    }
+    if (err == CborNoError) {
+      out_rep->value.string.ptr =
+        (void *)(cbor_value_get_next_byte(&next) - len);
+      out_rep->value.string.size = len + 1;
+      out_rep->type = cbor_value_is_text_string(&value) ? OC_REP_STRING
+                                                        : OC_REP_BYTE_STRING;
+    }
+    break;
+  default:
+    /* maps and arrays consist of more than one rep */
+    err = CborErrorUnsupportedType;
+    break;
+  }
+  if (err != CborNoError) {
+    out_rep->type = OC_REP_NIL;
+  }
+  return err;
+}
+
 static bool
 oc_rep_get_value(oc_rep_t *rep, oc_rep_value_type_t type, const char *key,
                  void **value, size_t *size)
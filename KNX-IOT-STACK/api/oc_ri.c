@@ -23,6 +23,7 @@
 #include "util/oc_list.h"
 #include "util/oc_memb.h"
 #include "util/oc_process.h"
+#include "util/oc_token_index.h"
 
 #include "messaging/coap/constants.h"
 #include "messaging/coap/engine.h"
@@ -35,6 +36,7 @@
 
 #include "oc_buffer.h"
 #include "oc_core_res.h"
+#include "oc_core_uri_table.h"
 #include "oc_discovery.h"
 #include "oc_events.h"
 #include "oc_network_events.h"
@@ -46,6 +48,8 @@
 #include "oc_uuid.h"
 
 #include "oc_knx_sec.h"
+#include "api/oc_knx_fp.h"
+#include "api/oc_knx_client.h"
 
 #ifdef OC_BLOCK_WISE
 #include "oc_blockwise.h"
@@ -67,6 +71,8 @@ OC_MEMB(app_resource_datas_s, oc_resource_data_t, OC_MAX_APP_RESOURCES);
 #include "oc_client_state.h"
 OC_LIST(client_cbs);
 OC_MEMB(client_cbs_s, oc_client_cb_t, OC_MAX_NUM_CONCURRENT_REQUESTS + 1);
+OC_TOKEN_INDEX(client_cbs_index, oc_client_cb_t,
+               OC_MAX_NUM_CONCURRENT_REQUESTS + 1);
 #endif /* OC_CLIENT */
 
 OC_LIST(timed_callbacks);
@@ -76,6 +82,11 @@ OC_MEMB(event_callbacks_s, oc_event_callback_t,
 
 OC_PROCESS(timed_callback_events, "OC timed callbacks");
 
+// the timers of the timed and periodic observe callbacks, ordered on
+// expiration. timed_callback_events runs one event timer for the first one.
+static struct oc_etimer *event_callback_timers;
+static struct oc_etimer event_callback_timer;
+
 #ifdef OC_TCP
 oc_event_callback_retval_t oc_remove_ping_handler(void *data);
 #endif /* OC_TCP */
@@ -568,6 +579,138 @@ oc_ri_query_exists(const char *query, size_t query_len, const char *key)
   return found;
 }
 
+void
+oc_ri_parse_query(oc_query_index_t *index, const char *query,
+                  size_t query_len)
+{
+  index->query = query;
+  index->query_len = query_len;
+  index->count = 0;
+  index->overflow = false;
+  if (query == NULL || query_len == 0) {
+    return;
+  }
+  if (query_len >= OC_QUERY_NO_VALUE) {
+    index->overflow = true;
+    return;
+  }
+
+  /* one pass over the query, a trailing '&' does not start a parameter */
+  size_t pos = 0;
+  while (pos < query_len) {
+    if (index->count == OC_MAX_QUERY_PARAMS) {
+      index->overflow = true;
+      return;
+    }
+    const char *start = query + pos;
+    const char *end = memchr(start, '&', query_len - pos);
+    if (end == NULL) {
+      end = query + query_len;
+    }
+    const char *equal = memchr(start, '=', end - start);
+    oc_query_param_t *param = &index->params[index->count++];
+    param->key = (uint16_t)pos;
+    if (equal != NULL) {
+      param->key_len = (uint16_t)(equal - start);
+      param->value = (uint16_t)(equal + 1 - query);
+      param->value_len = (uint16_t)(end - equal - 1);
+    } else {
+      param->key_len = (uint16_t)(end - start);
+      param->value = 0;
+      param->value_len = OC_QUERY_NO_VALUE;
+    }
+    pos = (size_t)(end - query) + 1;
+  }
+}
+
+static const oc_query_index_t *
+oc_ri_get_request_query_index(oc_request_t *request)
+{
+  oc_query_index_t *index = &request->query_index;
+  if (index->query != request->query ||
+      index->query_len != request->query_len) {
+    oc_ri_parse_query(index, request->query, request->query_len);
+  }
+  if (index->overflow) {
+    return NULL;
+  }
+  return index;
+}
+
+int
+oc_ri_get_request_query_nth_key_value(oc_request_t *request, char **key,
+                                      size_t *key_len, char **value,
+                                      size_t *value_len, size_t n)
+{
+  const oc_query_index_t *index = oc_ri_get_request_query_index(request);
+  if (index == NULL) {
+    return oc_ri_get_query_nth_key_value(request->query, request->query_len,
+                                         key, key_len, value, value_len, n);
+  }
+  if (n == 0 || n > index->count) {
+    return -1;
+  }
+  const oc_query_param_t *param = &index->params[n - 1];
+  char *query = (char *)index->query;
+  if (param->value_len == OC_QUERY_NO_VALUE) {
+    /* same as the string scan: a key without value ends the iteration */
+    if ((size_t)param->key + param->key_len < index->query_len) {
+      *key = query + param->key;
+      *key_len = param->key_len;
+    } else {
+      *key_len = 0;
+    }
+    return -1;
+  }
+  *key = query + param->key;
+  *key_len = param->key_len;
+  *value = query + param->value;
+  *value_len = param->value_len;
+  return (int)(param->value + param->value_len + 1);
+}
+
+int
+oc_ri_get_request_query_value(oc_request_t *request, const char *key,
+                              char **value)
+{
+  const oc_query_index_t *index = oc_ri_get_request_query_index(request);
+  if (index == NULL) {
+    return oc_ri_get_query_value(request->query, request->query_len, key,
+                                 value);
+  }
+  size_t key_len = strlen(key);
+  for (uint8_t i = 0; i < index->count; i++) {
+    const oc_query_param_t *param = &index->params[i];
+    if (param->value_len == OC_QUERY_NO_VALUE) {
+      return -1;
+    }
+    if (param->key_len == key_len &&
+        strncasecmp(key, index->query + param->key, key_len) == 0) {
+      *value = (char *)index->query + param->value;
+      return (int)param->value_len;
+    }
+  }
+  return -1;
+}
+
+int
+oc_ri_request_query_exists(oc_request_t *request, const char *key)
+{
+  const oc_query_index_t *index = oc_ri_get_request_query_index(request);
+  if (index == NULL) {
+    return oc_ri_query_exists(request->query, request->query_len, key);
+  }
+  size_t key_len = strlen(key);
+  for (uint8_t i = 0; i < index->count; i++) {
+    const oc_query_param_t *param = &index->params[i];
+    if (param->key_len == key_len &&
+        strncasecmp(key, index->query + param->key, key_len) == 0) {
+      return 1;
+    }
+  }
+  return -1;
+}
+
 void
 allocate_events(void)
 {
@@ -627,7 +770,384 @@ stop_processes(void)
   oc_process_exit(&message_buffer_handler);
 }
 
+// ----------------------------------------------------------------------------
+// uri index
+//
+// hash index from (uri, device) to resource, using open addressing with
+// linear probing. the uri is hashed without the leading '/'.
+// the core resources and the application resources have their own index, the
+// core resources are matched first. resources with a wildcard uri, e.g.
+// "/fp/g/*", are stored with the '*' and found by looking up the request path
+// up to each '/' followed by '*'.
+// the const core resources of device 0 are found in the perfect hash table of
+// oc_core_uri_table.h, generated by tools/gen_core_uri_table.py. the core
+// index only contains the core resources that are not in that table, e.g. the
+// resources of the other devices.
+// an index is built on the first lookup after it has been invalidated, an
+// added application resource is added directly to a valid index.
+// without dynamic allocation the size of the index is fixed, when the
+// resources do not fit the lookup falls back to walking the resource list.
+
+#ifndef OC_URI_INDEX_CORE_SIZE
+#define OC_URI_INDEX_CORE_SIZE (2 * OC_NUM_CORE_RESOURCES_PER_DEVICE)
+#endif
+
+#ifndef OC_URI_INDEX_APP_SIZE
+#define OC_URI_INDEX_APP_SIZE (2 * OC_MAX_APP_RESOURCES)
+#endif
+
+typedef struct oc_uri_index_t
+{
+  const oc_resource_t **slots; /**< the slots, NULL is an empty slot */
+  size_t size;                 /**< number of slots */
+  size_t count;                /**< number of used slots */
+  bool valid;                  /**< index contains all resources */
+} oc_uri_index_t;
+
+#ifndef OC_DYNAMIC_ALLOCATION
+static const oc_resource_t *g_core_uri_slots[OC_URI_INDEX_CORE_SIZE];
+static oc_uri_index_t g_core_uri_index = { g_core_uri_slots,
+                                           OC_URI_INDEX_CORE_SIZE, 0, false };
+#ifdef OC_SERVER
+static const oc_resource_t *g_app_uri_slots[OC_URI_INDEX_APP_SIZE];
+static oc_uri_index_t g_app_uri_index = { g_app_uri_slots,
+                                          OC_URI_INDEX_APP_SIZE, 0, false };
+#endif /* OC_SERVER */
+#else  /* !OC_DYNAMIC_ALLOCATION */
+static oc_uri_index_t g_core_uri_index = { NULL, 0, 0, false };
+#ifdef OC_SERVER
+static oc_uri_index_t g_app_uri_index = { NULL, 0, 0, false };
+#endif /* OC_SERVER */
+#endif /* OC_DYNAMIC_ALLOCATION */
+
+/* FNV-1a hash of the path, followed by '*' for a wildcard lookup.
+ * must be the same as fnv_hash in tools/gen_core_uri_table.py */
+static uint32_t
+oc_uri_hash(const char *path, size_t path_len, bool wildcard, uint32_t seed)
+{
+  uint32_t hash = seed;
+  for (size_t i = 0; i < path_len; i++) {
+    hash = (hash ^ (uint8_t)path[i]) * 16777619u;
+  }
+  if (wildcard) {
+    hash = (hash ^ (uint8_t)'*') * 16777619u;
+  }
+  // mix the bits, the low bits of FNV-1a depend on the low bits only
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35u;
+  return hash ^ (hash >> 16);
+}
+
+static uint32_t
+oc_uri_index_hash(const char *path, size_t path_len, bool wildcard,
+                  size_t device)
+{
+  return oc_uri_hash(path, path_len, wildcard, 2166136261u) ^
+         (uint32_t)device;
+}
+
+/* the uri of the resource without the leading '/' */
+static const char *
+oc_uri_index_path(const oc_resource_t *resource, size_t *path_len)
+{
+  const char *path = oc_string(resource->uri);
+  *path_len = oc_string_len(resource->uri);
+  if (*path_len > 0 && path[0] == '/') {
+    path++;
+    (*path_len)--;
+  }
+  return path;
+}
+
+static bool
+oc_uri_index_match(const oc_resource_t *resource, const char *path,
+                   size_t path_len, bool wildcard, size_t device)
+{
+  size_t res_len;
+  const char *res_path = oc_uri_index_path(resource, &res_len);
+  if (resource->device != device) {
+    return false;
+  }
+  if (wildcard) {
+    return res_len == path_len + 1 && res_path[path_len] == '*' &&
+           memcmp(res_path, path, path_len) == 0;
+  }
+  return res_len == path_len && memcmp(res_path, path, path_len) == 0;
+}
+
+static void
+oc_uri_index_clear(oc_uri_index_t *index)
+{
+  if (index->slots) {
+    memset(index->slots, 0, index->size * sizeof(oc_resource_t *));
+  }
+  index->count = 0;
+  index->valid = false;
+}
+
+static bool oc_uri_index_insert(oc_uri_index_t *index,
+                                const oc_resource_t *resource);
+
+#ifdef OC_DYNAMIC_ALLOCATION
+static bool
+oc_uri_index_grow(oc_uri_index_t *index)
+{
+  const oc_resource_t **old_slots = index->slots;
+  size_t old_size = index->size;
+  size_t new_size = old_size ? 2 * old_size : 16;
+  const oc_resource_t **new_slots =
+    (const oc_resource_t **)calloc(new_size, sizeof(oc_resource_t *));
+  if (!new_slots) {
+    OC_ERR("oc_uri_index_grow: out of memory");
+    return false;
+  }
+  index->slots = new_slots;
+  index->size = new_size;
+  index->count = 0;
+  for (size_t i = 0; i < old_size; i++) {
+    if (old_slots[i]) {
+      oc_uri_index_insert(index, old_slots[i]);
+    }
+  }
+  free(old_slots);
+  return true;
+}
+#endif /* OC_DYNAMIC_ALLOCATION */
+
+/* adds the resource, the first resource with the same uri and device is
+ * kept */
+static bool
+oc_uri_index_insert(oc_uri_index_t *index, const oc_resource_t *resource)
+{
+  // keep the load factor below 1/2, so that probing stays short
+  if (2 * (index->count + 1) > index->size) {
+#ifdef OC_DYNAMIC_ALLOCATION
+    if (!oc_uri_index_grow(index)) {
+      return false;
+    }
+#else  /* OC_DYNAMIC_ALLOCATION */
+    return false;
+#endif /* !OC_DYNAMIC_ALLOCATION */
+  }
+  size_t path_len;
+  const char *path = oc_uri_index_path(resource, &path_len);
+  bool wildcard = path_len > 0 && path[path_len - 1] == '*';
+  if (wildcard) {
+    path_len--;
+  }
+  size_t slot = oc_uri_index_hash(path, path_len, wildcard, resource->device) %
+                index->size;
+  while (index->slots[slot]) {
+    if (oc_uri_index_match(index->slots[slot], path, path_len, wildcard,
+                           resource->device)) {
+      return true;
+    }
+    slot = (slot + 1) % index->size;
+  }
+  index->slots[slot] = resource;
+  index->count++;
+  return true;
+}
+
+static const oc_resource_t *
+oc_uri_index_find(const oc_uri_index_t *index, const char *path,
+                  size_t path_len, bool wildcard, size_t device)
+{
+  if (index->count == 0) {
+    return NULL;
+  }
+  size_t slot = oc_uri_index_hash(path, path_len, wildcard, device) %
+                index->size;
+  while (index->slots[slot]) {
+    if (oc_uri_index_match(index->slots[slot], path, path_len, wildcard,
+                           device)) {
+      return index->slots[slot];
+    }
+    slot = (slot + 1) % index->size;
+  }
+  return NULL;
+}
+
+static void
+oc_uri_index_free(oc_uri_index_t *index)
+{
+#ifdef OC_DYNAMIC_ALLOCATION
+  free(index->slots);
+  index->slots = NULL;
+  index->size = 0;
+#endif /* OC_DYNAMIC_ALLOCATION */
+  oc_uri_index_clear(index);
+}
+
+/* the const core resource of device 0, from the generated table */
+static const oc_resource_t *
+oc_core_uri_table_find(const char *path, size_t path_len, bool wildcard)
+{
+  uint32_t hash = oc_uri_hash(path, path_len, wildcard, OC_CORE_URI_TABLE_SEED);
+  uint8_t entry = oc_core_uri_table_slots[hash % OC_CORE_URI_TABLE_SLOTS];
+  if (entry == 0) {
+    return NULL;
+  }
+  const oc_resource_t *resource = oc_core_uri_table[entry - 1];
+  if (resource && oc_uri_index_match(resource, path, path_len, wildcard, 0)) {
+    return resource;
+  }
+  return NULL;
+}
+
+/* true when the resource is found in the generated table */
+static bool
+oc_core_uri_table_contains(const oc_resource_t *resource)
+{
+  size_t path_len;
+  const char *path = oc_uri_index_path(resource, &path_len);
+  bool wildcard = path_len > 0 && path[path_len - 1] == '*';
+  if (wildcard) {
+    path_len--;
+  }
+  return oc_core_uri_table_find(path, path_len, wildcard) == resource;
+}
+
+static bool
+oc_core_uri_index_build(void)
+{
+  oc_uri_index_clear(&g_core_uri_index);
+  for (size_t device = 0; device < oc_core_get_num_devices(); device++) {
+    for (int i = 0; i < OC_NUM_CORE_RESOURCES_PER_DEVICE; i++) {
+      const oc_resource_t *resource = oc_core_get_resource_by_index(i, device);
+      if (resource == NULL || oc_string_len(resource->uri) == 0 ||
+          (device == 0 && oc_core_uri_table_contains(resource))) {
+        continue;
+      }
+      if (!oc_uri_index_insert(&g_core_uri_index, resource)) {
+        OC_ERR("oc_core_uri_index_build: index full");
+        return false;
+      }
+    }
+  }
+  g_core_uri_index.valid = true;
+  return true;
+}
+
+static const oc_resource_t *
+oc_core_uri_find(const char *path, size_t path_len, bool wildcard,
+                 size_t device)
+{
+  const oc_resource_t *resource =
+    oc_uri_index_find(&g_core_uri_index, path, path_len, wildcard, device);
+  if (resource == NULL && device == 0) {
+    resource = oc_core_uri_table_find(path, path_len, wildcard);
+  }
+  return resource;
+}
+
+/* the core resource with the uri, or the core resource with a wildcard uri
+ * that matches the path */
+static const oc_resource_t *
+oc_ri_find_core_resource(const char *path, size_t path_len, size_t device)
+{
+  const oc_resource_t *resource =
+    oc_core_uri_find(path, path_len, false, device);
+  if (resource) {
+    return resource;
+  }
+  // the longest prefix ending with '/', followed by at least 1 character
+  for (size_t i = path_len - 1; i > 0; i--) {
+    if (path[i - 1] == '/') {
+      resource = oc_core_uri_find(path, i, true, device);
+      if (resource) {
+        return resource;
+      }
+    }
+  }
+  return NULL;
+}
+
+/* walks the core resources, in case the index is not available */
+static const oc_resource_t *
+oc_ri_find_core_resource_in_list(const char *path, size_t path_len,
+                                 size_t device)
+{
+  for (int i = 0; i < OC_NUM_CORE_RESOURCES_PER_DEVICE; i++) {
+    const oc_resource_t *resource = oc_core_get_resource_by_index(i, device);
+    if (resource == NULL) {
+      continue;
+    }
+    if (oc_string_len(resource->uri) == (path_len + 1) &&
+        strncmp((const char *)oc_string(resource->uri) + 1, path, path_len) ==
+          0) {
+      return resource;
+    }
+    if (oc_uri_contains_wildcard(oc_string(resource->uri))) {
+      size_t len_resource = oc_string_len(resource->uri);
+      // incoming URL should be equal or larger than the one with the wild
+      // card comparison should match to what ever is in front of the last
+      // char.
+      if ((path_len + 1) >= len_resource &&
+          strncmp((const char *)oc_string(resource->uri) + 1, path,
+                  len_resource - 2) == 0) {
+        return resource;
+      }
+    }
+  }
+  return NULL;
+}
+
+const oc_resource_t *
+oc_ri_get_core_resource_by_uri(const char *uri, size_t uri_len, size_t device)
+{
+  if (!uri || uri_len == 0)
+    return NULL;
+  if (uri[0] == '/') {
+    uri++;
+    uri_len--;
+    if (uri_len == 0)
+      return NULL;
+  }
+  if (!g_core_uri_index.valid && !oc_core_uri_index_build()) {
+    return oc_ri_find_core_resource_in_list(uri, uri_len, device);
+  }
+  return oc_ri_find_core_resource(uri, uri_len, device);
+}
+
+void
+oc_ri_invalidate_uri_index(void)
+{
+  g_core_uri_index.valid = false;
+#ifdef OC_SERVER
+  g_app_uri_index.valid = false;
+#endif /* OC_SERVER */
+}
+
 #ifdef OC_SERVER
+static bool
+oc_app_uri_index_build(void)
+{
+  oc_uri_index_clear(&g_app_uri_index);
+  const oc_resource_t *res = oc_ri_get_app_resources();
+  for (; res != NULL; res = res->next) {
+    if (oc_string_len(res->uri) > 0 &&
+        !oc_uri_index_insert(&g_app_uri_index, res)) {
+      OC_ERR("oc_app_uri_index_build: index full");
+      return false;
+    }
+  }
+  g_app_uri_index.valid = true;
+  return true;
+}
+
+/* adds the resource to the index, if the index is in use */
+static void
+oc_app_uri_index_add(const oc_resource_t *resource)
+{
+  if (g_app_uri_index.valid &&
+      !oc_uri_index_insert(&g_app_uri_index, resource)) {
+    g_app_uri_index.valid = false;
+  }
+}
+
 const oc_resource_t *
 oc_ri_get_app_resource_by_uri(const char *uri, size_t uri_len, size_t device)
 {
@@ -636,6 +1156,10 @@ oc_ri_get_app_resource_by_uri(const char *uri, size_t uri_len, size_t device)
   int skip = 0;
   if (uri[0] != '/')
     skip = 1;
+  if (g_app_uri_index.valid || oc_app_uri_index_build()) {
+    return oc_uri_index_find(&g_app_uri_index, uri + 1 - skip,
+                             uri_len - 1 + skip, false, device);
+  }
   const oc_resource_t *res = oc_ri_get_app_resources();
   while (res != NULL) {
     if (oc_string_len(res->uri) == (uri_len + skip) &&
@@ -648,6 +1172,17 @@ oc_ri_get_app_resource_by_uri(const char *uri, size_t uri_len, size_t device)
   return res;
 }
 
+const oc_resource_t *
+oc_ri_get_resource_by_uri(const char *uri, size_t uri_len, size_t device)
+{
+  const oc_resource_t *resource =
+    oc_ri_get_core_resource_by_uri(uri, uri_len, device);
+  if (resource) {
+    return resource;
+  }
+  return oc_ri_get_app_resource_by_uri(uri, uri_len, device);
+}
+
 static void
 oc_ri_delete_all_app_resources(void)
 {
@@ -676,10 +1211,13 @@ oc_ri_init(void)
 #ifdef OC_SERVER
   oc_list_init(app_resources);
   oc_list_init(observe_callbacks);
+  oc_uri_index_clear(&g_app_uri_index);
 #endif
+  oc_uri_index_clear(&g_core_uri_index);
 
 #ifdef OC_CLIENT
   oc_list_init(client_cbs);
+  oc_token_index_clear(&client_cbs_index);
 #endif
 
   oc_list_init(timed_callbacks);
@@ -727,8 +1265,11 @@ oc_ri_delete_resource(const oc_resource_t *_resource)
     coap_remove_observer_by_resource(resource);
   }
 
+  oc_s_mode_resource_deleted(resource);
   oc_ri_free_resource_properties(resource);
   oc_memb_free(&app_resources_s, resource);
+  g_app_uri_index.valid = false;
+  oc_core_group_object_table_changed();
   return true;
 }
 
@@ -763,9 +1304,12 @@ oc_ri_delete_resource_block(const oc_resource_t *_resource)
     if (resource->runtime_data->num_observers > 0) {
       coap_remove_observer_by_resource(resource);
     }
+    oc_s_mode_resource_deleted(resource);
     oc_ri_free_resource_properties(resource);
     oc_memb_free(&app_resources_s, resource);
   }
+  g_app_uri_index.valid = false;
+  oc_core_group_object_table_changed();
 
   return true;
 }
@@ -792,6 +1336,8 @@ oc_ri_add_resource(oc_resource_t *resource)
 
   if (valid) {
     oc_list_add(app_resources, resource);
+    oc_app_uri_index_add(resource);
+    oc_core_group_object_table_changed();
   }
 
   return valid;
@@ -820,6 +1366,8 @@ oc_ri_add_resource_block(const oc_resource_t *resource)
 
   if (valid) {
     oc_list_add_block(app_resources, (void *)resource);
+    g_app_uri_index.valid = false;
+    oc_core_group_object_table_changed();
   }
 
   return valid;
@@ -861,6 +1409,38 @@ oc_ri_resource_next(const oc_resource_t *resource)
   return resource;
 }
 
+static void
+schedule_event_callbacks(void)
+{
+  struct oc_etimer *first = oc_etimer_queue_first(&event_callback_timers);
+
+  OC_PROCESS_CONTEXT_BEGIN(&timed_callback_events);
+  if (first == NULL) {
+    oc_etimer_stop(&event_callback_timer);
+  } else if (oc_timer_expired(&first->timer)) {
+    oc_etimer_set(&event_callback_timer, 0);
+  } else {
+    oc_etimer_set(&event_callback_timer, oc_timer_remaining(&first->timer));
+  }
+  OC_PROCESS_CONTEXT_END(&timed_callback_events);
+}
+
+static void
+add_event_callback_timer(oc_event_callback_t *event_cb)
+{
+  oc_etimer_queue_add(&event_callback_timers, &event_cb->timer);
+  /* the event timer only needs to move when this one expires first */
+  if (oc_etimer_queue_first(&event_callback_timers) == &event_cb->timer) {
+    schedule_event_callbacks();
+  }
+}
+
+static void
+remove_event_callback_timer(oc_event_callback_t *event_cb)
+{
+  oc_etimer_queue_remove(&event_callback_timers, &event_cb->timer);
+}
+
 void
 oc_ri_remove_timed_event_callback(void *cb_data, oc_trigger_t event_callback)
 {
@@ -869,9 +1449,7 @@ oc_ri_remove_timed_event_callback(void *cb_data, oc_trigger_t event_callback)
 
   while (event_cb != NULL) {
     if (event_cb->data == cb_data && event_cb->callback == event_callback) {
-      OC_PROCESS_CONTEXT_BEGIN(&timed_callback_events);
-      oc_etimer_stop(&event_cb->timer);
-      OC_PROCESS_CONTEXT_END(&timed_callback_events);
+      remove_event_callback_timer(event_cb);
       oc_list_remove(timed_callbacks, event_cb);
       oc_memb_free(&event_callbacks_s, event_cb);
       break;
@@ -890,9 +1468,8 @@ oc_ri_add_timed_event_callback_ticks(void *cb_data, oc_trigger_t event_callback,
   if (event_cb) {
     event_cb->data = cb_data;
     event_cb->callback = event_callback;
-    OC_PROCESS_CONTEXT_BEGIN(&timed_callback_events);
-    oc_etimer_set(&event_cb->timer, ticks);
-    OC_PROCESS_CONTEXT_END(&timed_callback_events);
+    oc_timer_set(&event_cb->timer.timer, ticks);
+    add_event_callback_timer(event_cb);
     oc_list_add(timed_callbacks, event_cb);
   } else {
     OC_WRN("insufficient memory to add timed event callback");
@@ -900,40 +1477,39 @@ oc_ri_add_timed_event_callback_ticks(void *cb_data, oc_trigger_t event_callback,
 }
 
 static void
-poll_event_callback_timers(oc_list_t list, struct oc_memb *cb_pool)
+free_event_callback(oc_event_callback_t *event_cb)
 {
-  oc_event_callback_t *event_cb = (oc_event_callback_t *)oc_list_head(list),
-                      *next;
-
-  while (event_cb != NULL) {
-    next = event_cb->next;
-
-    if (oc_etimer_expired(&event_cb->timer)) {
-      if (event_cb->callback(event_cb->data) == OC_EVENT_DONE) {
-        oc_list_remove(list, event_cb);
-        oc_memb_free(cb_pool, event_cb);
-        event_cb = oc_list_head(list);
-        continue;
-      } else {
-        OC_PROCESS_CONTEXT_BEGIN(&timed_callback_events);
-        oc_etimer_restart(&event_cb->timer);
-        OC_PROCESS_CONTEXT_END(&timed_callback_events);
-        event_cb = oc_list_head(list);
-        continue;
-      }
-    }
-
-    event_cb = next;
+  /* the callback may have removed itself already */
+  if (oc_list_remove2(timed_callbacks, event_cb) == NULL
+#ifdef OC_SERVER
+      && oc_list_remove2(observe_callbacks, event_cb) == NULL
+#endif /* OC_SERVER */
+  ) {
+    return;
   }
+  oc_memb_free(&event_callbacks_s, event_cb);
 }
 
 static void
 check_event_callbacks(void)
 {
-#ifdef OC_SERVER
-  poll_event_callback_timers(observe_callbacks, &event_callbacks_s);
-#endif /* OC_SERVER */
-  poll_event_callback_timers(timed_callbacks, &event_callbacks_s);
+  struct oc_etimer *timer = oc_etimer_queue_first(&event_callback_timers);
+
+  /* only the expired callbacks are visited, the first one is the earliest */
+  while (timer != NULL && oc_timer_expired(&timer->timer)) {
+    oc_event_callback_t *event_cb =
+      (oc_event_callback_t *)((char *)timer -
+                              offsetof(oc_event_callback_t, timer));
+    oc_etimer_queue_remove(&event_callback_timers, timer);
+    if (event_cb->callback(event_cb->data) == OC_EVENT_DONE) {
+      free_event_callback(event_cb);
+    } else {
+      oc_timer_restart(&timer->timer);
+      oc_etimer_queue_add(&event_callback_timers, timer);
+    }
+    timer = oc_etimer_queue_first(&event_callback_timers);
+  }
+  schedule_event_callbacks();
 }
 
 #ifdef OC_SERVER
@@ -986,7 +1562,7 @@ remove_periodic_observe_callback(const oc_resource_t *resource)
   oc_event_callback_t *event_cb = get_periodic_observe_callback(resource);
 
   if (event_cb) {
-    oc_etimer_stop(&event_cb->timer);
+    remove_event_callback_timer(event_cb);
     oc_list_remove(observe_callbacks, event_cb);
     oc_memb_free(&event_callbacks_s, event_cb);
   }
@@ -1007,10 +1583,9 @@ add_periodic_observe_callback(const oc_resource_t *resource)
 
     event_cb->data = (void *)resource;
     event_cb->callback = periodic_observe_handler;
-    OC_PROCESS_CONTEXT_BEGIN(&timed_callback_events);
-    oc_etimer_set(&event_cb->timer,
-                  (uint64_t)resource->observe_period_seconds * OC_CLOCK_SECOND);
-    OC_PROCESS_CONTEXT_END(&timed_callback_events);
+    oc_timer_set(&event_cb->timer.timer,
+                 (uint64_t)resource->observe_period_seconds * OC_CLOCK_SECOND);
+    add_event_callback_timer(event_cb);
     oc_list_add(observe_callbacks, event_cb);
   }
 
@@ -1025,7 +1600,7 @@ free_all_event_timers(void)
   oc_event_callback_t *obs_cb =
     (oc_event_callback_t *)oc_list_pop(observe_callbacks);
   while (obs_cb != NULL) {
-    oc_etimer_stop(&obs_cb->timer);
+    remove_event_callback_timer(obs_cb);
     oc_list_remove(observe_callbacks, obs_cb);
     oc_memb_free(&event_callbacks_s, obs_cb);
     obs_cb = oc_list_pop(observe_callbacks);
@@ -1034,11 +1609,12 @@ free_all_event_timers(void)
   oc_event_callback_t *event_cb =
     (oc_event_callback_t *)oc_list_pop(timed_callbacks);
   while (event_cb != NULL) {
-    oc_etimer_stop(&event_cb->timer);
+    remove_event_callback_timer(event_cb);
     oc_list_remove(timed_callbacks, event_cb);
     oc_memb_free(&event_callbacks_s, event_cb);
     event_cb = oc_list_pop(timed_callbacks);
   }
+  schedule_event_callbacks();
 }
 
 oc_interface_mask_t
@@ -1129,6 +1705,7 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
   request_obj.request_payload = NULL;
   request_obj.query = NULL;
   request_obj.query_len = 0;
+  oc_ri_parse_query(&request_obj.query_index, NULL, 0);
   request_obj.resource = NULL;
   request_obj.origin = endpoint;
   request_obj._payload = NULL;
@@ -1159,11 +1736,13 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
   if (uri_query_len) {
     request_obj.query = uri_query;
     request_obj.query_len = (int)uri_query_len;
+    /* Parse the query once, the handlers look up the parameters in the index.
+     */
+    oc_ri_parse_query(&request_obj.query_index, uri_query, uri_query_len);
 
     /* Check if query string includes interface selection. */
     char *iface;
-    int if_len =
-      oc_ri_get_query_value(uri_query, (int)uri_query_len, "if", &iface);
+    int if_len = oc_ri_get_request_query_value(&request_obj, "if", &iface);
     if (if_len != -1) {
       iface_query |= oc_ri_get_interface_mask(iface, (size_t)if_len);
     }
@@ -1186,6 +1765,27 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
   request_obj.accept = accept;
   request_obj.uri_path = uri_path;
   request_obj.uri_path_len = uri_path_len;
+  const oc_resource_t *resource, *cur_resource = NULL;
+
+  /* If there were no errors thus far, attempt to locate the specific
+   * resource object that will handle the request using the request uri.
+   */
+  /* Check against list of declared core resources.
+   */
+  if (!bad_request) {
+    request_obj.resource = cur_resource =
+      oc_ri_get_core_resource_by_uri(uri_path, uri_path_len, endpoint->device);
+  }
+
+#ifdef OC_SERVER
+  /* Check against list of declared application resources.
+   */
+  if (!cur_resource && !bad_request) {
+    request_obj.resource = cur_resource =
+      oc_ri_get_app_resource_by_uri(uri_path, uri_path_len, endpoint->device);
+  }
+#endif /* OC_SERVER */
+
 #ifndef OC_DYNAMIC_ALLOCATION
   char rep_objects_alloc[OC_MAX_NUM_REP_OBJECTS];
   oc_rep_t rep_objects_pool[OC_MAX_NUM_REP_OBJECTS];
@@ -1199,7 +1799,8 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
 #endif /* OC_DYNAMIC_ALLOCATION */
   oc_rep_set_pool(&rep_objects);
 
-  if (payload_len > 0 && (cf == APPLICATION_CBOR || cf == APPLICATION_OSCORE)) {
+  if (payload_len > 0 && (cf == APPLICATION_CBOR || cf == APPLICATION_OSCORE) &&
+      !(cur_resource && (cur_resource->properties & OC_RAW_PAYLOAD))) {
     /* Attempt to parse request payload using tinyCBOR via oc_rep helper
      * functions. The result of this parse is a tree of oc_rep_t structures
      * which will reflect the schema of the payload.
@@ -1217,48 +1818,6 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
     }
   }
 
-  const oc_resource_t *resource, *cur_resource = NULL;
-
-  /* If there were no errors thus far, attempt to locate the specific
-   * resource object that will handle the request using the request uri.
-   */
-  /* Check against list of declared core resources.
-   */
-  if (!bad_request) {
-    int i;
-    int len_resource;
-    for (i = 0; i < OC_NUM_CORE_RESOURCES_PER_DEVICE; i++) {
-      resource = oc_core_get_resource_by_index(i, endpoint->device);
-      if (oc_string_len(resource->uri) == (uri_path_len + 1) &&
-          strncmp((const char *)oc_string(resource->uri) + 1, uri_path,
-                  uri_path_len) == 0) {
-        request_obj.resource = cur_resource = resource;
-        break;
-      }
-      if (oc_uri_contains_wildcard(oc_string(resource->uri))) {
-        len_resource = (int)oc_string_len(resource->uri);
-        // incoming URL should be equal or larger than the one with the wild
-        // card comparison should match to what ever is in front of the last
-        // char.
-        if (((int)(uri_path_len + 1) >= len_resource) &&
-            strncmp((const char *)oc_string(resource->uri) + 1, uri_path,
-                    (size_t)len_resource - 2) == 0) {
-          request_obj.resource = cur_resource = resource;
-          break;
-        }
-      }
-    }
-  }
-
-#ifdef OC_SERVER
-  /* Check against list of declared application resources.
-   */
-  if (!cur_resource && !bad_request) {
-    request_obj.resource = cur_resource =
-      oc_ri_get_app_resource_by_uri(uri_path, uri_path_len, endpoint->device);
-  }
-#endif /* OC_SERVER */
-
   if (cur_resource) {
     /* If there was no interface selection, pick the "default interface". */
     iface_mask = iface_query;
@@ -1569,6 +2128,7 @@ static void
 free_client_cb(oc_client_cb_t *cb)
 {
   oc_list_remove(client_cbs, cb);
+  oc_token_index_remove(&client_cbs_index, cb);
 #ifdef OC_BLOCK_WISE
   oc_blockwise_scrub_buffers_for_client_cb(cb);
 #endif /* OC_BLOCK_WISE */
@@ -1650,25 +2210,33 @@ oc_ri_free_client_cbs_by_endpoint(oc_endpoint_t *endpoint)
 oc_client_cb_t *
 oc_ri_find_client_cb_by_mid(uint16_t mid)
 {
-  oc_client_cb_t *cb = oc_list_head(client_cbs);
-  while (cb) {
-    if (cb->mid == mid)
-      break;
-    cb = cb->next;
-  }
-  return cb;
+  return (oc_client_cb_t *)oc_token_index_find_by_mid(&client_cbs_index,
+                                                      client_cbs, mid);
 }
 
 oc_client_cb_t *
 oc_ri_find_client_cb_by_token(uint8_t *token, uint8_t token_len)
 {
-  oc_client_cb_t *cb = oc_list_head(client_cbs);
-  while (cb != NULL) {
-    if (cb->token_len == token_len && memcmp(cb->token, token, token_len) == 0)
-      break;
-    cb = cb->next;
-  }
-  return cb;
+  return (oc_client_cb_t *)oc_token_index_find_by_token(
+    &client_cbs_index, client_cbs, token, token_len);
+}
+
+void
+oc_ri_set_client_cb_mid(oc_client_cb_t *cb, uint16_t mid)
+{
+  oc_token_index_remove(&client_cbs_index, cb);
+  cb->mid = mid;
+  oc_token_index_add(&client_cbs_index, cb);
+}
+
+void
+oc_ri_set_client_cb_token(oc_client_cb_t *cb, const uint8_t *token,
+                          uint8_t token_len)
+{
+  oc_token_index_remove(&client_cbs_index, cb);
+  memcpy(cb->token, token, token_len);
+  cb->token_len = token_len;
+  oc_token_index_add(&client_cbs_index, cb);
 }
 
 bool
@@ -1898,6 +2466,7 @@ free_all_client_cbs(void)
     free_client_cb(cb);
     cb = oc_list_pop(client_cbs);
   }
+  oc_token_index_clear(&client_cbs_index);
 }
 
 oc_client_cb_t *
@@ -1936,6 +2505,7 @@ oc_ri_alloc_client_cb(const char *uri, oc_endpoint_t *endpoint,
   // if ((handler.response != NULL) && (handler.discovery_all != NULL) &&
   //    (handler.discovery != NULL)) {
   oc_list_add(client_cbs, cb);
+  oc_token_index_add(&client_cbs_index, cb);
   //}
 
   return cb;
@@ -1966,7 +2536,9 @@ oc_ri_shutdown(void)
 
 #ifdef OC_SERVER
   oc_ri_delete_all_app_resources();
+  oc_uri_index_free(&g_app_uri_index);
 #endif /* OC_SERVER */
+  oc_uri_index_free(&g_core_uri_index);
 
   oc_random_destroy();
 }
@@ -58,7 +58,7 @@ oc_get_query_value(oc_request_t *request, const char *key, char **value)
 {
   if (!request)
     return -1;
-  return oc_ri_get_query_value(request->query, request->query_len, key, value);
+  return oc_ri_get_request_query_value(request, key, value);
 }
 
 int
@@ -66,7 +66,7 @@ oc_query_value_exists(oc_request_t *request, const char *key)
 {
   if (!request)
     return -1;
-  return oc_ri_query_exists(request->query, request->query_len, key);
+  return oc_ri_request_query_exists(request, key);
 }
 
 bool
@@ -197,9 +197,8 @@ oc_iterate_query(oc_request_t *request, char **key, size_t *key_len,
                  char **value, size_t *value_len)
 {
   query_iterator++;
-  return oc_ri_get_query_nth_key_value(request->query, request->query_len, key,
-                                       key_len, value, value_len,
-                                       query_iterator);
+  return oc_ri_get_request_query_nth_key_value(request, key, key_len, value,
+                                               value_len, query_iterator);
 }
 
 bool
@@ -303,6 +302,8 @@ oc_new_resource(const char *name, const char *uri, uint8_t num_resource_types,
       resource->observe_period_seconds = 0;
       resource->runtime_data = data;
       resource->runtime_data->num_observers = 0;
+      resource->runtime_data->got_first = 0;
+      resource->runtime_data->got_count = 0;
       resource->properties = OC_DISCOVERABLE;
       *(bool *)&resource->is_const = false;
       oc_populate_resource_object(resource, name, uri, num_resource_types,
@@ -24,6 +24,7 @@
 #include <string>
 
 #include "oc_api.h"
+#include "oc_core_res.h"
 #include "oc_helpers.h"
 #include "oc_ri.h"
 #include "api/oc_knx_sec.h"
@@ -62,12 +63,160 @@ TEST_F(TestOcRi, GetAppResourceByUri_P)
   oc_ri_delete_resource(res);
 }
 
+TEST_F(TestOcRi, GetAppResourceByUri_Index_P)
+{
+  const char *uris[] = { "/a/1", "/a/2", "/a/3", "/b",  "/b/1",
+                         "/c",   "/c/d", "/c/e", "/p/1", "/p/2" };
+  const int num_uris = sizeof(uris) / sizeof(uris[0]);
+  oc_resource_t *res[num_uris];
+
+  for (int i = 0; i < num_uris; i++) {
+    res[i] = oc_new_resource(RESOURCE_NAME, uris[i], 1, 0);
+    ASSERT_NE(res[i], nullptr) << uris[i];
+    oc_resource_set_request_handler(res[i], OC_GET, onGet, NULL);
+    oc_ri_add_resource(res[i]);
+  }
+
+  // with and without leading '/'
+  for (int i = 0; i < num_uris; i++) {
+    EXPECT_EQ(res[i], oc_ri_get_app_resource_by_uri(uris[i], strlen(uris[i]),
+                                                    0))
+      << uris[i];
+    EXPECT_EQ(res[i], oc_ri_get_app_resource_by_uri(
+                        uris[i] + 1, strlen(uris[i]) - 1, 0))
+      << uris[i];
+    EXPECT_EQ(res[i], oc_ri_get_resource_by_uri(uris[i], strlen(uris[i]), 0))
+      << uris[i];
+  }
+
+  // the index is rebuilt after invalidation
+  oc_ri_invalidate_uri_index();
+  for (int i = 0; i < num_uris; i++) {
+    EXPECT_EQ(res[i], oc_ri_get_app_resource_by_uri(uris[i], strlen(uris[i]),
+                                                    0))
+      << uris[i];
+  }
+
+  for (int i = 0; i < num_uris; i++) {
+    oc_ri_delete_resource(res[i]);
+  }
+}
+
+TEST_F(TestOcRi, GetAppResourceByUri_Wildcard_P)
+{
+  oc_resource_t *res;
+
+  // application resources are matched on the complete uri, also with a '*'
+  res = oc_new_resource(RESOURCE_NAME, "/app/*", 1, 0);
+  oc_resource_set_request_handler(res, OC_GET, onGet, NULL);
+  oc_ri_add_resource(res);
+
+  EXPECT_EQ(res, oc_ri_get_app_resource_by_uri("/app/*", 6, 0));
+  EXPECT_EQ(nullptr, oc_ri_get_app_resource_by_uri("/app/1", 6, 0));
+  EXPECT_EQ(nullptr, oc_ri_get_app_resource_by_uri("/app/", 5, 0));
+  oc_ri_delete_resource(res);
+}
+
+TEST_F(TestOcRi, GetAppResourceByUri_AddDelete_P)
+{
+  oc_resource_t *res1, *res2, *res3;
+
+  res1 = oc_new_resource(RESOURCE_NAME, RESOURCE_URI, 1, 0);
+  oc_resource_set_request_handler(res1, OC_GET, onGet, NULL);
+  oc_ri_add_resource(res1);
+  // builds the index
+  EXPECT_EQ(res1, oc_ri_get_app_resource_by_uri(RESOURCE_URI,
+                                                strlen(RESOURCE_URI), 0));
+
+  // added to the existing index
+  res2 = oc_new_resource(RESOURCE_NAME, "/second", 1, 0);
+  oc_resource_set_request_handler(res2, OC_GET, onGet, NULL);
+  oc_ri_add_resource(res2);
+  EXPECT_EQ(res2, oc_ri_get_app_resource_by_uri("/second", 7, 0));
+  EXPECT_EQ(res1, oc_ri_get_app_resource_by_uri(RESOURCE_URI,
+                                                strlen(RESOURCE_URI), 0));
+
+  // deleted resources are no longer found
+  oc_ri_delete_resource(res1);
+  EXPECT_EQ(nullptr, oc_ri_get_app_resource_by_uri(RESOURCE_URI,
+                                                   strlen(RESOURCE_URI), 0));
+  EXPECT_EQ(res2, oc_ri_get_app_resource_by_uri("/second", 7, 0));
+
+  // a new resource with the uri of a deleted resource
+  res3 = oc_new_resource(RESOURCE_NAME, RESOURCE_URI, 1, 0);
+  oc_resource_set_request_handler(res3, OC_GET, onGet, NULL);
+  oc_ri_add_resource(res3);
+  EXPECT_EQ(res3, oc_ri_get_app_resource_by_uri(RESOURCE_URI,
+                                                strlen(RESOURCE_URI), 0));
+
+  oc_ri_delete_resource(res2);
+  oc_ri_delete_resource(res3);
+  EXPECT_EQ(nullptr, oc_ri_get_app_resource_by_uri("/second", 7, 0));
+  EXPECT_EQ(nullptr, oc_ri_get_app_resource_by_uri(RESOURCE_URI,
+                                                   strlen(RESOURCE_URI), 0));
+}
+
 TEST_F(TestOcRi, GetAppResourceByUri_N)
 {
   oc_resource_t *res;
 
   res = oc_ri_get_app_resource_by_uri(RESOURCE_URI, strlen(RESOURCE_URI), 0);
   EXPECT_EQ(res, nullptr);
+
+  res = oc_new_resource(RESOURCE_NAME, RESOURCE_URI, 1, 0);
+  oc_resource_set_request_handler(res, OC_GET, onGet, NULL);
+  oc_ri_add_resource(res);
+
+  // misses: prefix, longer uri, other case, other device, empty uri
+  const char *misses[] = { "/LightResource", RESOURCE_URI "/1",
+                           "/lightresourceuri", "/" };
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(nullptr, oc_ri_get_app_resource_by_uri(misses[i],
+                                                     strlen(misses[i]), 0))
+      << misses[i];
+  }
+  EXPECT_EQ(nullptr, oc_ri_get_app_resource_by_uri(RESOURCE_URI,
+                                                   strlen(RESOURCE_URI), 1));
+  EXPECT_EQ(nullptr, oc_ri_get_app_resource_by_uri(RESOURCE_URI, 0, 0));
+  EXPECT_EQ(nullptr, oc_ri_get_app_resource_by_uri(NULL, 0, 0));
+  oc_ri_delete_resource(res);
+}
+
+TEST_F(TestOcRi, GetCoreResourceByUri_Wildcard_P)
+{
+  oc_core_init();
+  oc_add_device("myhname", "1.0.0", "//", "000001", NULL, NULL);
+
+  const oc_resource_t *res;
+
+  // exact match before the wildcard
+  res = oc_ri_get_core_resource_by_uri("/fp/g", 5, 0);
+  ASSERT_NE(nullptr, res);
+  EXPECT_STREQ("/fp/g", oc_string(res->uri));
+
+  // wildcard matches, with and without leading '/'
+  res = oc_ri_get_core_resource_by_uri("/fp/g/1", 7, 0);
+  ASSERT_NE(nullptr, res);
+  EXPECT_STREQ("/fp/g/*", oc_string(res->uri));
+  res = oc_ri_get_core_resource_by_uri("fp/r/12", 7, 0);
+  ASSERT_NE(nullptr, res);
+  EXPECT_STREQ("/fp/r/*", oc_string(res->uri));
+  res = oc_ri_get_resource_by_uri("/auth/at/abc", 12, 0);
+  ASSERT_NE(nullptr, res);
+  EXPECT_STREQ("/auth/at/*", oc_string(res->uri));
+
+  // the wildcard needs at least 1 character, no wildcard on other paths
+  EXPECT_EQ(nullptr, oc_ri_get_core_resource_by_uri("/fp/g/", 6, 0));
+  EXPECT_EQ(nullptr, oc_ri_get_core_resource_by_uri("/fp/x/1", 7, 0));
+  EXPECT_EQ(nullptr, oc_ri_get_core_resource_by_uri("/dev/sn/1", 9, 0));
+
+  // same results after the index is rebuilt
+  oc_ri_invalidate_uri_index();
+  res = oc_ri_get_core_resource_by_uri("/fp/g/1", 7, 0);
+  ASSERT_NE(nullptr, res);
+  EXPECT_STREQ("/fp/g/*", oc_string(res->uri));
+
+  oc_core_shutdown();
 }
 
 TEST_F(TestOcRi, RiGetAppResource_P)
@@ -153,6 +302,58 @@ TEST_F(TestOcRi, RIGetQueryValue_P)
     EXPECT_EQ(-1, ret) << "N input[" << i << "] " << input[i] << " "
                        << "key2";
   }
+
+  // duplicate keys (first one), empty values, keys without '=' (they end
+  // the search for a value) and a query with more parameters than the
+  // parsed query of a request holds
+  std::string overlong;
+  for (int i = 0; i < OC_MAX_QUERY_PARAMS; i++) {
+    overlong += "p" + std::to_string(i) + "=" + std::to_string(i) + "&";
+  }
+  overlong += "key=last";
+  struct
+  {
+    const char *query;
+    int ret;
+    const char *value;
+  } cases[] = { { "key=1&key=2", 1, "1" },
+                { "data=1&key=2&key=3", 1, "2" },
+                { "key=", 0, "" },
+                { "key=&data=1", 0, "" },
+                { "data=&key=2", 1, "2" },
+                { "KEY=3", 1, "3" },
+                { "key=1&", 1, "1" },
+                { "key", -1, NULL },
+                { "x&key=1", -1, NULL },
+                { "key&key=1", -1, NULL },
+                { "key=1&x", 1, "1" },
+                { overlong.c_str(), 4, "last" } };
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    const char *query = cases[i].query;
+    value = NULL;
+    ret = oc_ri_get_query_value(query, strlen(query), "key", &value);
+    EXPECT_EQ(cases[i].ret, ret) << "input " << query;
+    if (cases[i].value != NULL && ret >= 0) {
+      EXPECT_EQ(std::string(cases[i].value), std::string(value, ret))
+        << "input " << query;
+    }
+
+    // the parsed query of a request gives the same answer
+    oc_request_t request;
+    memset(&request, 0, sizeof(request));
+    request.query = query;
+    request.query_len = strlen(query);
+    char *request_value = NULL;
+    int request_ret =
+      oc_ri_get_request_query_value(&request, "key", &request_value);
+    EXPECT_EQ(ret, request_ret) << "request input " << query;
+    if (ret >= 0) {
+      EXPECT_EQ(value, request_value) << "request input " << query;
+    }
+    EXPECT_EQ(-1, oc_ri_get_request_query_value(&request, "key2",
+                                                &request_value))
+      << "request input " << query;
+  }
 }
 
 TEST_F(TestOcRi, RIQueryExists_P)
@@ -178,6 +379,36 @@ TEST_F(TestOcRi, RIQueryExists_P)
     EXPECT_EQ(-1, ret) << "N input[" << i << "] " << input[i] << " "
                        << "key2";
   }
+
+  // duplicate keys, empty values, keys without '=' and a query with more
+  // parameters than the parsed query of a request holds
+  std::string overlong;
+  for (int i = 0; i < OC_MAX_QUERY_PARAMS; i++) {
+    overlong += "p" + std::to_string(i) + "&";
+  }
+  overlong += "key";
+  const char *cases[] = { "key=1&key=2", "key&key",   "key=",
+                          "key=&data=1", "data=&key", "x&y&key",
+                          "KEY",         "key&",      overlong.c_str() };
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    const char *query = cases[i];
+    EXPECT_EQ(1, oc_ri_query_exists(query, strlen(query), "key"))
+      << "input " << query;
+    EXPECT_EQ(-1, oc_ri_query_exists(query, strlen(query), "ke"))
+      << "input " << query;
+
+    // the parsed query of a request gives the same answer
+    oc_request_t request;
+    memset(&request, 0, sizeof(request));
+    request.query = query;
+    request.query_len = strlen(query);
+    EXPECT_EQ(1, oc_ri_request_query_exists(&request, "key"))
+      << "request input " << query;
+    EXPECT_EQ(-1, oc_ri_request_query_exists(&request, "ke"))
+      << "request input " << query;
+    EXPECT_EQ(-1, oc_ri_request_query_exists(&request, "key2"))
+      << "request input " << query;
+  }
 }
 
 TEST_F(TestOcRi, RIinterfacestring_P)
@@ -0,0 +1,845 @@
+/******************************************************************
+ *
+ * Copyright 2025 Cascoda Ltd All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "oc_api.h"
+#include "oc_core_res.h"
+#include "oc_helpers.h"
+#include "oc_knx.h"
+#include "oc_ri.h"
+#include "api/oc_knx_fp.h"
+#include "messaging/coap/oc_coap.h"
+#include "port/oc_storage.h"
+
+#define FP_TEST_STORAGE "./fp_test_storage"
+#define GOT_BLOB_STORE "GOT_BLOB"
+#define FP_BLOB_HEADER_SIZE (16)
+
+class TestFp : public testing::Test {
+protected:
+  virtual void SetUp()
+  {
+    oc_ri_init();
+    oc_storage_config(FP_TEST_STORAGE);
+    oc_storage_erase(GOT_BLOB_STORE);
+    oc_storage_erase("GRECT_BLOB");
+    oc_storage_erase("GPUBT_BLOB");
+    oc_create_knx_fp_resources(0);
+  }
+
+  virtual void TearDown()
+  {
+    oc_free_knx_fp_resources(0);
+    oc_storage_erase(GOT_BLOB_STORE);
+    oc_storage_erase("GRECT_BLOB");
+    oc_storage_erase("GPUBT_BLOB");
+    oc_ri_shutdown();
+  }
+
+  static void set_entry(int index, int id, const char *href,
+                        std::vector<uint32_t> ga)
+  {
+    oc_group_object_table_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.id = id;
+    entry.cflags = (oc_cflag_mask_t)(OC_CFLAG_READ | OC_CFLAG_WRITE);
+    oc_new_string(&entry.href, href, strlen(href));
+    entry.ga = ga.data();
+    entry.ga_len = (int)ga.size();
+    oc_core_set_group_object_table(index, entry);
+    oc_free_string(&entry.href);
+  }
+
+  /* the indices of the entries with the group address, by scanning */
+  static std::vector<int> scan(uint32_t ga)
+  {
+    std::vector<int> indices;
+    for (int i = 0; i < oc_core_get_group_object_table_total_size(); i++) {
+      oc_group_object_table_t *entry = oc_core_get_group_object_table_entry(i);
+      if (entry->id < 0) {
+        continue;
+      }
+      for (int j = 0; j < entry->ga_len; j++) {
+        if (entry->ga[j] == ga) {
+          indices.push_back(i);
+          break;
+        }
+      }
+    }
+    return indices;
+  }
+
+  /* the indices of the entries with the group address, from the index */
+  static std::vector<int> find(uint32_t ga)
+  {
+    std::vector<int> indices;
+    for (int i = oc_core_find_group_object_table_index(ga); i != -1;
+         i = oc_core_find_next_group_object_table_index(ga, i)) {
+      indices.push_back(i);
+    }
+    return indices;
+  }
+
+  /* the indices of the entries with the group address, from the dispatch
+   * iterator */
+  static std::vector<int> dispatch(uint32_t ga)
+  {
+    std::vector<int> indices;
+    oc_group_object_dispatch_t storage;
+    const oc_group_object_dispatch_t *entry;
+    int pos = 0;
+    while ((entry = oc_core_next_group_object_table_dispatch(ga, 0, &pos,
+                                                             &storage))) {
+      oc_group_object_table_t *got =
+        oc_core_get_group_object_table_entry(entry->index);
+      EXPECT_EQ(ga, entry->ga);
+      EXPECT_EQ(got->cflags, entry->cflags);
+      EXPECT_STREQ(oc_string(got->href), entry->href);
+      indices.push_back(entry->index);
+    }
+    return indices;
+  }
+};
+
+TEST_F(TestFp, GroupAddressIndex_P)
+{
+  set_entry(0, 1, "/p/1", { 1, 2, 3 });
+  set_entry(1, 2, "/p/2", { 2 });
+  set_entry(3, 4, "/p/4", { 3, 2, 100 });
+  set_entry(5, 6, "/p/6", { 100 });
+
+  for (uint32_t ga : { 1u, 2u, 3u, 100u }) {
+    EXPECT_EQ(scan(ga), find(ga)) << ga;
+    EXPECT_EQ(scan(ga), dispatch(ga)) << ga;
+  }
+  EXPECT_EQ(std::vector<int>({ 0, 1, 3 }), find(2));
+  EXPECT_TRUE(find(4).empty());
+  EXPECT_TRUE(dispatch(4).empty());
+  EXPECT_EQ(-1, oc_core_find_next_group_object_table_index(2, -1));
+}
+
+TEST_F(TestFp, GroupAddressIndexChange_P)
+{
+  set_entry(0, 1, "/p/1", { 1, 2 });
+  set_entry(2, 3, "/p/3", { 2 });
+  EXPECT_EQ(std::vector<int>({ 0, 2 }), find(2));
+
+  // changed group addresses and href of an entry
+  set_entry(0, 1, "/p/10", { 5 });
+  EXPECT_EQ(std::vector<int>({ 2 }), find(2));
+  EXPECT_EQ(std::vector<int>({ 0 }), find(5));
+  EXPECT_EQ(std::vector<int>({ 0 }), dispatch(5));
+  EXPECT_TRUE(find(1).empty());
+
+  // added and deleted entries
+  set_entry(1, 2, "/p/2", { 5, 2 });
+  EXPECT_EQ(std::vector<int>({ 0, 1 }), find(5));
+  oc_delete_group_object_table_entry(0);
+  EXPECT_EQ(std::vector<int>({ 1 }), find(5));
+  EXPECT_EQ(std::vector<int>({ 1, 2 }), find(2));
+  for (uint32_t ga : { 1u, 2u, 5u }) {
+    EXPECT_EQ(scan(ga), find(ga)) << ga;
+    EXPECT_EQ(scan(ga), dispatch(ga)) << ga;
+  }
+}
+
+TEST_F(TestFp, BlobRoundTrip_P)
+{
+  set_entry(0, 1, "/p/1", { 1, 2, 3 });
+  set_entry(4, 5, "/p/a/long/href", { 0x12345678 });
+  set_entry(7, 8, "", {});
+  oc_dump_group_object_table_entry(0);
+  oc_commit_fp_tables();
+
+  // load the stored table, as at start up
+  oc_free_knx_fp_resources(0);
+  oc_create_knx_fp_resources(0);
+
+  oc_group_object_table_t *entry = oc_core_get_group_object_table_entry(0);
+  EXPECT_EQ(1, entry->id);
+  EXPECT_STREQ("/p/1", oc_string(entry->href));
+  EXPECT_EQ(OC_CFLAG_READ | OC_CFLAG_WRITE, entry->cflags);
+  ASSERT_EQ(3, entry->ga_len);
+  EXPECT_EQ(1u, entry->ga[0]);
+  EXPECT_EQ(2u, entry->ga[1]);
+  EXPECT_EQ(3u, entry->ga[2]);
+
+  entry = oc_core_get_group_object_table_entry(4);
+  EXPECT_EQ(5, entry->id);
+  EXPECT_STREQ("/p/a/long/href", oc_string(entry->href));
+  ASSERT_EQ(1, entry->ga_len);
+  EXPECT_EQ(0x12345678u, entry->ga[0]);
+
+  entry = oc_core_get_group_object_table_entry(7);
+  EXPECT_EQ(8, entry->id);
+  EXPECT_EQ(0u, oc_string_len(entry->href));
+  EXPECT_EQ(0, entry->ga_len);
+
+  for (int i = 0; i < oc_core_get_group_object_table_total_size(); i++) {
+    if (i != 0 && i != 4 && i != 7) {
+      EXPECT_EQ(-1, oc_core_get_group_object_table_entry(i)->id) << i;
+    }
+  }
+  // the index is built from the loaded table
+  EXPECT_EQ(std::vector<int>({ 0 }), find(2));
+}
+
+TEST_F(TestFp, BlobEmptyTable_P)
+{
+  // an empty table is stored as a valid blob without entries
+  uint8_t header[FP_BLOB_HEADER_SIZE + 1];
+  EXPECT_EQ(FP_BLOB_HEADER_SIZE,
+            oc_storage_read(GOT_BLOB_STORE, header, sizeof(header)));
+
+  set_entry(0, 1, "/p/1", { 1 });
+  oc_dump_group_object_table_entry(0);
+  oc_commit_fp_tables();
+  oc_delete_group_object_table();
+  EXPECT_EQ(FP_BLOB_HEADER_SIZE,
+            oc_storage_read(GOT_BLOB_STORE, header, sizeof(header)));
+
+  oc_free_knx_fp_resources(0);
+  oc_create_knx_fp_resources(0);
+  EXPECT_EQ(-1, oc_core_get_group_object_table_entry(0)->id);
+}
+
+TEST_F(TestFp, BlobCrc_N)
+{
+  set_entry(0, 1, "/p/1", { 1, 2, 3 });
+  oc_dump_group_object_table_entry(0);
+  oc_commit_fp_tables();
+
+  // corrupt a byte of the records, behind the header
+  uint8_t buf[256];
+  long size = oc_storage_read(GOT_BLOB_STORE, buf, sizeof(buf));
+  ASSERT_GT(size, FP_BLOB_HEADER_SIZE);
+  buf[size - 1] ^= 0x01;
+  ASSERT_EQ(size, oc_storage_write(GOT_BLOB_STORE, buf, size));
+
+  // the corrupt blob is rejected, nothing is loaded
+  oc_free_knx_fp_resources(0);
+  oc_create_knx_fp_resources(0);
+  EXPECT_EQ(-1, oc_core_get_group_object_table_entry(0)->id);
+  EXPECT_TRUE(find(1).empty());
+}
+
+TEST_F(TestFp, BlobTruncated_N)
+{
+  set_entry(0, 1, "/p/1", { 1, 2, 3 });
+  oc_dump_group_object_table_entry(0);
+  oc_commit_fp_tables();
+
+  // a blob that is shorter than its header says
+  uint8_t buf[256];
+  long size = oc_storage_read(GOT_BLOB_STORE, buf, sizeof(buf));
+  ASSERT_GT(size, FP_BLOB_HEADER_SIZE);
+  ASSERT_EQ(size - 4, oc_storage_write(GOT_BLOB_STORE, buf, size - 4));
+
+  oc_free_knx_fp_resources(0);
+  oc_create_knx_fp_resources(0);
+  EXPECT_EQ(-1, oc_core_get_group_object_table_entry(0)->id);
+}
+
+TEST_F(TestFp, BlobWriteFailure_N)
+{
+  set_entry(0, 1, "/p/1", { 1, 2 });
+  oc_dump_group_object_table_entry(0);
+
+  // a directory that can not be created, the blob can not be written
+  oc_storage_config("./fp_test_missing/storage");
+  EXPECT_EQ(-1, oc_commit_fp_tables());
+
+  // the table is still changed, the next commit writes it
+  oc_storage_config(FP_TEST_STORAGE);
+  EXPECT_EQ(0, oc_commit_fp_tables());
+  EXPECT_EQ(0, oc_commit_fp_tables());
+
+  oc_free_knx_fp_resources(0);
+  oc_create_knx_fp_resources(0);
+  oc_group_object_table_t *entry = oc_core_get_group_object_table_entry(0);
+  EXPECT_EQ(1, entry->id);
+  ASSERT_EQ(2, entry->ga_len);
+  EXPECT_EQ(2u, entry->ga[1]);
+}
+
+TEST_F(TestFp, TableMemory_P)
+{
+  oc_fp_table_memory_t memory;
+  oc_core_get_fp_table_memory(&memory);
+  EXPECT_GT(memory.table_size, 0u);
+  EXPECT_EQ(0u, memory.heap_size);
+  EXPECT_EQ(0, memory.heap_blocks);
+
+  // the same href twice, as for a group object with two table entries
+  set_entry(0, 1, "/p/1", { 1, 2 });
+  set_entry(1, 2, "/p/1", { 3 });
+  set_entry(2, 3, "/p/2", { 4 });
+  oc_core_get_fp_table_memory(&memory);
+  RecordProperty("table_size", (int)memory.table_size);
+  RecordProperty("heap_size", (int)memory.heap_size);
+  RecordProperty("heap_blocks", memory.heap_blocks);
+#ifdef OC_FP_TABLE_POOL
+  // one pool for the group addresses, one arena for the interned strings
+  EXPECT_EQ(2, memory.heap_blocks);
+  EXPECT_GE(memory.heap_size, 4 * sizeof(uint32_t) + 2 * sizeof("/p/1"));
+#else  /* OC_FP_TABLE_POOL */
+  EXPECT_EQ(6, memory.heap_blocks);
+  EXPECT_EQ(4 * sizeof(uint32_t) + 3 * sizeof("/p/1"), memory.heap_size);
+#endif /* !OC_FP_TABLE_POOL */
+
+  for (int i = 0; i < 3; i++) {
+    oc_delete_group_object_table_entry(i);
+  }
+  oc_core_get_fp_table_memory(&memory);
+  EXPECT_EQ(0u, memory.heap_size);
+  EXPECT_EQ(0, memory.heap_blocks);
+}
+
+/* the payload of a POST to /fp/g, /fp/r or /fp/p: an array of maps */
+class FpPayload {
+public:
+  FpPayload()
+  {
+    cbor_encoder_init(&m_root, m_buf, sizeof(m_buf), 0);
+    cbor_encoder_create_array(&m_root, &m_array, CborIndefiniteLength);
+  }
+
+  FpPayload &begin()
+  {
+    cbor_encoder_create_map(&m_array, &m_map, CborIndefiniteLength);
+    return *this;
+  }
+
+  FpPayload &end()
+  {
+    cbor_encoder_close_container(&m_array, &m_map);
+    return *this;
+  }
+
+  FpPayload &key(int key)
+  {
+    cbor_encode_int(&m_map, key);
+    return *this;
+  }
+
+  FpPayload &key(const char *key)
+  {
+    cbor_encode_text_string(&m_map, key, strlen(key));
+    return *this;
+  }
+
+  FpPayload &integer(int64_t value)
+  {
+    cbor_encode_int(&m_map, value);
+    return *this;
+  }
+
+  FpPayload &text(const std::string &value)
+  {
+    cbor_encode_text_string(&m_map, value.c_str(), value.size());
+    return *this;
+  }
+
+  FpPayload &boolean(bool value)
+  {
+    cbor_encode_boolean(&m_map, value);
+    return *this;
+  }
+
+  FpPayload &null()
+  {
+    cbor_encode_null(&m_map);
+    return *this;
+  }
+
+  FpPayload &array(const std::vector<int64_t> &values)
+  {
+    CborEncoder array;
+    cbor_encoder_create_array(&m_map, &array, values.size());
+    for (int64_t value : values) {
+      cbor_encode_int(&array, value);
+    }
+    cbor_encoder_close_container(&m_map, &array);
+    return *this;
+  }
+
+  std::vector<uint8_t> bytes()
+  {
+    cbor_encoder_close_container(&m_root, &m_array);
+    EXPECT_EQ(0u, cbor_encoder_get_extra_bytes_needed(&m_root));
+    size_t size = cbor_encoder_get_buffer_size(&m_root, m_buf);
+    return std::vector<uint8_t>(m_buf, m_buf + size);
+  }
+
+private:
+  uint8_t m_buf[1024];
+  CborEncoder m_root;
+  CborEncoder m_array;
+  CborEncoder m_map;
+};
+
+/* POST requests to the tables of a device in the loading state. the
+ * expected table contents are the ones of the oc_rep_t based decoder */
+class TestFpPost : public TestFp {
+protected:
+  virtual void SetUp()
+  {
+    TestFp::SetUp();
+    oc_core_init();
+    oc_add_device("myhname", "1.0.0", "//", "000001", NULL, NULL);
+    oc_core_get_device_info(0)->lsm_s = LSM_S_LOADING;
+    for (const char *uri : { "/p/1", "/p/2" }) {
+      oc_resource_t *res = oc_new_resource(uri, uri, 1, 0);
+      oc_resource_set_discoverable(res, true);
+      oc_ri_add_resource(res);
+    }
+  }
+
+  virtual void TearDown()
+  {
+    oc_core_shutdown();
+    TestFp::TearDown();
+  }
+
+  /* the response code of the POST request */
+  static int post(const char *uri, const std::vector<uint8_t> &payload,
+                  oc_content_format_t format = APPLICATION_CBOR)
+  {
+    const oc_resource_t *resource =
+      oc_ri_get_core_resource_by_uri(uri, strlen(uri), 0);
+    if (resource == nullptr) {
+      ADD_FAILURE() << uri;
+      return -1;
+    }
+    oc_response_buffer_t response_buffer;
+    memset(&response_buffer, 0, sizeof(response_buffer));
+    oc_response_t response;
+    memset(&response, 0, sizeof(response));
+    response.response_buffer = &response_buffer;
+    oc_request_t request;
+    memset(&request, 0, sizeof(request));
+    request.resource = resource;
+    request._payload = payload.empty() ? NULL : payload.data();
+    request._payload_len = payload.size();
+    request.content_format = format;
+    request.accept = APPLICATION_CBOR;
+    request.response = &response;
+    resource->post_handler.cb(&request, OC_IF_C,
+                              resource->post_handler.user_data);
+    return response_buffer.code;
+  }
+
+  static int status(oc_status_t status) { return oc_status_code(status); }
+
+  static std::vector<uint32_t> ga(const uint32_t *ga, int ga_len)
+  {
+    return std::vector<uint32_t>(ga, ga + ga_len);
+  }
+
+  static int used_entries(int size,
+                          oc_group_rp_table_t *(*entry)(int index))
+  {
+    int used = 0;
+    for (int i = 0; i < size; i++) {
+      used += (entry(i)->id != -1);
+    }
+    return used;
+  }
+
+  static int used_got_entries()
+  {
+    int used = 0;
+    for (int i = 0; i < oc_core_get_group_object_table_total_size(); i++) {
+      used += (oc_core_get_group_object_table_entry(i)->id != -1);
+    }
+    return used;
+  }
+
+  static FpPayload got_payload()
+  {
+    FpPayload payload;
+    payload.begin()
+      .key(0)
+      .integer(1)
+      .key(11)
+      .text("/p/1")
+      .key(7)
+      .array({ 1, 2 })
+      .key(8)
+      .array({ 1, 2 })
+      .end();
+    payload.begin()
+      .key(0)
+      .integer(2)
+      .key(11)
+      .text("/p/2")
+      .key(7)
+      .array({ 3 })
+      .key(8)
+      .integer(OC_CFLAG_TRANSMISSION | OC_CFLAG_INIT)
+      .end();
+    return payload;
+  }
+
+  static FpPayload grt_payload()
+  {
+    FpPayload payload;
+    payload.begin()
+      .key(0)
+      .integer(1)
+      .key(12)
+      .integer(5)
+      .key(26)
+      .integer(7)
+      .key(25)
+      .integer(8)
+      .key(10)
+      .text("coap://[ff02::fd]")
+      .key(112)
+      .text(".knx")
+      .key(14)
+      .text("token")
+      .key(7)
+      .array({ 1, 2 })
+      .key("non")
+      .boolean(true)
+      .key("mt")
+      .integer(2)
+      .end();
+    payload.begin()
+      .key(0)
+      .integer(2)
+      .key(13)
+      .integer(0x1234)
+      .key(7)
+      .null()
+      .end();
+    return payload;
+  }
+};
+
+TEST_F(TestFpPost, GroupObjectTable_P)
+{
+  EXPECT_EQ(status(OC_STATUS_CREATED),
+            post("/fp/g", got_payload().bytes()));
+
+  int index = oc_core_find_index_in_group_object_table_from_id(1);
+  ASSERT_NE(-1, index);
+  oc_group_object_table_t *entry = oc_core_get_group_object_table_entry(index);
+  EXPECT_STREQ("/p/1", oc_string(entry->href));
+  EXPECT_EQ(OC_CFLAG_READ | OC_CFLAG_WRITE, entry->cflags);
+  EXPECT_EQ(std::vector<uint32_t>({ 1, 2 }), ga(entry->ga, entry->ga_len));
+
+  index = oc_core_find_index_in_group_object_table_from_id(2);
+  ASSERT_NE(-1, index);
+  entry = oc_core_get_group_object_table_entry(index);
+  EXPECT_STREQ("/p/2", oc_string(entry->href));
+  EXPECT_EQ(OC_CFLAG_TRANSMISSION | OC_CFLAG_INIT, entry->cflags);
+  EXPECT_EQ(std::vector<uint32_t>({ 3 }), ga(entry->ga, entry->ga_len));
+  EXPECT_EQ(2, used_got_entries());
+  EXPECT_EQ(std::vector<int>({ index }), find(3));
+
+  // an existing entry is changed, the other values are kept
+  FpPayload change;
+  change.begin().key(0).integer(1).key(7).array({ 5 }).end();
+  EXPECT_EQ(status(OC_STATUS_CHANGED), post("/fp/g", change.bytes()));
+  index = oc_core_find_index_in_group_object_table_from_id(1);
+  ASSERT_NE(-1, index);
+  entry = oc_core_get_group_object_table_entry(index);
+  EXPECT_STREQ("/p/1", oc_string(entry->href));
+  EXPECT_EQ(OC_CFLAG_READ | OC_CFLAG_WRITE, entry->cflags);
+  EXPECT_EQ(std::vector<uint32_t>({ 5 }), ga(entry->ga, entry->ga_len));
+  EXPECT_TRUE(find(1).empty());
+
+  // only the id deletes the entry
+  FpPayload remove;
+  remove.begin().key(0).integer(2).end();
+  EXPECT_EQ(status(OC_STATUS_CHANGED), post("/fp/g", remove.bytes()));
+  EXPECT_EQ(-1, oc_core_find_index_in_group_object_table_from_id(2));
+  EXPECT_EQ(1, used_got_entries());
+}
+
+TEST_F(TestFpPost, GroupObjectTableNotLoading_N)
+{
+  oc_core_get_device_info(0)->lsm_s = LSM_S_LOADED;
+  EXPECT_EQ(status(OC_STATUS_METHOD_NOT_ALLOWED),
+            post("/fp/g", got_payload().bytes()));
+  EXPECT_EQ(0, used_got_entries());
+}
+
+TEST_F(TestFpPost, GroupObjectTableMalformed_N)
+{
+  std::vector<uint8_t> payload = got_payload().bytes();
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST),
+            post("/fp/g", payload, APPLICATION_JSON));
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST), post("/fp/g", {}));
+
+  // not an array: a map, an integer and a break without a container
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST), post("/fp/g", { 0xa1, 0x00, 0x01 }));
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST), post("/fp/g", { 0x01 }));
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST), post("/fp/g", { 0xff }));
+  // garbage behind the array
+  payload.push_back(0x01);
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST), post("/fp/g", payload));
+
+  // an entry without id
+  FpPayload no_id;
+  no_id.begin().key(11).text("/p/1").key(7).array({ 1 }).end();
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST), post("/fp/g", no_id.bytes()));
+  EXPECT_EQ(0, used_got_entries());
+}
+
+TEST_F(TestFpPost, GroupObjectTablePartial_N)
+{
+  // the first part of a payload, e.g. only the first blocks of a block-wise
+  // transfer, is rejected as a whole
+  std::vector<uint8_t> payload = got_payload().bytes();
+  for (size_t len = 1; len < payload.size(); len++) {
+    std::vector<uint8_t> part(payload.begin(), payload.begin() + len);
+    EXPECT_EQ(status(OC_STATUS_BAD_REQUEST), post("/fp/g", part)) << len;
+    EXPECT_EQ(0, used_got_entries()) << len;
+  }
+  EXPECT_EQ(status(OC_STATUS_CREATED), post("/fp/g", payload));
+  EXPECT_EQ(2, used_got_entries());
+}
+
+TEST_F(TestFpPost, GroupObjectTableMandatory_N)
+{
+  // a new entry needs id, href, ga and cflags
+  FpPayload no_href;
+  no_href.begin().key(0).integer(1).key(7).array({ 1 }).key(8).integer(8).end();
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST), post("/fp/g", no_href.bytes()));
+  FpPayload no_ga;
+  no_ga.begin().key(0).integer(1).key(11).text("/p/1").key(8).integer(8).end();
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST), post("/fp/g", no_ga.bytes()));
+  FpPayload no_cflags;
+  no_cflags.begin().key(0).integer(1).key(11).text("/p/1").key(7).array({ 1 });
+  no_cflags.end();
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST), post("/fp/g", no_cflags.bytes()));
+  EXPECT_EQ(0, used_got_entries());
+
+  // the href must be a resource of the device
+  FpPayload unknown_href;
+  unknown_href.begin()
+    .key(0)
+    .integer(1)
+    .key(11)
+    .text("/p/3")
+    .key(7)
+    .array({ 1 })
+    .key(8)
+    .integer(8)
+    .end();
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST),
+            post("/fp/g", unknown_href.bytes()));
+  EXPECT_EQ(0, used_got_entries());
+  EXPECT_TRUE(find(1).empty());
+}
+
+TEST_F(TestFpPost, GroupObjectTableLong_P)
+{
+  // all group addresses of a long array are stored, in order
+  std::vector<int64_t> values;
+  std::vector<uint32_t> group_addresses;
+  for (uint32_t i = 0; i < 64; i++) {
+    values.push_back(1000 + i);
+    group_addresses.push_back(1000 + i);
+  }
+  FpPayload payload;
+  payload.begin()
+    .key(0)
+    .integer(1)
+    .key(11)
+    .text("/p/1")
+    .key(7)
+    .array(values)
+    .key(8)
+    .integer(8)
+    .end();
+  EXPECT_EQ(status(OC_STATUS_CREATED), post("/fp/g", payload.bytes()));
+  int index = oc_core_find_index_in_group_object_table_from_id(1);
+  ASSERT_NE(-1, index);
+  oc_group_object_table_t *entry = oc_core_get_group_object_table_entry(index);
+  EXPECT_EQ(group_addresses, ga(entry->ga, entry->ga_len));
+  EXPECT_EQ(std::vector<int>({ index }), find(1063));
+}
+
+TEST_F(TestFpPost, GroupObjectTableLongHref_N)
+{
+  // hrefs longer than OC_MAX_URL_LENGTH are rejected
+  std::string href = "/p/" + std::string(OC_MAX_URL_LENGTH, 'a');
+  FpPayload payload;
+  payload.begin()
+    .key(0)
+    .integer(1)
+    .key(11)
+    .text(href)
+    .key(7)
+    .array({ 1 })
+    .key(8)
+    .integer(8)
+    .end();
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST), post("/fp/g", payload.bytes()));
+  EXPECT_EQ(0, used_got_entries());
+}
+
+TEST_F(TestFpPost, RecipientTable_P)
+{
+  EXPECT_EQ(status(OC_STATUS_CREATED), post("/fp/r", grt_payload().bytes()));
+
+  int index = oc_core_find_index_in_recipient_table_from_id(1);
+  ASSERT_NE(-1, index);
+  oc_group_rp_table_t *entry = oc_core_get_recipient_table_entry(index);
+  EXPECT_EQ(5, entry->ia);
+  EXPECT_EQ(7, entry->iid);
+  EXPECT_EQ(8, entry->fid);
+  EXPECT_STREQ("coap://[ff02::fd]", oc_string(entry->url));
+  EXPECT_STREQ(".knx", oc_string(entry->path));
+  EXPECT_STREQ("token", oc_string(entry->at));
+  EXPECT_EQ(std::vector<uint32_t>({ 1, 2 }), ga(entry->ga, entry->ga_len));
+  EXPECT_TRUE(entry->non);
+  EXPECT_EQ(2, entry->mt);
+
+  // a null ga is accepted, non and mt have their default
+  index = oc_core_find_index_in_recipient_table_from_id(2);
+  ASSERT_NE(-1, index);
+  entry = oc_core_get_recipient_table_entry(index);
+  EXPECT_EQ(0x1234u, entry->grpid);
+  EXPECT_EQ(0, entry->ga_len);
+  EXPECT_FALSE(entry->non);
+  EXPECT_EQ(4, entry->mt);
+  EXPECT_EQ(2, used_entries(oc_core_get_recipient_table_size(),
+                            oc_core_get_recipient_table_entry));
+
+  // names are compared by their prefix, unknown keys are ignored
+  FpPayload change;
+  change.begin()
+    .key(0)
+    .integer(2)
+    .key("nonconfirmable")
+    .boolean(true)
+    .key(99)
+    .text("unknown")
+    .key("unknown")
+    .integer(1)
+    .end();
+  EXPECT_EQ(status(OC_STATUS_CHANGED), post("/fp/r", change.bytes()));
+  EXPECT_TRUE(entry->non);
+  EXPECT_EQ(0x1234u, entry->grpid);
+  EXPECT_EQ(4, entry->mt);
+
+  // only the id deletes the entry
+  FpPayload remove;
+  remove.begin().key(0).integer(1).end();
+  EXPECT_EQ(status(OC_STATUS_CHANGED), post("/fp/r", remove.bytes()));
+  EXPECT_EQ(-1, oc_core_find_index_in_recipient_table_from_id(1));
+  EXPECT_EQ(1, used_entries(oc_core_get_recipient_table_size(),
+                            oc_core_get_recipient_table_entry));
+}
+
+TEST_F(TestFpPost, RecipientTableMandatory_N)
+{
+  // a new entry needs id, ga and one of ia, grpid or url
+  FpPayload no_identifier;
+  no_identifier.begin().key(0).integer(1).key(7).array({ 1 }).end();
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST),
+            post("/fp/r", no_identifier.bytes()));
+  FpPayload no_ga;
+  no_ga.begin().key(0).integer(1).key(12).integer(5).end();
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST), post("/fp/r", no_ga.bytes()));
+  FpPayload no_id;
+  no_id.begin().key(12).integer(5).key(7).array({ 1 }).end();
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST), post("/fp/r", no_id.bytes()));
+  EXPECT_EQ(0, used_entries(oc_core_get_recipient_table_size(),
+                            oc_core_get_recipient_table_entry));
+  EXPECT_EQ(-1, oc_core_find_recipient_table_index(1));
+}
+
+TEST_F(TestFpPost, RecipientTableLong_P)
+{
+  // a long url is stored, the length is only reported
+  std::string url = "coap://" + std::string(100, 'a');
+  std::vector<int64_t> values;
+  for (int64_t i = 1; i <= 32; i++) {
+    values.push_back(i);
+  }
+  FpPayload payload;
+  payload.begin().key(0).integer(1).key(10).text(url).key(7).array(values);
+  payload.end();
+  EXPECT_EQ(status(OC_STATUS_CREATED), post("/fp/r", payload.bytes()));
+  int index = oc_core_find_index_in_recipient_table_from_id(1);
+  ASSERT_NE(-1, index);
+  oc_group_rp_table_t *entry = oc_core_get_recipient_table_entry(index);
+  EXPECT_EQ(url, oc_string(entry->url));
+  ASSERT_EQ(32, entry->ga_len);
+  EXPECT_EQ(32u, entry->ga[31]);
+  EXPECT_EQ(index, oc_core_find_recipient_table_index(32));
+}
+
+TEST_F(TestFpPost, RecipientTablePartial_N)
+{
+  std::vector<uint8_t> payload = grt_payload().bytes();
+  for (size_t len = 1; len < payload.size(); len++) {
+    std::vector<uint8_t> part(payload.begin(), payload.begin() + len);
+    EXPECT_EQ(status(OC_STATUS_BAD_REQUEST), post("/fp/r", part)) << len;
+    EXPECT_EQ(0, used_entries(oc_core_get_recipient_table_size(),
+                              oc_core_get_recipient_table_entry))
+      << len;
+  }
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST),
+            post("/fp/r", { 0x9f, 0xa1, 0x00 }));
+  EXPECT_EQ(status(OC_STATUS_CREATED), post("/fp/r", payload));
+}
+
+#ifdef OC_PUBLISHER_TABLE
+TEST_F(TestFpPost, PublisherTable_P)
+{
+  // the unicast options of the recipient table are not used
+  EXPECT_EQ(status(OC_STATUS_CREATED), post("/fp/p", grt_payload().bytes()));
+  int index = oc_core_find_index_in_publisher_table_from_id(1);
+  ASSERT_NE(-1, index);
+  oc_group_rp_table_t *entry = oc_core_get_publisher_table_entry(index);
+  EXPECT_EQ(5, entry->ia);
+  EXPECT_STREQ("coap://[ff02::fd]", oc_string(entry->url));
+  EXPECT_STREQ(".knx", oc_string(entry->path));
+  EXPECT_STREQ("token", oc_string(entry->at));
+  EXPECT_EQ(std::vector<uint32_t>({ 1, 2 }), ga(entry->ga, entry->ga_len));
+  EXPECT_FALSE(entry->non);
+  EXPECT_EQ(2, used_entries(oc_core_get_publisher_table_size(),
+                            oc_core_get_publisher_table_entry));
+  // the recipient table is not changed
+  EXPECT_EQ(0, used_entries(oc_core_get_recipient_table_size(),
+                            oc_core_get_recipient_table_entry));
+
+  FpPayload no_identifier;
+  no_identifier.begin().key(0).integer(3).key(7).array({ 1 }).end();
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST),
+            post("/fp/p", no_identifier.bytes()));
+  EXPECT_EQ(-1, oc_core_find_index_in_publisher_table_from_id(3));
+
+  std::vector<uint8_t> payload = grt_payload().bytes();
+  payload.resize(payload.size() - 1);
+  EXPECT_EQ(status(OC_STATUS_BAD_REQUEST), post("/fp/p", payload));
+}
+#endif /* OC_PUBLISHER_TABLE */
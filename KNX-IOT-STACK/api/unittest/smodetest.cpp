@@ -0,0 +1,298 @@
+/******************************************************************
+ *
+ * Copyright 2025 Cascoda Ltd All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "oc_api.h"
+#include "api/oc_knx_client.h"
+
+/* decodes the s-mode frame { 4:sia, 5:{ 6:st, 7:ga, 1:value } } */
+static oc_s_mode_frame_error_t
+decode(const std::vector<uint8_t> &payload, oc_s_mode_frame_t *frame)
+{
+  return oc_s_mode_decode_frame(payload.data(), payload.size(), frame);
+}
+
+TEST(TestSMode, DecodeFrameWrite_P)
+{
+  // { 4: 0x0a01, 5: { 6: "w", 7: 1, 1: true } }
+  std::vector<uint8_t> payload = { 0xa2, 0x04, 0x19, 0x0a, 0x01, 0x05, 0xa3,
+                                   0x06, 0x61, 0x77, 0x07, 0x01, 0x01, 0xf5 };
+  oc_s_mode_frame_t frame;
+  ASSERT_EQ(OC_S_MODE_FRAME_OK, decode(payload, &frame));
+  EXPECT_EQ(0x0a01u, frame.sia);
+  EXPECT_EQ(1u, frame.ga);
+  EXPECT_EQ(OC_S_MODE_ST_WRITE, frame.st);
+  // the value is the encoded data item inside the payload
+  EXPECT_EQ(payload.data() + 13, frame.value);
+  EXPECT_EQ(1u, frame.value_len);
+}
+
+TEST(TestSMode, DecodeFrameRead_P)
+{
+  // { 4: 1, 5: { 6: "r", 7: 100 } }, a read has no value
+  std::vector<uint8_t> payload = { 0xa2, 0x04, 0x01, 0x05, 0xa2, 0x06,
+                                   0x61, 0x72, 0x07, 0x18, 0x64 };
+  oc_s_mode_frame_t frame;
+  ASSERT_EQ(OC_S_MODE_FRAME_OK, decode(payload, &frame));
+  EXPECT_EQ(1u, frame.sia);
+  EXPECT_EQ(100u, frame.ga);
+  EXPECT_EQ(OC_S_MODE_ST_READ, frame.st);
+  EXPECT_EQ(nullptr, frame.value);
+  EXPECT_EQ(0u, frame.value_len);
+}
+
+TEST(TestSMode, DecodeFrameResponse_P)
+{
+  // { 5: { 1: [1, 2], 7: 0xffffffff, 6: "rp" } }, without sia
+  std::vector<uint8_t> payload = { 0xa1, 0x05, 0xa3, 0x01, 0x82, 0x01,
+                                   0x02, 0x07, 0x1a, 0xff, 0xff, 0xff,
+                                   0xff, 0x06, 0x62, 0x72, 0x70 };
+  oc_s_mode_frame_t frame;
+  ASSERT_EQ(OC_S_MODE_FRAME_OK, decode(payload, &frame));
+  EXPECT_EQ(0u, frame.sia);
+  EXPECT_EQ(0xffffffffu, frame.ga);
+  EXPECT_EQ(OC_S_MODE_ST_RESPONSE_RP, frame.st);
+  EXPECT_EQ(payload.data() + 4, frame.value);
+  EXPECT_EQ(3u, frame.value_len);
+}
+
+TEST(TestSMode, DecodeFrameUnknownKeys_P)
+{
+  // { 4: 1, 9: { 1: 2 }, 5: { 8: "foo", "k": 3, 6: "w", 7: 2, 1: false } }
+  std::vector<uint8_t> payload = { 0xa3, 0x04, 0x01, 0x09, 0xa1, 0x01, 0x02,
+                                   0x05, 0xa5, 0x08, 0x63, 0x66, 0x6f, 0x6f,
+                                   0x61, 0x6b, 0x03, 0x06, 0x61, 0x77, 0x07,
+                                   0x02, 0x01, 0xf4 };
+  oc_s_mode_frame_t frame;
+  ASSERT_EQ(OC_S_MODE_FRAME_OK, decode(payload, &frame));
+  EXPECT_EQ(1u, frame.sia);
+  EXPECT_EQ(2u, frame.ga);
+  EXPECT_EQ(OC_S_MODE_ST_WRITE, frame.st);
+  EXPECT_EQ(payload.data() + 23, frame.value);
+  EXPECT_EQ(1u, frame.value_len);
+}
+
+TEST(TestSMode, DecodeFrameLargeValue_P)
+{
+  // { 5: { 6: "w", 7: 1, 1: h'00...' } } with a value of 1000 bytes, the
+  // value is not copied
+  std::vector<uint8_t> payload = { 0xa1, 0x05, 0xa3, 0x06, 0x61, 0x77,
+                                   0x07, 0x01, 0x01, 0x59, 0x03, 0xe8 };
+  payload.resize(payload.size() + 1000, 0x55);
+  oc_s_mode_frame_t frame;
+  ASSERT_EQ(OC_S_MODE_FRAME_OK, decode(payload, &frame));
+  EXPECT_EQ(payload.data() + 9, frame.value);
+  EXPECT_EQ(1003u, frame.value_len);
+}
+
+TEST(TestSMode, DecodeFrameOversizedValue_N)
+{
+  // the value says it has 1000 bytes, the payload ends before
+  std::vector<uint8_t> payload = { 0xa1, 0x05, 0xa3, 0x06, 0x61, 0x77,
+                                   0x07, 0x01, 0x01, 0x59, 0x03, 0xe8 };
+  payload.resize(payload.size() + 10, 0x55);
+  oc_s_mode_frame_t frame;
+  EXPECT_EQ(OC_S_MODE_FRAME_CBOR_ERROR, decode(payload, &frame));
+}
+
+TEST(TestSMode, DecodeFrameTruncated_N)
+{
+  std::vector<uint8_t> payload = { 0xa2, 0x04, 0x19, 0x0a, 0x01, 0x05, 0xa3,
+                                   0x06, 0x61, 0x77, 0x07, 0x01, 0x01, 0xf5 };
+  oc_s_mode_frame_t frame;
+  for (size_t len = 0; len < payload.size(); len++) {
+    std::vector<uint8_t> part(payload.begin(), payload.begin() + len);
+    EXPECT_NE(OC_S_MODE_FRAME_OK, decode(part, &frame)) << len;
+  }
+  EXPECT_EQ(OC_S_MODE_FRAME_CBOR_ERROR,
+            oc_s_mode_decode_frame(NULL, 0, &frame));
+}
+
+TEST(TestSMode, DecodeFrameWrongType_N)
+{
+  oc_s_mode_frame_t frame;
+  // st is an integer
+  EXPECT_EQ(OC_S_MODE_FRAME_INVALID_TYPE,
+            decode({ 0xa1, 0x05, 0xa3, 0x06, 0x01, 0x07, 0x01, 0x01, 0xf5 },
+                   &frame));
+  // ga is a text string
+  EXPECT_EQ(OC_S_MODE_FRAME_INVALID_TYPE,
+            decode({ 0xa1, 0x05, 0xa3, 0x06, 0x61, 0x77, 0x07, 0x61, 0x31,
+                     0x01, 0xf5 },
+                   &frame));
+  // ga is negative
+  EXPECT_EQ(OC_S_MODE_FRAME_INVALID_TYPE,
+            decode({ 0xa1, 0x05, 0xa3, 0x06, 0x61, 0x77, 0x07, 0x20, 0x01,
+                     0xf5 },
+                   &frame));
+  // ga does not fit 32 bits
+  EXPECT_EQ(OC_S_MODE_FRAME_INVALID_TYPE,
+            decode({ 0xa1, 0x05, 0xa3, 0x06, 0x61, 0x77, 0x07, 0x1b, 0x00,
+                     0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 0xf5 },
+                   &frame));
+  // sia is a text string
+  EXPECT_EQ(OC_S_MODE_FRAME_INVALID_TYPE,
+            decode({ 0xa2, 0x04, 0x61, 0x31, 0x05, 0xa3, 0x06, 0x61, 0x77,
+                     0x07, 0x01, 0x01, 0xf5 },
+                   &frame));
+  // s (5) is not a map, the frame is not a map
+  EXPECT_EQ(OC_S_MODE_FRAME_NOT_A_MAP,
+            decode({ 0xa1, 0x05, 0x82, 0x06, 0x07 }, &frame));
+  EXPECT_EQ(OC_S_MODE_FRAME_NOT_A_MAP, decode({ 0xa1, 0x05, 0x01 }, &frame));
+  EXPECT_EQ(OC_S_MODE_FRAME_NOT_A_MAP, decode({ 0x82, 0x01, 0x02 }, &frame));
+  // unknown service types
+  EXPECT_EQ(OC_S_MODE_FRAME_INVALID_ST,
+            decode({ 0xa1, 0x05, 0xa3, 0x06, 0x61, 0x78, 0x07, 0x01, 0x01,
+                     0xf5 },
+                   &frame));
+  EXPECT_EQ(OC_S_MODE_FRAME_INVALID_ST,
+            decode({ 0xa1, 0x05, 0xa3, 0x06, 0x65, 0x77, 0x72, 0x69, 0x74,
+                     0x65, 0x07, 0x01, 0x01, 0xf5 },
+                   &frame));
+}
+
+TEST(TestSMode, DecodeFrameMissing_N)
+{
+  oc_s_mode_frame_t frame;
+  EXPECT_EQ(OC_S_MODE_FRAME_MISSING_ST, decode({ 0xa0 }, &frame));
+  EXPECT_EQ(OC_S_MODE_FRAME_MISSING_ST,
+            decode({ 0xa1, 0x05, 0xa2, 0x07, 0x01, 0x01, 0xf5 }, &frame));
+  EXPECT_EQ(OC_S_MODE_FRAME_MISSING_GA,
+            decode({ 0xa1, 0x05, 0xa2, 0x06, 0x61, 0x77, 0x01, 0xf5 },
+                   &frame));
+  // a write needs a value
+  EXPECT_EQ(OC_S_MODE_FRAME_MISSING_VALUE,
+            decode({ 0xa1, 0x05, 0xa2, 0x06, 0x61, 0x77, 0x07, 0x01 },
+                   &frame));
+}
+
+/* the frame { 5: { 6: "w", 7: 1, 1: value } }, the value starts at offset 9 */
+static std::vector<uint8_t>
+write_frame(const std::vector<uint8_t> &value)
+{
+  std::vector<uint8_t> payload = { 0xa1, 0x05, 0xa3, 0x06, 0x61,
+                                   0x77, 0x07, 0x01, 0x01 };
+  payload.insert(payload.end(), value.begin(), value.end());
+  return payload;
+}
+
+/* the value of the frame, decoded into storage */
+static oc_rep_t *
+frame_value(const std::vector<uint8_t> &payload, oc_rep_t *storage)
+{
+  oc_s_mode_frame_t frame;
+  EXPECT_EQ(OC_S_MODE_FRAME_OK, decode(payload, &frame));
+  oc_rep_t *value = oc_s_mode_frame_get_value(&frame, storage);
+  if (value) {
+    EXPECT_EQ(1, value->iname);
+  }
+  return value;
+}
+
+TEST(TestSMode, FrameValueScalar_P)
+{
+  // without a rep pool, scalar values are decoded without allocations
+  struct oc_memb *pool = oc_rep_get_pool();
+  oc_rep_set_pool(NULL);
+  oc_rep_t storage;
+
+  std::vector<uint8_t> payload = write_frame({ 0x18, 0x2a });
+  oc_rep_t *value = frame_value(payload, &storage);
+  ASSERT_EQ(&storage, value);
+  EXPECT_EQ(OC_REP_INT, value->type);
+  EXPECT_EQ(42, value->value.integer);
+
+  payload = write_frame({ 0x39, 0x01, 0x00 });
+  ASSERT_EQ(&storage, frame_value(payload, &storage));
+  EXPECT_EQ(OC_REP_INT, storage.type);
+  EXPECT_EQ(-257, storage.value.integer);
+
+  payload = write_frame({ 0xf5 });
+  ASSERT_EQ(&storage, frame_value(payload, &storage));
+  EXPECT_EQ(OC_REP_BOOL, storage.type);
+  EXPECT_TRUE(storage.value.boolean);
+
+  payload = write_frame({ 0xfa, 0x40, 0x49, 0x0f, 0xdb });
+  ASSERT_EQ(&storage, frame_value(payload, &storage));
+  EXPECT_EQ(OC_REP_FLOAT, storage.type);
+  EXPECT_FLOAT_EQ(3.14159f, storage.value.float_p);
+
+  // the tag is skipped
+  payload = write_frame({ 0xc1, 0x1a, 0x00, 0x00, 0x00, 0x01 });
+  ASSERT_EQ(&storage, frame_value(payload, &storage));
+  EXPECT_EQ(OC_REP_INT, storage.type);
+  EXPECT_EQ(1, storage.value.integer);
+
+  // strings refer to the frame
+  payload = write_frame({ 0x63, 'a', 'b', 'c' });
+  ASSERT_EQ(&storage, frame_value(payload, &storage));
+  EXPECT_EQ(OC_REP_STRING, storage.type);
+  EXPECT_EQ((char *)payload.data() + 10, oc_string(storage.value.string));
+  EXPECT_EQ(3u, oc_string_len(storage.value.string));
+  EXPECT_EQ(0, memcmp("abc", oc_string(storage.value.string), 3));
+
+  payload = write_frame({ 0x42, 0x01, 0x02 });
+  ASSERT_EQ(&storage, frame_value(payload, &storage));
+  EXPECT_EQ(OC_REP_BYTE_STRING, storage.type);
+  EXPECT_EQ((char *)payload.data() + 10, oc_string(storage.value.string));
+  EXPECT_EQ(2u, oc_string_len(storage.value.string));
+
+  oc_s_mode_free_value(&storage, &storage);
+  oc_rep_set_pool(pool);
+}
+
+TEST(TestSMode, FrameValueArray_P)
+{
+  // arrays need reps of the pool
+  struct oc_memb *pool = oc_rep_get_pool();
+  struct oc_memb rep_objects = { sizeof(oc_rep_t), 0, 0, 0, 0 };
+  oc_rep_set_pool(&rep_objects);
+  oc_rep_t storage;
+
+  std::vector<uint8_t> payload = write_frame({ 0x82, 0x01, 0x02 });
+  oc_rep_t *value = frame_value(payload, &storage);
+  ASSERT_NE(nullptr, value);
+  EXPECT_NE(&storage, value);
+  EXPECT_EQ(OC_REP_INT_ARRAY, value->type);
+  ASSERT_EQ(2u, oc_int_array_size(value->value.array));
+  EXPECT_EQ(2, oc_int_array(value->value.array)[1]);
+  oc_s_mode_free_value(value, &storage);
+  oc_rep_set_pool(pool);
+}
+
+TEST(TestSMode, FrameValueInvalid_N)
+{
+  oc_rep_t storage;
+  oc_s_mode_frame_t frame;
+  memset(&frame, 0, sizeof(frame));
+  EXPECT_EQ(nullptr, oc_s_mode_frame_get_value(&frame, &storage));
+
+  // a truncated integer and string
+  const uint8_t integer[] = { 0x19, 0x01 };
+  frame.value = integer;
+  frame.value_len = sizeof(integer);
+  EXPECT_EQ(nullptr, oc_s_mode_frame_get_value(&frame, &storage));
+  const uint8_t text[] = { 0x63, 'a', 'b' };
+  frame.value = text;
+  frame.value_len = sizeof(text);
+  EXPECT_EQ(nullptr, oc_s_mode_frame_get_value(&frame, &storage));
+}
@@ -217,6 +217,24 @@ oc_client_cb_t *oc_ri_find_client_cb_by_token(uint8_t *token,
  */
 oc_client_cb_t *oc_ri_find_client_cb_by_mid(uint16_t mid);
 
+/**
+ * @brief change the CoAP message identifier of a client callback
+ *
+ * @param cb the client callback
+ * @param mid the CoAP message identifier
+ */
+void oc_ri_set_client_cb_mid(oc_client_cb_t *cb, uint16_t mid);
+
+/**
+ * @brief change the CoAP token of a client callback
+ *
+ * @param cb the client callback
+ * @param token the CoAP token
+ * @param token_len the token length
+ */
+void oc_ri_set_client_cb_token(oc_client_cb_t *cb, const uint8_t *token,
+                               uint8_t token_len);
+
 /**
  * @brief free the client callback information by endpoint
  *
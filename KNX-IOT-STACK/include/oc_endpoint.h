@@ -69,6 +69,20 @@ enum transport_flags {
   OSCORE_ENCRYPTED = 1 << 9, /**< OSCORE encrypted message */
 };
 
+/**
+ * @brief message priority, modelled after the KNX priority classes
+ *
+ * The priority is carried in the endpoint of a message and mapped by the
+ * port on the priority of the transport, e.g. the OpenThread message
+ * priority or the DSCP value of the IP header.
+ */
+typedef enum {
+  OC_MESSAGE_PRIORITY_NORMAL = 0, /**< normal priority (default) */
+  OC_MESSAGE_PRIORITY_LOW,        /**< low priority, e.g. bulk traffic */
+  OC_MESSAGE_PRIORITY_HIGH,       /**< urgent priority, e.g. alarms */
+  OC_MESSAGE_PRIORITY_SYSTEM,     /**< system priority */
+} oc_message_priority_t;
+
 #define SERIAL_NUM_SIZE (12) /**< binary: 6 bytes: in hex: 12 bytes*/
 /**
  * @brief the endpoint information
@@ -89,7 +103,7 @@ typedef struct oc_endpoint_t
     oc_ipv4_addr_t ipv4; /**< ipv4 address */
   } addr, addr_local;
   int interface_index;    /**< interface index */
-  uint8_t priority;       /**< priority */
+  uint8_t priority;       /**< priority, see oc_message_priority_t */
   uint32_t group_address; /**< group address,
                        being used to find back the OSCORE
                   credential to be used for encryption for s-mode messages
@@ -251,6 +265,48 @@ void oc_endpoint_list_copy(oc_endpoint_t **dst, oc_endpoint_t *src);
  */
 void oc_endpoint_print(oc_endpoint_t *ep);
 
+/**
+ * @brief clears the set of local endpoints (addresses + ports of the device)
+ *
+ * The set is maintained by the connectivity layer, e.g. it is rebuilt when
+ * the addresses of the network interface change. The functions that change
+ * the set must be called with the network event handler mutex held, see
+ * oc_network_event_handler_mutex_lock().
+ */
+void oc_endpoint_local_clear(void);
+
+/**
+ * @brief adds the address and port of the endpoint to the set of local
+ * endpoints
+ *
+ * @param ep the local endpoint
+ * @return true added (or already in the set)
+ * @return false set is full or the endpoint has no ip address
+ */
+bool oc_endpoint_local_add(const oc_endpoint_t *ep);
+
+/**
+ * @brief replaces the set of local endpoints with the endpoints of the list
+ *
+ * To be called with the network event handler mutex held.
+ *
+ * @param list the list of local endpoints (linked by next)
+ */
+void oc_endpoint_local_set_list(const oc_endpoint_t *list);
+
+/**
+ * @brief checks if the address and port of the endpoint belong to this device
+ * e.g. the message has been sent by this device.
+ *
+ * Takes the network event handler mutex, so it must not be called with the
+ * mutex held.
+ *
+ * @param ep the (remote) endpoint of the received message
+ * @return true the endpoint is one of the local endpoints
+ * @return false otherwise
+ */
+bool oc_endpoint_is_local(const oc_endpoint_t *ep);
+
 #ifdef __cplusplus
 }
 #endif
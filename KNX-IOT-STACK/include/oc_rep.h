@@ -1660,10 +1660,23 @@ typedef struct oc_rep_s
 // internal function
 void oc_rep_set_pool(struct oc_memb *rep_objects_pool);
 
+// internal function
+struct oc_memb *oc_rep_get_pool(void);
+
 // internal function
 int oc_parse_rep(const uint8_t *payload, int payload_size,
                  oc_rep_t **value_list);
 
+// internal function, parses one data item (without unwrapping maps/arrays)
+int oc_parse_rep_single_value(const uint8_t *payload, int payload_size,
+                              oc_rep_t **value);
+
+// internal function, parses one scalar data item into the caller owned rep,
+// without allocations. text and byte strings point into the payload and are
+// not terminated. maps and arrays return CborErrorUnsupportedType.
+int oc_parse_rep_scalar_value(const uint8_t *payload, int payload_size,
+                              oc_rep_t *value);
+
 // internal function
 void oc_free_rep(oc_rep_t *rep);
 
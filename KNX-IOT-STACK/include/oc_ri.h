@@ -139,7 +139,9 @@ typedef enum {
   OC_OBSERVABLE = (1 << 1),   /**< observable */
   OC_SECURE = (1 << 4),       /**< secure */
   OC_PERIODIC = (1 << 6),     /**< periodical update */
-  OC_SECURE_MCAST = (1 << 8)  /**< secure multi cast (OSCORE) */
+  OC_SECURE_MCAST = (1 << 8), /**< secure multi cast (OSCORE) */
+  OC_RAW_PAYLOAD = (1 << 9)   /**< payload is not parsed to oc_rep_t, the
+                                 handler decodes request->_payload */
 } oc_resource_properties_t;
 
 /**
@@ -404,6 +406,46 @@ typedef enum {
 
 typedef struct oc_resource_s oc_resource_t;
 
+#ifndef OC_MAX_QUERY_PARAMS
+/**
+ * @brief the number of query parameters that are kept in the parsed query of
+ * a request, queries with more parameters are scanned as string
+ */
+#define OC_MAX_QUERY_PARAMS (8)
+#endif
+
+/**
+ * @brief value length of a query parameter without "="
+ */
+#define OC_QUERY_NO_VALUE (0xFFFF)
+
+/**
+ * @brief query parameter, as offsets in the query string
+ *
+ */
+typedef struct oc_query_param_t
+{
+  uint16_t key;       /**< offset of the key */
+  uint16_t key_len;   /**< key length */
+  uint16_t value;     /**< offset of the value */
+  uint16_t value_len; /**< value length or OC_QUERY_NO_VALUE */
+} oc_query_param_t;
+
+/**
+ * @brief the query of a request, split once into key/value pairs
+ *
+ * The index belongs to the query (and query_len) it was parsed from, when the
+ * query of the request is changed the query is parsed again.
+ */
+typedef struct oc_query_index_t
+{
+  const char *query;                            /**< parsed query */
+  size_t query_len;                             /**< parsed query length */
+  oc_query_param_t params[OC_MAX_QUERY_PARAMS]; /**< the parameters */
+  uint8_t count;                                /**< number of parameters */
+  bool overflow; /**< query did not fit, scan the query string */
+} oc_query_index_t;
+
 /**
  * @brief request information structure
  *
@@ -423,7 +465,8 @@ typedef struct oc_request_t
     content_format; /**< content format (of the payload in the request) */
   oc_content_format_t
     accept; /**< accept header, e.g the format to be returned on the request */
-  oc_response_t *response; /**< pointer to the response */
+  oc_response_t *response;      /**< pointer to the response */
+  oc_query_index_t query_index; /**< the parsed query */
 } oc_request_t;
 
 /**
@@ -472,6 +515,10 @@ typedef struct oc_properties_cb_t
 typedef struct oc_resource_data_t
 {
   uint8_t num_observers; /**< amount of observers */
+  uint16_t got_first;    /**< first position of the resource in the group
+                            object table href index */
+  uint16_t got_count;    /**< amount of group object table entries that
+                            refer to the resource */
 } oc_resource_data_t;
 
 /**
@@ -610,6 +657,43 @@ const oc_resource_t *oc_ri_get_app_resource_by_uri(const char *uri,
                                                    size_t uri_len,
                                                    size_t device);
 
+/**
+ * @brief retrieve the core resource by uri and device index
+ *
+ * Core resources with a wildcard uri (an uri ending with '*', e.g. the group
+ * object table entries under "/fp/g/") match all uris that start with the uri
+ * in front of the '*' and have at least 1 more character.
+ *
+ * @param uri the uri of the resource, with or without leading '/'
+ * @param uri_len the length of the uri
+ * @param device the device index
+ * @return oc_resource_t* the resource structure, NULL if not found
+ */
+const oc_resource_t *oc_ri_get_core_resource_by_uri(const char *uri,
+                                                    size_t uri_len,
+                                                    size_t device);
+
+/**
+ * @brief retrieve the core or application resource by uri and device index
+ *
+ * The core resources are matched first.
+ *
+ * @param uri the uri of the resource, with or without leading '/'
+ * @param uri_len the length of the uri
+ * @param device the device index
+ * @return oc_resource_t* the resource structure, NULL if not found
+ */
+const oc_resource_t *oc_ri_get_resource_by_uri(const char *uri, size_t uri_len,
+                                               size_t device);
+
+/**
+ * @brief invalidates the uri index of the resources
+ *
+ * The index is rebuilt on the next lookup. To be called when the uri of a
+ * resource changes or when resources are added without oc_ri_add_resource.
+ */
+void oc_ri_invalidate_uri_index(void);
+
 /**
  * @brief retrieve list of resources
  *
@@ -722,6 +806,57 @@ int oc_ri_get_query_value(const char *query, size_t query_len, const char *key,
  */
 int oc_ri_query_exists(const char *query, size_t query_len, const char *key);
 
+/**
+ * @brief split the query into the key/value pairs of the index
+ *
+ * @param index the index to fill in
+ * @param query the query
+ * @param query_len the query length
+ */
+void oc_ri_parse_query(oc_query_index_t *index, const char *query,
+                       size_t query_len);
+
+/**
+ * @brief retrieve the query value at the nth position of the request query
+ *
+ * same as oc_ri_get_query_nth_key_value, using the parsed query of the request
+ *
+ * @param request the request
+ * @param key the key
+ * @param key_len the length of the key
+ * @param value the value belonging to the key
+ * @param value_len the length of the value
+ * @param n the position to query (starting at 1)
+ * @return int the position of the next key value pair in the query or -1
+ */
+int oc_ri_get_request_query_nth_key_value(oc_request_t *request, char **key,
+                                          size_t *key_len, char **value,
+                                          size_t *value_len, size_t n);
+
+/**
+ * @brief retrieve the value of the query parameter "key" of the request
+ *
+ * same as oc_ri_get_query_value, using the parsed query of the request
+ *
+ * @param request the request
+ * @param key the wanted key
+ * @param value the returned value
+ * @return int the length of the value or -1
+ */
+int oc_ri_get_request_query_value(oc_request_t *request, const char *key,
+                                  char **value);
+
+/**
+ * @brief checks if key exist in the query of the request
+ *
+ * same as oc_ri_query_exists, using the parsed query of the request
+ *
+ * @param request the request
+ * @param key the key to be checked if exist, key is null terminated
+ * @return int -1 = not exist
+ */
+int oc_ri_request_query_exists(oc_request_t *request, const char *key);
+
 /**
  * @brief check if the nth key exists
  *
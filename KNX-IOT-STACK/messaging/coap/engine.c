@@ -344,10 +344,9 @@ coap_receive(oc_message_t *msg)
 
           // a little bit naughty - modify the old client callback to refer to
           // the new (retransmitted) packet
-          client_cb->mid = retransmitted_pkt->mid;
-          client_cb->token_len = retransmitted_pkt->token_len;
-          memcpy(client_cb->token, retransmitted_pkt->token,
-                 client_cb->token_len);
+          oc_ri_set_client_cb_mid(client_cb, retransmitted_pkt->mid);
+          oc_ri_set_client_cb_token(client_cb, retransmitted_pkt->token,
+                                    retransmitted_pkt->token_len);
 
           new_transaction->message = oc_internal_allocate_outgoing_message();
           new_transaction->message->endpoint = transaction->message->endpoint;
@@ -406,10 +405,9 @@ coap_receive(oc_message_t *msg)
 
             // a little bit naughty - modify the old client callback to refer to
             // the new (retransmitted) packet
-            client_cb->mid = retransmitted_pkt->mid;
-            client_cb->token_len = retransmitted_pkt->token_len;
-            memcpy(client_cb->token, retransmitted_pkt->token,
-                   client_cb->token_len);
+            oc_ri_set_client_cb_mid(client_cb, retransmitted_pkt->mid);
+            oc_ri_set_client_cb_token(client_cb, retransmitted_pkt->token,
+                                      retransmitted_pkt->token_len);
 
             // add reference to original message so that it is not freed while
             // we still need it
@@ -499,28 +497,11 @@ coap_receive(oc_message_t *msg)
         }
       }
 
-      bool is_myself = false;
       // check if incoming message is from myself.
       // if so, then return with bad request
-      oc_endpoint_t *my_ep = oc_connectivity_get_endpoints(0);
-      oc_endpoint_t *ep_i = NULL;
-#ifdef OC_DEBUG
-      if (my_ep != NULL) {
-        PRINT("engine : myself:");
-        PRINTipaddr(*my_ep);
-        PRINT("\n");
-      }
-#endif /* OC_DEBUG */
-      for (ep_i = my_ep; ep_i != NULL; ep_i = ep_i->next) {
-        PRINTipaddr(*ep_i);
-        PRINT("\n");
-
-        if (oc_endpoint_compare_address(&msg->endpoint, ep_i) == 0) {
-          if (msg->endpoint.addr.ipv6.port == ep_i->addr.ipv6.port) {
-            OC_DBG(" same address and port: not handling message");
-            is_myself = true;
-          }
-        }
+      bool is_myself = oc_endpoint_is_local(&msg->endpoint);
+      if (is_myself) {
+        OC_DBG(" same address and port: not handling message");
       }
 
 #if defined(OC_REPLAY_PROTECTION) && defined(OC_OSCORE)
@@ -674,7 +655,7 @@ coap_receive(oc_message_t *msg)
                 }
                 coap_udp_init_message(response, COAP_TYPE_CON, CONTENT_2_05,
                                       coap_get_mid());
-                transaction->mid = response->mid;
+                coap_set_transaction_mid(transaction, response->mid);
                 coap_set_header_block1(response, block1_num, block1_more,
                                        block1_size);
                 // TODO
@@ -723,7 +704,7 @@ coap_receive(oc_message_t *msg)
                 }
                 coap_udp_init_message(response, COAP_TYPE_CON, CONTENT_2_05,
                                       coap_get_mid());
-                transaction->mid = response->mid;
+                coap_set_transaction_mid(transaction, response->mid);
                 // TODO
                 // coap_set_header_accept(response, APPLICATION_CBOR);
               }
@@ -1065,7 +1046,7 @@ coap_receive(oc_message_t *msg)
               coap_udp_init_message(response, COAP_TYPE_CON, client_cb->method,
                                     response_mid);
               response_buffer->mid = response_mid;
-              client_cb->mid = response_mid;
+              oc_ri_set_client_cb_mid(client_cb, response_mid);
               // TODO: This is still wrong - this code is likely to break down
               // when responding to long requests with type
               // application/link-format - the responses are gonna become
@@ -1186,8 +1167,8 @@ send_message:
 #endif /* OC_CLIENT && OC_BLOCK_WISE */
     }
     if (response->token_len > 0) {
-      memcpy(transaction->token, response->token, response->token_len);
-      transaction->token_len = response->token_len;
+      coap_set_transaction_token(transaction, response->token,
+                                 response->token_len);
     }
     transaction->message->length =
       coap_serialize_message(response, transaction->message->data);
@@ -51,6 +51,7 @@
 #include "oc_buffer.h"
 #include "util/oc_list.h"
 #include "util/oc_memb.h"
+#include "util/oc_token_index.h"
 #include <string.h>
 
 #ifdef OC_BLOCK_WISE
@@ -69,6 +70,8 @@
 /*---------------------------------------------------------------------------*/
 OC_MEMB(transactions_memb, coap_transaction_t, COAP_MAX_OPEN_TRANSACTIONS);
 OC_LIST(transactions_list);
+OC_TOKEN_INDEX(transactions_index, coap_transaction_t,
+               COAP_MAX_OPEN_TRANSACTIONS);
 
 static struct oc_process *transaction_handler_process = NULL;
 
@@ -103,6 +106,7 @@ coap_new_transaction(uint16_t mid, uint8_t *token, uint8_t token_len,
       oc_list_add(
         transactions_list,
         t); /* list itself makes sure same element is not added twice */
+      oc_token_index_add(&transactions_index, t);
     } else {
       oc_memb_free(&transactions_memb, t);
       t = NULL;
@@ -218,37 +222,49 @@ coap_clear_transaction(coap_transaction_t *t)
     oc_etimer_stop(&t->retrans_timer);
     oc_message_unref(t->message);
     oc_list_remove(transactions_list, t);
+    oc_token_index_remove(&transactions_index, t);
     oc_memb_free(&transactions_memb, t);
   }
 }
+
+void
+coap_set_transaction_mid(coap_transaction_t *t, uint16_t mid)
+{
+  oc_token_index_remove(&transactions_index, t);
+  t->mid = mid;
+  oc_token_index_add(&transactions_index, t);
+}
+
+void
+coap_set_transaction_token(coap_transaction_t *t, const uint8_t *token,
+                           uint8_t token_len)
+{
+  oc_token_index_remove(&transactions_index, t);
+  memcpy(t->token, token, token_len);
+  t->token_len = token_len;
+  oc_token_index_add(&transactions_index, t);
+}
+
 coap_transaction_t *
 coap_get_transaction_by_mid(uint16_t mid)
 {
-  coap_transaction_t *t = NULL;
-
-  for (t = (coap_transaction_t *)oc_list_head(transactions_list); t;
-       t = t->next) {
-    if (t->mid == mid) {
-      OC_DBG("Found transaction for MID %u: %p", t->mid, (void *)t);
-      return t;
-    }
+  coap_transaction_t *t = (coap_transaction_t *)oc_token_index_find_by_mid(
+    &transactions_index, transactions_list, mid);
+  if (t) {
+    OC_DBG("Found transaction for MID %u: %p", t->mid, (void *)t);
   }
-  return NULL;
+  return t;
 }
 
 coap_transaction_t *
 coap_get_transaction_by_token(uint8_t *token, uint8_t token_len)
 {
-  coap_transaction_t *t = NULL;
-
-  for (t = (coap_transaction_t *)oc_list_head(transactions_list); t;
-       t = t->next) {
-    if (t->token_len == token_len && memcmp(t->token, token, token_len) == 0) {
-      OC_DBG("Found transaction by token %p", (void *)t);
-      return t;
-    }
+  coap_transaction_t *t = (coap_transaction_t *)oc_token_index_find_by_token(
+    &transactions_index, transactions_list, token, token_len);
+  if (t) {
+    OC_DBG("Found transaction by token %p", (void *)t);
   }
-  return NULL;
+  return t;
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -282,6 +298,7 @@ coap_free_all_transactions(void)
     coap_clear_transaction(t);
     t = next;
   }
+  oc_token_index_clear(&transactions_index);
 }
 
 void
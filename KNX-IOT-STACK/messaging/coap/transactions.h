@@ -90,6 +90,10 @@ coap_transaction_t *coap_new_transaction(uint16_t mid, uint8_t *token,
 
 void coap_send_transaction(coap_transaction_t *t);
 void coap_clear_transaction(coap_transaction_t *t);
+/* the transaction is indexed by mid and token, change them only with these */
+void coap_set_transaction_mid(coap_transaction_t *t, uint16_t mid);
+void coap_set_transaction_token(coap_transaction_t *t, const uint8_t *token,
+                                uint8_t token_len);
 coap_transaction_t *coap_get_transaction_by_mid(uint16_t mid);
 coap_transaction_t *coap_get_transaction_by_token(uint8_t *token,
                                                   uint8_t token_len);
@@ -542,6 +542,11 @@ refresh_endpoints_list(ip_context_t *dev)
 #endif /* OC_SECURITY */
 #endif /* OC_IPV4 */
 #endif /* OC_TCP */
+
+  if (dev->device == 0) {
+    // used to filter the messages sent by this device
+    oc_endpoint_local_set_list(oc_list_head(dev->eps));
+  }
 }
 
 oc_endpoint_t *
@@ -936,10 +941,27 @@ network_event_thread(void *data)
   return NULL;
 }
 
+/* DSCP of the message priority, as traffic class / type of service byte */
+static int
+get_traffic_class(uint8_t priority)
+{
+  switch (priority) {
+  case OC_MESSAGE_PRIORITY_LOW:
+    return 0x08 << 2; // CS1
+  case OC_MESSAGE_PRIORITY_HIGH:
+    return 0x2e << 2; // EF
+  case OC_MESSAGE_PRIORITY_SYSTEM:
+    return 0x30 << 2; // CS6
+  default:
+    return 0; // best effort
+  }
+}
+
 static int
 send_msg(int sock, struct sockaddr_storage *receiver, oc_message_t *message)
 {
   char msg_control[CMSG_LEN(sizeof(struct sockaddr_storage))];
+  int traffic_class = get_traffic_class(message->endpoint.priority);
   struct iovec iovec[1];
   struct msghdr msg;
 
@@ -956,7 +978,7 @@ send_msg(int sock, struct sockaddr_storage *receiver, oc_message_t *message)
 
     msg.msg_control = msg_control;
     msg.msg_controllen = CMSG_SPACE(sizeof(struct in6_pktinfo));
-    memset(msg.msg_control, 0, msg.msg_controllen);
+    memset(msg_control, 0, sizeof(msg_control));
 
     cmsg = CMSG_FIRSTHDR(&msg);
     cmsg->cmsg_level = IPPROTO_IPV6;
@@ -972,6 +994,15 @@ send_msg(int sock, struct sockaddr_storage *receiver, oc_message_t *message)
      * from the endpoint's addr_local attribute.
      */
     memcpy(&pktinfo->ipi6_addr, message->endpoint.addr_local.ipv6.address, 16);
+
+    if (traffic_class != 0) {
+      msg.msg_controllen += CMSG_SPACE(sizeof(int));
+      cmsg = CMSG_NXTHDR(&msg, cmsg);
+      cmsg->cmsg_level = IPPROTO_IPV6;
+      cmsg->cmsg_type = IPV6_TCLASS;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+      memcpy(CMSG_DATA(cmsg), &traffic_class, sizeof(int));
+    }
   }
 #ifdef OC_IPV4
   else if (message->endpoint.flags & IPV4) {
@@ -980,7 +1011,7 @@ send_msg(int sock, struct sockaddr_storage *receiver, oc_message_t *message)
 
     msg.msg_control = msg_control;
     msg.msg_controllen = CMSG_SPACE(sizeof(struct in_pktinfo));
-    memset(msg.msg_control, 0, msg.msg_controllen);
+    memset(msg_control, 0, sizeof(msg_control));
 
     cmsg = CMSG_FIRSTHDR(&msg);
     cmsg->cmsg_level = SOL_IP;
@@ -993,6 +1024,15 @@ send_msg(int sock, struct sockaddr_storage *receiver, oc_message_t *message)
     pktinfo->ipi_ifindex = message->endpoint.interface_index;
     memcpy(&pktinfo->ipi_spec_dst, message->endpoint.addr_local.ipv4.address,
            4);
+
+    if (traffic_class != 0) {
+      msg.msg_controllen += CMSG_SPACE(sizeof(int));
+      cmsg = CMSG_NXTHDR(&msg, cmsg);
+      cmsg->cmsg_level = IPPROTO_IP;
+      cmsg->cmsg_type = IP_TOS;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+      memcpy(CMSG_DATA(cmsg), &traffic_class, sizeof(int));
+    }
   }
 #else  /* OC_IPV4 */
   else {
@@ -1392,7 +1432,7 @@ static void
 register_multicasts(oc_interface_event_t event)
 {
   if (event == NETWORK_INTERFACE_DOWN || event == NETWORK_INTERFACE_UP) {
-    oc_register_group_multicasts();
+    oc_rejoin_group_multicasts();
   }
 }
 
@@ -1611,6 +1651,10 @@ oc_connectivity_init(size_t device)
     ifchange_initialized = true;
   }
 
+  oc_network_event_handler_mutex_lock();
+  refresh_endpoints_list(dev);
+  oc_network_event_handler_mutex_unlock();
+
   if (pthread_create(&dev->event_thread, NULL, &network_event_thread, dev) !=
       0) {
     OC_ERR("creating network polling thread");
@@ -0,0 +1,192 @@
+/******************************************************************
+ *
+ * Copyright 2025 Cascoda Ltd All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <vector>
+
+extern "C" {
+#include "util/oc_etimer.h"
+}
+
+#define NUM_TIMERS (64)
+
+class TestEtimerQueue : public testing::Test {
+protected:
+  virtual void SetUp()
+  {
+    queue = NULL;
+    memset(timers, 0, sizeof(timers));
+  }
+
+  virtual void TearDown() {}
+
+  /* the timers are not started on the clock, only start + interval counts */
+  void arm(int i, oc_clock_time_t start, oc_clock_time_t interval)
+  {
+    timers[i].timer.start = start;
+    timers[i].timer.interval = interval;
+    oc_etimer_queue_add(&queue, &timers[i]);
+  }
+
+  /* empties the queue, in the order of the queue */
+  std::vector<struct oc_etimer *> drain()
+  {
+    std::vector<struct oc_etimer *> order;
+    struct oc_etimer *first;
+    while ((first = oc_etimer_queue_first(&queue)) != NULL) {
+      order.push_back(first);
+      oc_etimer_queue_remove(&queue, first);
+    }
+    return order;
+  }
+
+  static oc_clock_time_t expiration(const struct oc_etimer *et)
+  {
+    return et->timer.start + et->timer.interval;
+  }
+
+  struct oc_etimer *queue;
+  struct oc_etimer timers[NUM_TIMERS];
+};
+
+TEST_F(TestEtimerQueue, ExpiryOrder_P)
+{
+  srand(1);
+  for (int i = 0; i < NUM_TIMERS; i++) {
+    arm(i, 1000, rand() % 500);
+  }
+  std::vector<struct oc_etimer *> order = drain();
+  ASSERT_EQ((size_t)NUM_TIMERS, order.size());
+  for (size_t i = 1; i < order.size(); i++) {
+    EXPECT_LE(expiration(order[i - 1]), expiration(order[i])) << i;
+  }
+  EXPECT_EQ(nullptr, oc_etimer_queue_first(&queue));
+}
+
+TEST_F(TestEtimerQueue, ExpiryOrderClockWrap_P)
+{
+  // expirations on both sides of the wrap of the clock
+  oc_clock_time_t start = (oc_clock_time_t)0 - 100;
+  arm(0, start, 150);
+  arm(1, start, 50);
+  arm(2, start, 99);
+  arm(3, start, 100);
+  std::vector<struct oc_etimer *> order = drain();
+  ASSERT_EQ(4u, order.size());
+  EXPECT_EQ(&timers[1], order[0]);
+  EXPECT_EQ(&timers[2], order[1]);
+  EXPECT_EQ(&timers[3], order[2]);
+  EXPECT_EQ(&timers[0], order[3]);
+}
+
+TEST_F(TestEtimerQueue, RemoveArmed_P)
+{
+  for (int i = 0; i < NUM_TIMERS; i++) {
+    arm(i, 0, (i * 37) % NUM_TIMERS);
+  }
+  // take the first one out, so that the heap has been restructured
+  struct oc_etimer *first = oc_etimer_queue_first(&queue);
+  EXPECT_EQ(0u, expiration(first));
+  oc_etimer_queue_remove(&queue, first);
+
+  // remove every third armed timer, the root and inner nodes included
+  std::vector<bool> removed(NUM_TIMERS, false);
+  removed[first - timers] = true;
+  for (int i = 0; i < NUM_TIMERS; i += 3) {
+    oc_etimer_queue_remove(&queue, &timers[i]);
+    removed[i] = true;
+  }
+  // removing a timer that is not in the queue does nothing
+  oc_etimer_queue_remove(&queue, &timers[0]);
+  oc_etimer_queue_remove(&queue, first);
+
+  std::vector<struct oc_etimer *> order = drain();
+  size_t expected = 0;
+  for (int i = 0; i < NUM_TIMERS; i++) {
+    expected += removed[i] ? 0 : 1;
+  }
+  ASSERT_EQ(expected, order.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    EXPECT_FALSE(removed[order[i] - timers]) << order[i] - timers;
+    if (i > 0) {
+      EXPECT_LE(expiration(order[i - 1]), expiration(order[i])) << i;
+    }
+  }
+}
+
+TEST_F(TestEtimerQueue, Rearm_P)
+{
+  for (int i = 0; i < 8; i++) {
+    arm(i, 0, 100 + 10 * i);
+  }
+  // re-arm the first timer to expire last, and the last one to expire first
+  oc_etimer_queue_remove(&queue, &timers[0]);
+  arm(0, 0, 1000);
+  oc_etimer_queue_remove(&queue, &timers[7]);
+  arm(7, 0, 10);
+  EXPECT_EQ(&timers[7], oc_etimer_queue_first(&queue));
+
+  // re-arming a timer with a later start, e.g. a restart
+  oc_etimer_queue_remove(&queue, &timers[3]);
+  arm(3, 500, 100);
+
+  std::vector<struct oc_etimer *> order = drain();
+  ASSERT_EQ(8u, order.size());
+  EXPECT_EQ(&timers[7], order[0]);
+  EXPECT_EQ(&timers[1], order[1]);
+  EXPECT_EQ(&timers[2], order[2]);
+  EXPECT_EQ(&timers[4], order[3]);
+  EXPECT_EQ(&timers[5], order[4]);
+  EXPECT_EQ(&timers[6], order[5]);
+  EXPECT_EQ(&timers[3], order[6]);
+  EXPECT_EQ(&timers[0], order[7]);
+
+  // a drained timer can be armed again
+  arm(5, 0, 1);
+  EXPECT_EQ(&timers[5], oc_etimer_queue_first(&queue));
+  oc_etimer_queue_remove(&queue, &timers[5]);
+  EXPECT_EQ(nullptr, oc_etimer_queue_first(&queue));
+}
+
+TEST_F(TestEtimerQueue, RandomOperations_P)
+{
+  std::vector<bool> armed(NUM_TIMERS, false);
+  srand(2);
+  for (int n = 0; n < 10000; n++) {
+    int i = rand() % NUM_TIMERS;
+    if (armed[i]) {
+      oc_etimer_queue_remove(&queue, &timers[i]);
+      armed[i] = false;
+    }
+    if (rand() % 2) {
+      arm(i, rand() % 1000, rand() % 1000);
+      armed[i] = true;
+    }
+    // the first timer of the queue expires first
+    struct oc_etimer *first = oc_etimer_queue_first(&queue);
+    for (int j = 0; j < NUM_TIMERS; j++) {
+      if (armed[j]) {
+        ASSERT_NE(nullptr, first);
+        ASSERT_LE(expiration(first), expiration(&timers[j]));
+      }
+    }
+  }
+}
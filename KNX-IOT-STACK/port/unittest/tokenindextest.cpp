@@ -0,0 +1,236 @@
+/******************************************************************
+ *
+ * Copyright 2025 Cascoda Ltd All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <cstdlib>
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "util/oc_list.h"
+#include "util/oc_token_index.h"
+}
+
+#define NUM_ITEMS (40)
+
+typedef struct test_item_t
+{
+  struct test_item_t *next;
+  uint16_t mid;
+  uint8_t token[8];
+  uint8_t token_len;
+} test_item_t;
+
+OC_LIST(test_items);
+OC_TOKEN_INDEX(test_index, test_item_t, NUM_ITEMS);
+
+class TestTokenIndex : public testing::Test {
+protected:
+  virtual void SetUp()
+  {
+    oc_list_init(test_items);
+    oc_token_index_clear(&test_index);
+    memset(items, 0, sizeof(items));
+  }
+
+  virtual void TearDown()
+  {
+    oc_list_init(test_items);
+    oc_token_index_clear(&test_index);
+  }
+
+  static void set_key(test_item_t *item, uint16_t mid, uint32_t token)
+  {
+    item->mid = mid;
+    item->token_len = 4;
+    memcpy(item->token, &token, sizeof(token));
+  }
+
+  void add(test_item_t *item)
+  {
+    oc_list_add(test_items, item);
+    oc_token_index_add(&test_index, item);
+  }
+
+  void remove(test_item_t *item)
+  {
+    oc_token_index_remove(&test_index, item);
+    oc_list_remove(test_items, item);
+  }
+
+  test_item_t *find_mid(uint16_t mid)
+  {
+    return (test_item_t *)oc_token_index_find_by_mid(&test_index, test_items,
+                                                     mid);
+  }
+
+  test_item_t *find_token(uint32_t token)
+  {
+    return (test_item_t *)oc_token_index_find_by_token(
+      &test_index, test_items, (const uint8_t *)&token, sizeof(token));
+  }
+
+  test_item_t items[NUM_ITEMS];
+};
+
+TEST_F(TestTokenIndex, Find_P)
+{
+  for (int i = 0; i < NUM_ITEMS; i++) {
+    set_key(&items[i], (uint16_t)(1000 + i), 0xA0000000u + i * 7919u);
+    add(&items[i]);
+  }
+  for (int i = 0; i < NUM_ITEMS; i++) {
+    EXPECT_EQ(&items[i], find_mid((uint16_t)(1000 + i))) << i;
+    EXPECT_EQ(&items[i], find_token(0xA0000000u + i * 7919u)) << i;
+  }
+}
+
+TEST_F(TestTokenIndex, Find_N)
+{
+  EXPECT_EQ(nullptr, find_mid(1));
+  EXPECT_EQ(nullptr, find_token(1));
+
+  set_key(&items[0], 1, 1);
+  add(&items[0]);
+  EXPECT_EQ(nullptr, find_mid(2));
+  EXPECT_EQ(nullptr, find_token(2));
+  // same bytes, other length
+  uint8_t token = 1;
+  EXPECT_EQ(nullptr,
+            oc_token_index_find_by_token(&test_index, test_items, &token, 1));
+}
+
+TEST_F(TestTokenIndex, DuplicateKeys_P)
+{
+  // the first item in the list wins, as with a scan of the list
+  set_key(&items[0], 5, 0x1234);
+  set_key(&items[1], 5, 0x1234);
+  add(&items[0]);
+  add(&items[1]);
+  test_item_t *head = (test_item_t *)oc_list_head(test_items);
+  EXPECT_EQ(head, find_mid(5));
+  EXPECT_EQ(head, find_token(0x1234));
+
+  remove(head);
+  test_item_t *other = (head == &items[0]) ? &items[1] : &items[0];
+  EXPECT_EQ(other, find_mid(5));
+  EXPECT_EQ(other, find_token(0x1234));
+}
+
+TEST_F(TestTokenIndex, Remove_P)
+{
+  // all items on the same home slot, removal has to keep the probe chain
+  for (int i = 0; i < NUM_ITEMS / 2; i++) {
+    set_key(&items[i], (uint16_t)(i * 1024), 0xB000u + i);
+    add(&items[i]);
+  }
+  for (int i = 0; i < NUM_ITEMS / 2; i += 2) {
+    remove(&items[i]);
+  }
+  for (int i = 0; i < NUM_ITEMS / 2; i++) {
+    test_item_t *expected = (i % 2) ? &items[i] : nullptr;
+    EXPECT_EQ(expected, find_mid((uint16_t)(i * 1024))) << i;
+    EXPECT_EQ(expected, find_token(0xB000u + i)) << i;
+  }
+}
+
+TEST_F(TestTokenIndex, KeyChange_P)
+{
+  for (int i = 0; i < 8; i++) {
+    set_key(&items[i], (uint16_t)(100 + i), 0xC000u + i);
+    add(&items[i]);
+  }
+
+  // remove, change the key and add again: found by the new key only
+  oc_token_index_remove(&test_index, &items[3]);
+  set_key(&items[3], 300, 0xD000u);
+  oc_token_index_add(&test_index, &items[3]);
+  EXPECT_EQ(&items[3], find_mid(300));
+  EXPECT_EQ(&items[3], find_token(0xD000u));
+  EXPECT_EQ(nullptr, find_mid(103));
+  EXPECT_EQ(nullptr, find_token(0xC003u));
+
+  // a key changed without re-indexing, the stale entry is still removed
+  set_key(&items[5], 500, 0xE000u);
+  remove(&items[5]);
+  EXPECT_EQ(nullptr, find_mid(105));
+  EXPECT_EQ(nullptr, find_mid(500));
+  EXPECT_EQ(nullptr, find_token(0xC005u));
+  EXPECT_EQ(nullptr, find_token(0xE000u));
+
+  // the slot of the stale entry can be used again
+  set_key(&items[8], 105, 0xC005u);
+  add(&items[8]);
+  EXPECT_EQ(&items[8], find_mid(105));
+  EXPECT_EQ(&items[8], find_token(0xC005u));
+
+  for (int i = 0; i < 8; i++) {
+    if (i != 3 && i != 5) {
+      EXPECT_EQ(&items[i], find_mid((uint16_t)(100 + i))) << i;
+      EXPECT_EQ(&items[i], find_token(0xC000u + i)) << i;
+    }
+  }
+}
+
+TEST_F(TestTokenIndex, Clear_P)
+{
+  set_key(&items[0], 7, 7);
+  add(&items[0]);
+  oc_list_init(test_items);
+  oc_token_index_clear(&test_index);
+  EXPECT_EQ(nullptr, find_mid(7));
+  EXPECT_EQ(nullptr, find_token(7));
+
+  add(&items[0]);
+  EXPECT_EQ(&items[0], find_mid(7));
+  EXPECT_EQ(&items[0], find_token(7));
+}
+
+TEST_F(TestTokenIndex, RandomOperations_P)
+{
+  bool added[NUM_ITEMS] = { false };
+  srand(3);
+  for (int n = 0; n < 5000; n++) {
+    int i = rand() % NUM_ITEMS;
+    if (added[i]) {
+      remove(&items[i]);
+      added[i] = false;
+    } else {
+      set_key(&items[i], (uint16_t)(rand() % 64), (uint32_t)(rand() % 64));
+      add(&items[i]);
+      added[i] = true;
+    }
+    // the index answers the same as a scan of the list
+    for (int k = 0; k < 64; k++) {
+      test_item_t *by_mid = NULL, *by_token = NULL;
+      for (test_item_t *item = (test_item_t *)oc_list_head(test_items);
+           item != NULL; item = item->next) {
+        uint32_t token;
+        memcpy(&token, item->token, sizeof(token));
+        if (by_mid == NULL && item->mid == k) {
+          by_mid = item;
+        }
+        if (by_token == NULL && token == (uint32_t)k) {
+          by_token = item;
+        }
+      }
+      ASSERT_EQ(by_mid, find_mid((uint16_t)k)) << n << " " << k;
+      ASSERT_EQ(by_token, find_token((uint32_t)k)) << n << " " << k;
+    }
+  }
+}
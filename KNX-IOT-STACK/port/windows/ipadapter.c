@@ -487,6 +487,10 @@ refresh_endpoints_list(ip_context_t *dev, ifaddr_t *ifaddr_list)
   if (!ifaddr_supplied) {
     free_network_addresses(ifaddr_list);
   }
+  if (dev->device == 0) {
+    // used to filter the messages sent by this device
+    oc_endpoint_local_set_list(oc_list_head(dev->eps));
+  }
 }
 
 static int
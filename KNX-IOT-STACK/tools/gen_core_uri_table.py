@@ -0,0 +1,212 @@
+#!/usr/bin/env python3
+
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Generates api/oc_core_uri_table.h, the perfect hash table from uri to the
+# const core resources of device 0.
+#
+# The core resources are found by scanning api/*.c for
+# OC_CORE_CREATE_CONST_RESOURCE_LINKED / OC_CORE_CREATE_CONST_RESOURCE_FINAL.
+# Resources declared inside #if blocks keep their condition in the table.
+# The hash must be the same as oc_uri_hash in api/oc_ri.c.
+#
+#   # from project root directory run
+#   python3 tools/gen_core_uri_table.py
+
+# pylint: disable=C0103
+# pylint: disable=C0114
+# pylint: disable=C0116
+# pylint: disable=C0209
+# pylint: disable=W1514
+
+import argparse
+import glob
+import os
+import re
+import sys
+
+TABLE_SLOTS = 256
+MAX_SEED = 1 << 24
+
+DECL_RE = re.compile(
+    r'^\s*OC_CORE_CREATE_CONST_RESOURCE_(LINKED|FINAL)\(\s*(\w+)\s*,')
+URI_RE = re.compile(r'"(/[^"]*)"')
+
+
+def fnv_hash(path, seed):
+    h = seed
+    for c in path.encode():
+        h = ((h ^ c) * 16777619) & 0xffffffff
+    # mix the bits, the low bits of FNV-1a depend on the low bits only
+    h ^= h >> 16
+    h = (h * 0x85ebca6b) & 0xffffffff
+    h ^= h >> 13
+    h = (h * 0xc2b2ae35) & 0xffffffff
+    return h ^ (h >> 16)
+
+
+def strip_comment(line):
+    return line.split('//')[0].split('/*')[0].strip()
+
+
+def parse_file(file_name, resources):
+    with open(file_name) as f:
+        lines = f.readlines()
+    conditions = []
+    i = 0
+    while i < len(lines):
+        line = lines[i]
+        directive = strip_comment(line)
+        if directive.startswith('#'):
+            words = directive[1:].split(None, 1)
+            keyword = words[0] if words else ''
+            arg = words[1].strip() if len(words) > 1 else ''
+            if keyword == 'ifdef':
+                conditions.append('defined(%s)' % arg)
+            elif keyword == 'ifndef':
+                conditions.append('!defined(%s)' % arg)
+            elif keyword == 'if':
+                conditions.append('(%s)' % arg)
+            elif keyword == 'elif':
+                conditions[-1] = '!(%s) && (%s)' % (conditions[-1], arg)
+            elif keyword == 'else':
+                conditions[-1] = '!(%s)' % conditions[-1]
+            elif keyword == 'endif':
+                conditions.pop()
+        match = DECL_RE.match(line)
+        if match:
+            # the uri is the first string of the declaration
+            text = line
+            uri = URI_RE.search(text)
+            while uri is None and i + 1 < len(lines):
+                i += 1
+                text += lines[i]
+                uri = URI_RE.search(text)
+            name = match.group(2)
+            condition = ' && '.join(conditions)
+            resources.setdefault(name, (uri.group(1), set()))
+            resources[name][1].add(condition)
+        i += 1
+
+
+def simplify(conditions):
+    """returns the condition of a resource declared under several conditions,
+    or '' if the resource is always declared"""
+    if '' in conditions:
+        return ''
+    for c in conditions:
+        if '!(%s)' % c in conditions:
+            return ''
+    if len(conditions) == 1:
+        return next(iter(conditions))
+    return ' || '.join('(%s)' % c for c in sorted(conditions))
+
+
+def find_seed(paths):
+    for seed in range(MAX_SEED):
+        slots = set()
+        for path in paths:
+            slot = fnv_hash(path, seed) % TABLE_SLOTS
+            if slot in slots:
+                break
+            slots.add(slot)
+        else:
+            return seed
+    return None
+
+
+def write_conditional(out, condition, text, alternative=None):
+    if condition:
+        out.append('#if %s' % condition)
+    out.append(text)
+    if condition:
+        if alternative is not None:
+            out.append('#else')
+            out.append(alternative)
+        out.append('#endif')
+
+
+def generate(root):
+    resources = {}
+    for file_name in sorted(glob.glob(os.path.join(root, 'api', '*.c'))):
+        parse_file(file_name, resources)
+
+    entries = []
+    for name, (uri, conditions) in sorted(resources.items(),
+                                          key=lambda r: r[1][0]):
+        entries.append((name, uri[1:], simplify(conditions)))
+    if len(entries) >= TABLE_SLOTS:
+        sys.exit('too many core resources: %d' % len(entries))
+
+    seed = find_seed([path for _, path, _ in entries])
+    if seed is None:
+        sys.exit('no perfect hash found')
+
+    slots = [0] * TABLE_SLOTS
+    for index, (_, path, _) in enumerate(entries):
+        slots[fnv_hash(path, seed) % TABLE_SLOTS] = index + 1
+
+    out = []
+    out.append('/* generated by tools/gen_core_uri_table.py, do not edit */')
+    out.append('')
+    out.append('/*')
+    out.append(' * perfect hash table from uri to the const core resources of'
+               ' device 0.')
+    out.append(' * only to be included by api/oc_ri.c')
+    out.append(' */')
+    out.append('')
+    out.append('#ifndef OC_CORE_URI_TABLE_H')
+    out.append('#define OC_CORE_URI_TABLE_H')
+    out.append('')
+    out.append('#define OC_CORE_URI_TABLE_SEED (%du)' % seed)
+    out.append('#define OC_CORE_URI_TABLE_SLOTS (%d)' % TABLE_SLOTS)
+    out.append('')
+    for name, _, condition in entries:
+        write_conditional(out, condition,
+                          'OC_CORE_EXTERN_CONST_RESOURCE(%s)' % name)
+    out.append('')
+    out.append('/* the core resources, NULL if not compiled in */')
+    out.append('static const oc_resource_t *const oc_core_uri_table[] = {')
+    for name, path, condition in entries:
+        write_conditional(out, condition,
+                          '  &OC_CORE_RESOURCE_NAME(%s), // /%s' %
+                          (name, path), '  NULL,')
+    out.append('};')
+    out.append('')
+    out.append('/* index + 1 in oc_core_uri_table, 0 is an empty slot */')
+    out.append('static const uint8_t oc_core_uri_table_slots['
+               'OC_CORE_URI_TABLE_SLOTS] = {')
+    for row in range(0, TABLE_SLOTS, 16):
+        out.append('  ' + ' '.join('%d,' % s for s in slots[row:row + 16]))
+    out.append('};')
+    out.append('')
+    out.append('#endif /* OC_CORE_URI_TABLE_H */')
+    return '\n'.join(out) + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='generate the uri table of the const core resources')
+    parser.add_argument('--root', default='.',
+                        help='root directory of the stack')
+    parser.add_argument('--output', default=None,
+                        help='output file, default api/oc_core_uri_table.h')
+    args = parser.parse_args()
+    output = args.output or os.path.join(args.root, 'api',
+                                         'oc_core_uri_table.h')
+    with open(output, 'w') as f:
+        f.write(generate(args.root))
+
+
+if __name__ == '__main__':
+    main()
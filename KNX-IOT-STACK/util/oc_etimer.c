@@ -37,37 +37,122 @@
 #include "oc_etimer.h"
 #include "oc_process.h"
 
+/* The pending timers are kept in a pairing heap ordered on expiration time:
+   adding a timer is O(1), the next expiration is the root of the heap and
+   removing a timer is O(log n) amortized. */
 static struct oc_etimer *timerlist;
-static oc_clock_time_t next_expiration;
 
 OC_PROCESS(oc_etimer_process, "Event timer");
 /*---------------------------------------------------------------------------*/
-static void
-update_time(void)
+static oc_clock_time_t
+expiration(const struct oc_etimer *t)
+{
+  return t->timer.start + t->timer.interval;
+}
+/*---------------------------------------------------------------------------*/
+static int
+expires_before(const struct oc_etimer *a, const struct oc_etimer *b)
+{
+  /* the difference is "negative" when a expires first, also across wraps */
+  oc_clock_time_t diff = expiration(a) - expiration(b);
+  return diff > ((oc_clock_time_t)~(oc_clock_time_t)0 >> 1);
+}
+/*---------------------------------------------------------------------------*/
+static struct oc_etimer *
+heap_meld(struct oc_etimer *a, struct oc_etimer *b)
 {
-  oc_clock_time_t tdist;
-  oc_clock_time_t now;
   struct oc_etimer *t;
 
-  if (timerlist == NULL) {
-    next_expiration = 0;
+  if (a == NULL) {
+    return b;
+  }
+  if (b == NULL) {
+    return a;
+  }
+  if (expires_before(b, a)) {
+    t = a;
+    a = b;
+    b = t;
+  }
+  /* b becomes the first child of a */
+  b->prev = a;
+  b->next = a->child;
+  if (a->child != NULL) {
+    a->child->prev = b;
+  }
+  a->child = b;
+  a->next = NULL;
+  a->prev = NULL;
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+static struct oc_etimer *
+heap_merge_pairs(struct oc_etimer *first)
+{
+  struct oc_etimer *pairs = NULL, *a, *b, *t;
+
+  /* meld the siblings in pairs from left to right ... */
+  while (first != NULL) {
+    a = first;
+    b = a->next;
+    first = (b != NULL) ? b->next : NULL;
+    a->next = a->prev = NULL;
+    if (b != NULL) {
+      b->next = b->prev = NULL;
+    }
+    t = heap_meld(a, b);
+    t->next = pairs;
+    pairs = t;
+  }
+  /* ... and the pairs from right to left */
+  first = NULL;
+  while (pairs != NULL) {
+    t = pairs;
+    pairs = pairs->next;
+    t->next = NULL;
+    first = heap_meld(first, t);
+  }
+  return first;
+}
+/*---------------------------------------------------------------------------*/
+static int
+heap_contains(struct oc_etimer *const *heap, const struct oc_etimer *t)
+{
+  return t == *heap || t->prev != NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_add(struct oc_etimer **heap, struct oc_etimer *t)
+{
+  t->next = t->prev = t->child = NULL;
+  *heap = heap_meld(*heap, t);
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_remove(struct oc_etimer **heap, struct oc_etimer *t)
+{
+  struct oc_etimer *children = heap_merge_pairs(t->child);
+
+  if (t == *heap) {
+    *heap = children;
   } else {
-    now = oc_clock_time();
-    t = timerlist;
-    /* Must calculate distance to next time into account due to wraps */
-    tdist = t->timer.start + t->timer.interval - now;
-    for (t = t->next; t != NULL; t = t->next) {
-      if (t->timer.start + t->timer.interval - now < tdist) {
-        tdist = t->timer.start + t->timer.interval - now;
-      }
+    /* cut t out of the list of siblings */
+    if (t->prev->child == t) {
+      t->prev->child = t->next;
+    } else {
+      t->prev->next = t->next;
     }
-    next_expiration = now + tdist;
+    if (t->next != NULL) {
+      t->next->prev = t->prev;
+    }
+    *heap = heap_meld(*heap, children);
   }
+  t->next = t->prev = t->child = NULL;
 }
 /*---------------------------------------------------------------------------*/
 OC_PROCESS_THREAD(oc_etimer_process, ev, data)
 {
-  struct oc_etimer *t, *u;
+  struct oc_etimer *t, *removed;
 
   OC_PROCESS_BEGIN();
 
@@ -79,17 +164,20 @@ OC_PROCESS_THREAD(oc_etimer_process, ev, data)
     if (ev == OC_PROCESS_EVENT_EXITED) {
       struct oc_process *p = data;
 
-      while (timerlist != NULL && timerlist->p == p) {
-        timerlist = timerlist->next;
-      }
-
-      if (timerlist != NULL) {
+      /* take all timers out of the heap, put the others back */
+      removed = NULL;
+      while (timerlist != NULL) {
         t = timerlist;
-        while (t->next != NULL) {
-          if (t->next->p == p) {
-            t->next = t->next->next;
-          } else
-            t = t->next;
+        heap_remove(&timerlist, t);
+        t->next = removed;
+        removed = t;
+      }
+      while (removed != NULL) {
+        t = removed;
+        removed = removed->next;
+        t->next = NULL;
+        if (t->p != p) {
+          heap_add(&timerlist, t);
         }
       }
       continue;
@@ -97,32 +185,21 @@ OC_PROCESS_THREAD(oc_etimer_process, ev, data)
       continue;
     }
 
-  again:
-
-    u = NULL;
-
-    for (t = timerlist; t != NULL; t = t->next) {
-      if (oc_timer_expired(&t->timer)) {
-        if (oc_process_post(t->p, OC_PROCESS_EVENT_TIMER, t) ==
-            OC_PROCESS_ERR_OK) {
+    /* only the root can be the first timer to expire */
+    while (timerlist != NULL && oc_timer_expired(&timerlist->timer)) {
+      t = timerlist;
+      if (oc_process_post(t->p, OC_PROCESS_EVENT_TIMER, t) ==
+          OC_PROCESS_ERR_OK) {
 
-          /* Reset the process ID of the event timer, to signal that the
-             etimer has expired. This is later checked in the
-             oc_etimer_expired() function. */
-          t->p = OC_PROCESS_NONE;
-          if (u != NULL) {
-            u->next = t->next;
-          } else {
-            timerlist = t->next;
-          }
-          t->next = NULL;
-          update_time();
-          goto again;
-        } else {
-          oc_etimer_request_poll();
-        }
+        /* Reset the process ID of the event timer, to signal that the
+           etimer has expired. This is later checked in the
+           oc_etimer_expired() function. */
+        heap_remove(&timerlist, t);
+        t->p = OC_PROCESS_NONE;
+      } else {
+        oc_etimer_request_poll();
+        break;
       }
-      u = t;
     }
   }
 
@@ -139,27 +216,15 @@ oc_etimer_request_poll(void)
 static void
 add_timer(struct oc_etimer *timer)
 {
-  struct oc_etimer *t;
-
   oc_etimer_request_poll();
 
-  if (timer->p != OC_PROCESS_NONE) {
-    for (t = timerlist; t != NULL; t = t->next) {
-      if (t == timer) {
-        /* Timer already on list, bail out. */
-        timer->p = OC_PROCESS_CURRENT();
-        update_time();
-        return;
-      }
-    }
+  /* the expiration time has changed, the timer moves in the heap */
+  if (timer->p != OC_PROCESS_NONE && heap_contains(&timerlist, timer)) {
+    heap_remove(&timerlist, timer);
   }
 
-  /* Timer not on list. */
   timer->p = OC_PROCESS_CURRENT();
-  timer->next = timerlist;
-  timerlist = timer;
-
-  update_time();
+  heap_add(&timerlist, timer);
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -195,8 +260,15 @@ oc_etimer_restart(struct oc_etimer *et)
 void
 oc_etimer_adjust(struct oc_etimer *et, int timediff)
 {
+  int pending = et->p != OC_PROCESS_NONE && heap_contains(&timerlist, et);
+
+  if (pending) {
+    heap_remove(&timerlist, et);
+  }
   et->timer.start += timediff;
-  update_time();
+  if (pending) {
+    heap_add(&timerlist, et);
+  }
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -226,38 +298,39 @@ oc_etimer_pending(void)
 oc_clock_time_t
 oc_etimer_next_expiration_time(void)
 {
-  return oc_etimer_pending() ? next_expiration : 0;
+  return oc_etimer_pending() ? expiration(timerlist) : 0;
 }
 /*---------------------------------------------------------------------------*/
 void
 oc_etimer_stop(struct oc_etimer *et)
 {
-  struct oc_etimer *t;
-
-  /* First check if et is the first event timer on the list. */
-  if (et == timerlist) {
-    timerlist = timerlist->next;
-    update_time();
-  } else {
-    /* Else walk through the list and try to find the item before the
-       et timer. */
-    for (t = timerlist; t != NULL && t->next != et; t = t->next)
-      ;
-
-    if (t != NULL) {
-      /* We've found the item before the event timer that we are about
-   to remove. We point the items next pointer to the event after
-   the removed item. */
-      t->next = et->next;
-
-      update_time();
-    }
+  if (et->p != OC_PROCESS_NONE && heap_contains(&timerlist, et)) {
+    heap_remove(&timerlist, et);
   }
 
-  /* Remove the next pointer from the item to be removed. */
-  et->next = NULL;
   /* Set the timer as expired */
   et->p = OC_PROCESS_NONE;
 }
 /*---------------------------------------------------------------------------*/
+void
+oc_etimer_queue_add(struct oc_etimer **queue, struct oc_etimer *et)
+{
+  et->p = OC_PROCESS_NONE;
+  heap_add(queue, et);
+}
+/*---------------------------------------------------------------------------*/
+void
+oc_etimer_queue_remove(struct oc_etimer **queue, struct oc_etimer *et)
+{
+  if (heap_contains(queue, et)) {
+    heap_remove(queue, et);
+  }
+}
+/*---------------------------------------------------------------------------*/
+struct oc_etimer *
+oc_etimer_queue_first(struct oc_etimer **queue)
+{
+  return *queue;
+}
+/*---------------------------------------------------------------------------*/
 /** @} */
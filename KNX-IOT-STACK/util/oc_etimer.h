@@ -72,7 +72,9 @@ extern "C" {
 struct oc_etimer
 {
   struct oc_timer timer;
-  struct oc_etimer *next;
+  struct oc_etimer *next;  /* next sibling in the timer heap */
+  struct oc_etimer *prev;  /* parent or previous sibling in the timer heap */
+  struct oc_etimer *child; /* first child in the timer heap */
   struct oc_process *p;
 };
 
@@ -207,6 +209,42 @@ void oc_etimer_stop(struct oc_etimer *et);
 
 /** @} */
 
+/**
+ * \name Timer queues
+ *
+ *             A timer queue orders event timers on their expiration
+ *             time, without the etimer process. The owner of the queue
+ *             takes the expired timers from the front of the queue,
+ *             e.g. when an event timer set to the first expiration
+ *             time expires.
+ * @{
+ */
+
+/**
+ * \brief      Add a timer to a timer queue.
+ * \param queue A pointer to the first timer of the queue.
+ * \param et   A pointer to the event timer, set with oc_timer_set().
+ */
+void oc_etimer_queue_add(struct oc_etimer **queue, struct oc_etimer *et);
+
+/**
+ * \brief      Remove a timer from a timer queue.
+ * \param queue A pointer to the first timer of the queue.
+ * \param et   A pointer to the event timer.
+ *
+ *             Nothing is done when the timer is not in the queue.
+ */
+void oc_etimer_queue_remove(struct oc_etimer **queue, struct oc_etimer *et);
+
+/**
+ * \brief      Get the timer of a timer queue that expires first.
+ * \param queue A pointer to the first timer of the queue.
+ * \return     The timer or NULL if the queue is empty.
+ */
+struct oc_etimer *oc_etimer_queue_first(struct oc_etimer **queue);
+
+/** @} */
+
 /**
  * \name Functions called from timer interrupts, by the system
  * @{
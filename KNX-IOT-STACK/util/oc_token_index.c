@@ -0,0 +1,305 @@
+/*
+ // Copyright (c) 2025 Cascoda Ltd
+ //
+ // Licensed under the Apache License, Version 2.0 (the "License");
+ // you may not use this file except in compliance with the License.
+ // You may obtain a copy of the License at
+ //
+ //      http://www.apache.org/licenses/LICENSE-2.0
+ //
+ // Unless required by applicable law or agreed to in writing, software
+ // distributed under the License is distributed on an "AS IS" BASIS,
+ // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ // See the License for the specific language governing permissions and
+ // limitations under the License.
+ */
+
+#include "oc_token_index.h"
+#include "port/oc_log.h"
+#include <string.h>
+
+#ifdef OC_DYNAMIC_ALLOCATION
+#include <stdlib.h>
+
+#define OC_TOKEN_INDEX_INITIAL_SIZE (16)
+#endif /* OC_DYNAMIC_ALLOCATION */
+
+static uint16_t
+item_mid(const oc_token_index_t *index, const void *item)
+{
+  return *(const uint16_t *)((const char *)item + index->mid_offset);
+}
+
+static const uint8_t *
+item_token(const oc_token_index_t *index, const void *item)
+{
+  return (const uint8_t *)item + index->token_offset;
+}
+
+static uint8_t
+item_token_len(const oc_token_index_t *index, const void *item)
+{
+  return *((const uint8_t *)item + index->token_len_offset);
+}
+
+static size_t
+mid_home(const oc_token_index_t *index, uint16_t mid)
+{
+  /* message ids are handed out in sequence, they spread on their own */
+  return mid % index->size;
+}
+
+static size_t
+token_home(const oc_token_index_t *index, const uint8_t *token,
+           uint8_t token_len)
+{
+  /* FNV-1a */
+  uint32_t hash = 2166136261u;
+  for (uint8_t i = 0; i < token_len; i++) {
+    hash = (hash ^ token[i]) * 16777619u;
+  }
+  return hash % index->size;
+}
+
+static size_t
+item_home(const oc_token_index_t *index, const void *item, bool by_token)
+{
+  if (by_token) {
+    return token_home(index, item_token(index, item),
+                      item_token_len(index, item));
+  }
+  return mid_home(index, item_mid(index, item));
+}
+
+static bool
+item_matches(const oc_token_index_t *index, const void *item, bool by_token,
+             uint16_t mid, const uint8_t *token, uint8_t token_len)
+{
+  if (by_token) {
+    return item_token_len(index, item) == token_len &&
+           memcmp(item_token(index, item), token, token_len) == 0;
+  }
+  return item_mid(index, item) == mid;
+}
+
+static bool
+table_insert(const oc_token_index_t *index, void **slots, void *item,
+             bool by_token)
+{
+  size_t i = item_home(index, item, by_token);
+  for (size_t n = 0; n < index->size; n++) {
+    if (slots[i] == NULL) {
+      slots[i] = item;
+      return true;
+    }
+    i = (i + 1) % index->size;
+  }
+  return false;
+}
+
+static size_t
+table_lookup(const oc_token_index_t *index, void **slots, const void *item,
+             bool by_token)
+{
+  size_t i = item_home(index, item, by_token);
+  for (size_t n = 0; n < index->size && slots[i] != NULL; n++) {
+    if (slots[i] == item) {
+      return i;
+    }
+    i = (i + 1) % index->size;
+  }
+  /* the key was changed behind our back, look for the pointer itself */
+  for (i = 0; i < index->size; i++) {
+    if (slots[i] == item) {
+      OC_WRN("oc_token_index: key of an indexed item changed");
+      return i;
+    }
+  }
+  return index->size;
+}
+
+static void
+table_remove(const oc_token_index_t *index, void **slots, const void *item,
+             bool by_token)
+{
+  size_t i = table_lookup(index, slots, item, by_token);
+  if (i == index->size) {
+    return;
+  }
+
+  /* shift the following entries back, so that no probe sequence is broken */
+  size_t j = i;
+  for (;;) {
+    j = (j + 1) % index->size;
+    if (slots[j] == NULL) {
+      break;
+    }
+    size_t home = item_home(index, slots[j], by_token);
+    bool reachable =
+      (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+    if (!reachable) {
+      slots[i] = slots[j];
+      i = j;
+    }
+  }
+  slots[i] = NULL;
+}
+
+#ifdef OC_DYNAMIC_ALLOCATION
+static bool
+token_index_grow(oc_token_index_t *index)
+{
+  size_t new_size =
+    (index->size == 0) ? OC_TOKEN_INDEX_INITIAL_SIZE : 2 * index->size;
+  void **mid_slots = (void **)calloc(new_size, sizeof(void *));
+  void **token_slots = (void **)calloc(new_size, sizeof(void *));
+  if (mid_slots == NULL || token_slots == NULL) {
+    OC_ERR("oc_token_index_grow: out of memory");
+    free(mid_slots);
+    free(token_slots);
+    return false;
+  }
+
+  void **old_slots = index->mid_slots;
+  size_t old_size = index->size;
+  free(index->token_slots);
+  index->mid_slots = mid_slots;
+  index->token_slots = token_slots;
+  index->size = new_size;
+  for (size_t i = 0; i < old_size; i++) {
+    if (old_slots[i] != NULL) {
+      /* twice the slots, the inserts can not fail */
+      (void)table_insert(index, index->mid_slots, old_slots[i], false);
+      (void)table_insert(index, index->token_slots, old_slots[i], true);
+    }
+  }
+  free(old_slots);
+  return true;
+}
+#else  /* OC_DYNAMIC_ALLOCATION */
+static bool
+token_index_grow(oc_token_index_t *index)
+{
+  (void)index;
+  return false;
+}
+#endif /* !OC_DYNAMIC_ALLOCATION */
+
+void
+oc_token_index_add(oc_token_index_t *index, void *item)
+{
+  index->count++;
+  if (!index->complete) {
+    return;
+  }
+  /* keep the tables at most half full */
+  if (2 * index->count > index->size && !token_index_grow(index)) {
+    OC_WRN("oc_token_index_add: index full, using the list");
+    index->complete = false;
+    return;
+  }
+  if (!table_insert(index, index->mid_slots, item, false)) {
+    OC_WRN("oc_token_index_add: no free slot, using the list");
+    index->complete = false;
+    return;
+  }
+  if (!table_insert(index, index->token_slots, item, true)) {
+    OC_WRN("oc_token_index_add: no free slot, using the list");
+    table_remove(index, index->mid_slots, item, false);
+    index->complete = false;
+  }
+}
+
+void
+oc_token_index_remove(oc_token_index_t *index, void *item)
+{
+  if (index->count == 0) {
+    return;
+  }
+  index->count--;
+  if (index->size > 0) {
+    table_remove(index, index->mid_slots, item, false);
+    table_remove(index, index->token_slots, item, true);
+  }
+  if (index->count == 0 && !index->complete) {
+    /* nothing is left in the list, start over with empty tables */
+    if (index->size > 0) {
+      memset(index->mid_slots, 0, index->size * sizeof(void *));
+      memset(index->token_slots, 0, index->size * sizeof(void *));
+    }
+    index->complete = true;
+  }
+}
+
+void
+oc_token_index_clear(oc_token_index_t *index)
+{
+#ifdef OC_DYNAMIC_ALLOCATION
+  free(index->mid_slots);
+  free(index->token_slots);
+  index->mid_slots = NULL;
+  index->token_slots = NULL;
+  index->size = 0;
+#else  /* OC_DYNAMIC_ALLOCATION */
+  memset(index->mid_slots, 0, index->size * sizeof(void *));
+  memset(index->token_slots, 0, index->size * sizeof(void *));
+#endif /* !OC_DYNAMIC_ALLOCATION */
+  index->count = 0;
+  index->complete = true;
+}
+
+static void *
+token_index_find_in_list(const oc_token_index_t *index, oc_list_t list,
+                         bool by_token, uint16_t mid, const uint8_t *token,
+                         uint8_t token_len)
+{
+  void *item = oc_list_head(list);
+  while (item != NULL) {
+    if (item_matches(index, item, by_token, mid, token, token_len)) {
+      return item;
+    }
+    item = oc_list_item_next(item);
+  }
+  return NULL;
+}
+
+static void *
+token_index_find(const oc_token_index_t *index, oc_list_t list, bool by_token,
+                 uint16_t mid, const uint8_t *token, uint8_t token_len)
+{
+  if (!index->complete || index->size == 0) {
+    return token_index_find_in_list(index, list, by_token, mid, token,
+                                    token_len);
+  }
+
+  void **slots = by_token ? index->token_slots : index->mid_slots;
+  size_t i = by_token ? token_home(index, token, token_len)
+                      : mid_home(index, mid);
+  void *found = NULL;
+  for (size_t n = 0; n < index->size && slots[i] != NULL; n++) {
+    if (item_matches(index, slots[i], by_token, mid, token, token_len)) {
+      if (found != NULL) {
+        /* the same key more than once, the first one in the list wins */
+        return token_index_find_in_list(index, list, by_token, mid, token,
+                                        token_len);
+      }
+      found = slots[i];
+    }
+    i = (i + 1) % index->size;
+  }
+  return found;
+}
+
+void *
+oc_token_index_find_by_mid(const oc_token_index_t *index, oc_list_t list,
+                           uint16_t mid)
+{
+  return token_index_find(index, list, false, mid, NULL, 0);
+}
+
+void *
+oc_token_index_find_by_token(const oc_token_index_t *index, oc_list_t list,
+                             const uint8_t *token, uint8_t token_len)
+{
+  return token_index_find(index, list, true, 0, token, token_len);
+}
@@ -0,0 +1,150 @@
+/*
+ // Copyright (c) 2025 Cascoda Ltd
+ //
+ // Licensed under the Apache License, Version 2.0 (the "License");
+ // you may not use this file except in compliance with the License.
+ // You may obtain a copy of the License at
+ //
+ //      http://www.apache.org/licenses/LICENSE-2.0
+ //
+ // Unless required by applicable law or agreed to in writing, software
+ // distributed under the License is distributed on an "AS IS" BASIS,
+ // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ // See the License for the specific language governing permissions and
+ // limitations under the License.
+ */
+/**
+  @brief index of list items by CoAP message id and token
+  @file
+
+  Open addressing hash tables next to an oc_list of structures that have the
+  members "mid", "token" and "token_len" (e.g. client callbacks and
+  transactions). The index answers the same as a scan of the list: when
+  several items have the same key the first one in the list is returned.
+
+  The key of an item may not change while the item is in the index, remove
+  the item, change the key and add it again (the owners of the lists have
+  setters for that). A stale entry is still found by its pointer on removal,
+  but the item can not be found by its new key.
+
+  Without dynamic allocation the tables have a fixed size, when the items do
+  not fit the lookups fall back to walking the list until the index is empty
+  again.
+*/
+#ifndef OC_TOKEN_INDEX_H
+#define OC_TOKEN_INDEX_H
+
+#include "oc_config.h"
+#include "util/oc_list.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief the index of a list by message id and token
+ */
+typedef struct oc_token_index_t
+{
+  void **mid_slots;                /**< items by message id */
+  void **token_slots;              /**< items by token */
+  size_t size;                     /**< number of slots of each table */
+  size_t count;                    /**< number of items added */
+  unsigned short mid_offset;       /**< offset of the uint16_t mid */
+  unsigned short token_offset;     /**< offset of the uint8_t token[] */
+  unsigned short token_len_offset; /**< offset of the uint8_t token_len */
+  bool complete;                   /**< all items are in the tables */
+} oc_token_index_t;
+
+#define OC_TOKEN_INDEX_CONCAT2(s1, s2) s1##s2
+#define OC_TOKEN_INDEX_CONCAT(s1, s2) OC_TOKEN_INDEX_CONCAT2(s1, s2)
+
+/**
+ * Declare an index for a list of \c structure.
+ *
+ * \param name The name of the index.
+ * \param structure The type of the items in the list.
+ * \param num The maximum number of items, the tables get twice as many
+ * slots. With dynamic allocation the tables grow with the number of items.
+ */
+#ifdef OC_DYNAMIC_ALLOCATION
+#define OC_TOKEN_INDEX(name, structure, num)                                   \
+  static oc_token_index_t name = { NULL,                                       \
+                                   NULL,                                       \
+                                   0,                                          \
+                                   0,                                          \
+                                   offsetof(structure, mid),                   \
+                                   offsetof(structure, token),                 \
+                                   offsetof(structure, token_len),             \
+                                   true }
+#else /* OC_DYNAMIC_ALLOCATION */
+#define OC_TOKEN_INDEX(name, structure, num)                                   \
+  static void *OC_TOKEN_INDEX_CONCAT(name, _mid_slots)[2 * (num)];             \
+  static void *OC_TOKEN_INDEX_CONCAT(name, _token_slots)[2 * (num)];           \
+  static oc_token_index_t name = { OC_TOKEN_INDEX_CONCAT(name, _mid_slots),    \
+                                   OC_TOKEN_INDEX_CONCAT(name, _token_slots),  \
+                                   2 * (num),                                  \
+                                   0,                                          \
+                                   offsetof(structure, mid),                   \
+                                   offsetof(structure, token),                 \
+                                   offsetof(structure, token_len),             \
+                                   true }
+#endif /* !OC_DYNAMIC_ALLOCATION */
+
+/**
+ * @brief add an item to the index, after it has been added to the list
+ *
+ * @param index the index
+ * @param item the item
+ */
+void oc_token_index_add(oc_token_index_t *index, void *item);
+
+/**
+ * @brief remove an item from the index, with its key as it was added
+ *
+ * @param index the index
+ * @param item the item
+ */
+void oc_token_index_remove(oc_token_index_t *index, void *item);
+
+/**
+ * @brief remove all items from the index
+ *
+ * with dynamic allocation the tables are freed
+ *
+ * @param index the index
+ */
+void oc_token_index_clear(oc_token_index_t *index);
+
+/**
+ * @brief find the first item in the list with the message id
+ *
+ * @param index the index
+ * @param list the indexed list
+ * @param mid the CoAP message id
+ * @return the item or NULL
+ */
+void *oc_token_index_find_by_mid(const oc_token_index_t *index,
+                                 oc_list_t list, uint16_t mid);
+
+/**
+ * @brief find the first item in the list with the token
+ *
+ * @param index the index
+ * @param list the indexed list
+ * @param token the CoAP token
+ * @param token_len the token length
+ * @return the item or NULL
+ */
+void *oc_token_index_find_by_token(const oc_token_index_t *index,
+                                   oc_list_t list, const uint8_t *token,
+                                   uint8_t token_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OC_TOKEN_INDEX_H */
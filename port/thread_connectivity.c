@@ -23,6 +23,8 @@
 #include <openthread/cli.h>
 #include <openthread/diag.h>
 #include <openthread/error.h>
+#include <openthread/instance.h>
+#include <openthread/ip6.h>
 #include <openthread/udp.h>
 #include <openthread/tasklet.h>
 
@@ -49,6 +51,8 @@ static SemaphoreHandle_t sMainStackLock = NULL;
 static otUdpSocket mSocket;
 static OSA_MUTEX_HANDLE_DEFINE(mThreadMutexId);
 
+/* No state changed callback: refresh the local endpoints for each message */
+
 // Task handles
 static TaskHandle_t xOpenThreadTaskHandle = NULL;
 
@@ -158,6 +162,8 @@ otInstance *otGetOtInstance(void)
 
 /* KNX-IoT OpenThread integration */
 
+static void UpdateLocalEndpoints(void);
+
 void HandleUdpReceive(void *aContext, otMessage *aMessage, const otMessageInfo *aMessageInfo)
 {
     oc_message_t *message = oc_allocate_message();
@@ -174,6 +180,8 @@ void HandleUdpReceive(void *aContext, otMessage *aMessage, const otMessageInfo *
     message->endpoint.device = 0;
     message->endpoint.addr.ipv6.port = aMessageInfo->mPeerPort;
     memcpy(message->endpoint.addr.ipv6.address, aMessageInfo->mPeerAddr.mFields.m8, 16);
+    /* destination address, e.g. the multicast address of the group */
+    memcpy(message->endpoint.addr_local.ipv6.address, aMessageInfo->mSockAddr.mFields.m8, 16);
 
     PRINT("Incoming message of size %zd bytes from ", message->length);
     PRINTipaddr(message->endpoint);
@@ -182,6 +190,41 @@ void HandleUdpReceive(void *aContext, otMessage *aMessage, const otMessageInfo *
     oc_network_event(message);
 }
 
+/* Rebuild the set of local endpoints from the unicast addresses of the
+ * Thread interface, used to filter the messages sent by this device.
+ * Runs on the OpenThread task, the KNX task reads the set under the same mutex */
+static void UpdateLocalEndpoints(void)
+{
+    const otNetifAddress *addr;
+    oc_endpoint_t         ep;
+
+    memset(&ep, 0, sizeof(ep));
+    ep.flags          = IPV6;
+    ep.addr.ipv6.port = COAP_UNSECURED_PORT;
+
+    oc_network_event_handler_mutex_lock();
+    oc_endpoint_local_clear();
+    if (sInstance != NULL)
+    {
+        for (addr = otIp6GetUnicastAddresses(sInstance); addr != NULL; addr = addr->mNext)
+        {
+            memcpy(ep.addr.ipv6.address, addr->mAddress.mFields.m8, sizeof(ep.addr.ipv6.address));
+            oc_endpoint_local_add(&ep);
+        }
+    }
+    oc_network_event_handler_mutex_unlock();
+}
+
+static void HandleStateChanged(otChangedFlags aFlags, void *aContext)
+{
+    (void)aContext;
+
+    if (aFlags & (OT_CHANGED_IP6_ADDRESS_ADDED | OT_CHANGED_IP6_ADDRESS_REMOVED))
+    {
+        UpdateLocalEndpoints();
+    }
+}
+
 int oc_connectivity_init(size_t device)
 {
     otError           error = OT_ERROR_NONE;
@@ -213,6 +256,17 @@ int oc_connectivity_init(size_t device)
         {
             PRINT("Socket already open!\r\n");
         }
+
+        /* Returns OT_ERROR_ALREADY when registered by a previous init.
+         * Without the callback the local endpoints would go stale */
+        error = otSetStateChangedCallback(sInstance, HandleStateChanged, NULL);
+        if (error != OT_ERROR_NONE && error != OT_ERROR_ALREADY)
+        {
+            PRINT("otSetStateChangedCallback failed with %u\r\n", error);
+            otUdpClose(sInstance, &mSocket);
+            return -1;
+        }
+        UpdateLocalEndpoints();
     }
     else
     {
@@ -222,6 +276,21 @@ int oc_connectivity_init(size_t device)
     return 1;
 }
 
+static uint8_t
+GetMessagePriority(uint8_t priority)
+{
+    switch (priority)
+    {
+    case OC_MESSAGE_PRIORITY_LOW:
+        return OT_MESSAGE_PRIORITY_LOW;
+    case OC_MESSAGE_PRIORITY_HIGH:
+    case OC_MESSAGE_PRIORITY_SYSTEM:
+        return OT_MESSAGE_PRIORITY_HIGH;
+    default:
+        return OT_MESSAGE_PRIORITY_NORMAL;
+    }
+}
+
 int
 oc_send_buffer(oc_message_t *message)
 {
@@ -230,6 +299,8 @@ oc_send_buffer(oc_message_t *message)
     otMessageInfo     messageInfo;
     otMessageSettings messageSettings = {true, OT_MESSAGE_PRIORITY_NORMAL};
 
+    messageSettings.mPriority = GetMessagePriority(message->endpoint.priority);
+
     if(!otUdpIsOpen(sInstance, &mSocket))
     {
         return 1;
@@ -293,6 +364,10 @@ oc_endpoint_t *oc_connectivity_get_endpoints(size_t device)
 void
 oc_connectivity_shutdown(size_t device)
 {
+    otRemoveStateChangeCallback(sInstance, HandleStateChanged, NULL);
+    oc_network_event_handler_mutex_lock();
+    oc_endpoint_local_clear();
+    oc_network_event_handler_mutex_unlock();
     otUdpClose(sInstance, &mSocket);
 }
 
@@ -329,3 +404,12 @@ oc_connectivity_subscribe_mcast_ipv6(oc_endpoint_t *address)
         otIp6SubscribeMulticastAddress(sInstance, (const otIp6Address *) address->addr.ipv6.address);
     }
 }
+
+void
+oc_connectivity_unsubscribe_mcast_ipv6(oc_endpoint_t *address)
+{
+    if (sInstance != NULL)
+    {
+        otIp6UnsubscribeMulticastAddress(sInstance, (const otIp6Address *) address->addr.ipv6.address);
+    }
+}